@@ -5,6 +5,8 @@
 #ifndef GBEMU_EMULATIONSTATE_HXX
 #define GBEMU_EMULATIONSTATE_HXX
 
+#include <cstdint>
+
 /**
  * @struct EmulationState
  * @brief Represents the state of the emulation, particularly to track operations such as OAM DMA activity.
@@ -15,10 +17,15 @@
  *
  * isInOamDma is primarily used to indicate whether an OAM DMA transfer is currently in progress.
  * This state affects how components interact with memory during the emulation process.
+ *
+ * romBank is the ROM bank currently mapped at 0x4000-0x7FFF, and lowRomBank the one mapped at 0x0000-0x3FFF, which only
+ * MBC1 can switch. They are maintained by the cartridge and used by the CPU to key its cache of decoded instructions.
  */
 struct EmulationState
 {
-    bool isInOamDma;
+    bool     isInOamDma{};
+    uint16_t romBank{1};
+    uint16_t lowRomBank{0};
 };
 
 #endif  // GBEMU_EMULATIONSTATE_HXX
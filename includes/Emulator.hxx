@@ -5,13 +5,12 @@
 #ifndef GBEMU_EMULATOR_HXX
 #define GBEMU_EMULATOR_HXX
 
-#include <unordered_set>
-
 #include "QtRenderer.hxx"
-#include "hardware/Bus.hxx"
 #include "hardware/Cartridge.hxx"
-#include "hardware/EchoRAM.hxx"
 #include "hardware/Joypad.hxx"
+#include "hardware/PPU.hxx"
+#include "hardware/Scheduler.hxx"
+#include "hardware/StaticBus.hxx"
 #include "hardware/Timer.hxx"
 #include "hardware/WorkRAM.hxx"
 #include "hardware/core/SM83.hxx"
@@ -31,12 +30,13 @@ class Emulator final : public QObject
 
         void addBreakpoint(uint16_t address);
         void removeBreakpoint(uint16_t address);
+        void addWatchpoint(const SM83::Watchpoint& watchpoint);
+        void removeWatchpoint(const SM83::Watchpoint& watchpoint);
 
-        bool shouldBreak() const;
+        [[nodiscard]] const std::optional<SM83::WatchpointHit>& getWatchpointHit() const noexcept;
 
       private:
-        SM83&                        _cpu;
-        std::unordered_set<uint16_t> _breakpoints;
+        SM83& _cpu;
     };
 
     explicit Emulator(const std::optional<QString>& bootRom = std::nullopt, QObject* parent = nullptr);
@@ -51,6 +51,12 @@ class Emulator final : public QObject
     void onKeyReleased(Key key);
     void setBreakpoint(uint16_t address);
 
+    /**
+     * @brief Refresh the memory view with the pages dirtied since the last refresh. Cheap enough to be done every
+     * frame.
+     */
+    void refreshMemoryView();
+
   private slots:
     void onRender(const Graphics::Framebuffer& framebuffer);
 
@@ -58,6 +64,11 @@ class Emulator final : public QObject
     void breakpointHit();
     void frameReady(const Graphics::Framebuffer& framebuffer);
     void emulationFatalError(const QString& message);
+    /**
+     * @brief The save could not be written. It is tried again on the next frames.
+     */
+    void saveError(const QString& message);
+    void memoryViewChanged(const AddressSpaceSnapshot& snapshot);
 
   private:
     class Components
@@ -67,21 +78,26 @@ class Emulator final : public QObject
       public:
         explicit Components(IRenderer& renderer);
 
-        Bus       bus;
+        using PPUType = BasicPPU<PPU::Accuracy::CYCLE>;
+        using BusType = StaticBus<Cartridge, PPUType, Timer, SM83, Joypad, WorkRAM, FakeRAM>;
+
+        BusType   bus;
+        Scheduler scheduler;
         Cartridge cartridge;
         Timer     timer;
-        PPU       ppu;
+        PPUType   ppu;
         SM83      cpu;
         WorkRAM   workRam;
-        EchoRAM   echoRam;
         FakeRAM   fakeRam;
         Joypad    joypad;
     };
 
-    volatile bool _running{true};
-    QtRenderer*   _renderer;
-    Components    _components;
-    Debugger      _debugger;
+    QtRenderer* _renderer;
+    Components  _components;
+    Debugger    _debugger;
+
+    AddressSpaceSnapshot _memorySnapshot{};
+    bool                 _isMemorySnapshotTaken{};
 
     std::chrono::nanoseconds _frameDuration{16740000ns};
 };
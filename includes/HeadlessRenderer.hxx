@@ -0,0 +1,27 @@
+#ifndef GBEMU_HEADLESSRENDERER_HXX
+#define GBEMU_HEADLESSRENDERER_HXX
+
+#include <cstddef>
+
+#include "IRenderer.hxx"
+#include "graphics/Framebuffer.hxx"
+
+/**
+ * @brief Renderer that keeps the framebuffer in memory without presenting it. Used by the test suites, the benchmarks
+ * and batch runs, where no window is available.
+ */
+class HeadlessRenderer final : public IRenderer
+{
+  public:
+    [[nodiscard]] Line getLine(uint8_t y) noexcept override;
+    void               render() override;
+
+    [[nodiscard]] const Graphics::Framebuffer& getFramebuffer() const noexcept;
+    [[nodiscard]] std::size_t                  getFrameCount() const noexcept;
+
+  private:
+    Graphics::Framebuffer _framebuffer{};
+    std::size_t           _frameCount{};
+};
+
+#endif  // GBEMU_HEADLESSRENDERER_HXX
@@ -5,12 +5,21 @@
 #ifndef GBEMU_IRENDERER_HXX
 #define GBEMU_IRENDERER_HXX
 #include <cstdint>
+#include <span>
+
+#include "graphics/Framebuffer.hxx"
 
 struct IRenderer
 {
-    virtual ~IRenderer()                                                = default;
-    virtual void setPixel(uint8_t x, uint8_t y, uint8_t pixel) noexcept = 0;
-    virtual void render()                                               = 0;
+    using Line = std::span<Graphics::Pixel, Graphics::LINE_WIDTH>;
+
+    virtual ~IRenderer() = default;
+
+    /**
+     * @brief The renderer-owned memory of a framebuffer line, which the PPU draws into directly.
+     */
+    [[nodiscard]] virtual Line getLine(uint8_t y) noexcept = 0;
+    virtual void               render()                    = 0;
 };
 
 #endif  // GBEMU_IRENDERER_HXX
@@ -16,8 +16,8 @@ class QtRenderer final : public QObject, public IRenderer
   public:
     explicit QtRenderer(QObject* parent = nullptr);
 
-    void setPixel(uint8_t x, uint8_t y, uint8_t pixel) noexcept override;
-    void render() override;
+    [[nodiscard]] Line getLine(uint8_t y) noexcept override;
+    void               render() override;
 
   signals:
     void onRender(const Graphics::Framebuffer& framebuffer);
@@ -6,10 +6,13 @@
 #define GBEMU_FRAMEBUFFER_HXX
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 
 namespace Graphics
 {
+    static constexpr std::size_t LINE_WIDTH{160};
+
     /**
      * @brief Represents a single pixel in the framebuffer.
      *
@@ -28,7 +31,7 @@ namespace Graphics
      */
     using Pixel = uint8_t;
 
-    using Framebuffer = std::array<std::array<Pixel, 160>, 144>;
+    using Framebuffer = std::array<std::array<Pixel, LINE_WIDTH>, 144>;
 
     struct PixelType
     {
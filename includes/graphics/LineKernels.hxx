@@ -0,0 +1,74 @@
+#ifndef GBEMU_LINEKERNELS_HXX
+#define GBEMU_LINEKERNELS_HXX
+
+#include <cstddef>
+#include <cstdint>
+
+#include "graphics/Framebuffer.hxx"
+
+namespace Graphics
+{
+    /**
+     * @brief Layout of the object pixels given to LineKernels::mixLine: the color index in bits 0-1, then flags.
+     */
+    struct ObjectPixel
+    {
+        static constexpr uint8_t Color{0x03};
+        /**
+         * @brief Mapped through OBP1 rather than OBP0.
+         */
+        static constexpr uint8_t Palette{1 << 2};
+        /**
+         * @brief Background color indices 1-3 are drawn over the object.
+         */
+        static constexpr uint8_t Priority{1 << 3};
+        /**
+         * @brief An object covers the pixel. Its color index may still be 0.
+         */
+        static constexpr uint8_t Present{1 << 4};
+    };
+
+    struct Palettes
+    {
+        uint8_t BGP;
+        uint8_t OBP0;
+        uint8_t OBP1;
+    };
+
+    /**
+     * @brief The per-pixel work of drawing a line, for an instruction set.
+     *
+     * The SIMD kernels process 16 (SSE2) or 32 (AVX2) pixels at a time, and produce the same output as the scalar
+     * ones. They are picked at runtime, on the CPU features available.
+     */
+    struct LineKernels
+    {
+        enum class InstructionSet : uint8_t
+        {
+            SCALAR,
+            SSE2,
+            AVX2,
+        };
+
+        /**
+         * @brief Decode count tile rows, given as their low then high bitplane bytes, to 8 color indices each.
+         */
+        void (*decodeTileRows)(const uint8_t* bitplanes, std::size_t count, uint8_t* pixels);
+
+        /**
+         * @brief Pick the background or the object pixel of each of the LINE_WIDTH pixels of a line, and map it
+         * through its palette. Background pixels hold their color index in bits 0-1 and their PixelType in bits 2-3,
+         * as in a Pixel. Object pixels follow ObjectPixel.
+         */
+        void (*mixLine)(const uint8_t* background, const uint8_t* objects, Palettes palettes, Pixel* line);
+
+        /**
+         * @brief Throws if the instruction set is not supported by the build or by the CPU.
+         */
+        [[nodiscard]] static const LineKernels& get(InstructionSet instructionSet);
+        [[nodiscard]] static bool               isSupported(InstructionSet instructionSet) noexcept;
+        [[nodiscard]] static InstructionSet     getBestInstructionSet() noexcept;
+    };
+}  // namespace Graphics
+
+#endif  // GBEMU_LINEKERNELS_HXX
@@ -5,6 +5,8 @@
 #ifndef GBEMU_TILE_HXX
 #define GBEMU_TILE_HXX
 
+#include <array>
+#include <bit>
 #include <bitset>
 #include <cstdint>
 #include <span>
@@ -15,6 +17,39 @@ namespace Graphics
     static constexpr size_t TILE_SIZE{8};
     static constexpr size_t BYTES_PER_LINE{16};
 
+    /**
+     * @brief Color indices of the 8 pixels of a tile row, leftmost first.
+     */
+    using TileRow = std::array<uint8_t, TILE_SIZE>;
+
+    /**
+     * @brief Each bit of a bitplane byte, spread to the lowest bit of the byte of its pixel in a TileRow.
+     */
+    inline constexpr auto BITPLANE_EXPANSION{[]
+    {
+        std::array<uint64_t, 256> expansion{};
+
+        for (std::size_t bitplane{0}; bitplane < expansion.size(); ++bitplane)
+        {
+            for (std::size_t column{0}; column < TILE_SIZE; ++column)
+            {
+                const auto byte{std::endian::native == std::endian::little ? column : TILE_SIZE - 1 - column};
+
+                expansion[bitplane] |= static_cast<uint64_t>(bitplane >> (TILE_SIZE - 1 - column) & 1) << (8 * byte);
+            }
+        }
+
+        return expansion;
+    }()};
+
+    /**
+     * @brief Decode the 8 pixels of a tile row at once, from its two bitplanes.
+     */
+    inline TileRow decodeTileRow(const uint8_t low, const uint8_t high) noexcept
+    {
+        return std::bit_cast<TileRow>(BITPLANE_EXPANSION[low] | BITPLANE_EXPANSION[high] << 1);
+    }
+
     inline uint8_t getRealColorIndexFromPaletteRegister(const uint8_t color, const uint8_t paletteRegister)
     {
         return paletteRegister >> (2 * color) & 0b11;
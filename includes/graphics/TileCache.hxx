@@ -0,0 +1,51 @@
+#ifndef GBEMU_TILECACHE_HXX
+#define GBEMU_TILECACHE_HXX
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <span>
+
+#include "graphics/LineKernels.hxx"
+#include "graphics/Tile.hxx"
+
+namespace Graphics
+{
+    /**
+     * @brief The 384 tiles of VRAM, decoded to color indices, as is and X-flipped.
+     *
+     * Writes to the tile data invalidate the row they touch, which is decoded again on the next update(). Consecutive
+     * invalid rows are contiguous in VRAM, and are decoded in a single kernel call.
+     */
+    class TileCache
+    {
+      public:
+        static constexpr std::size_t TILE_COUNT{384};
+        static constexpr std::size_t TILE_DATA_SIZE{TILE_COUNT * BYTES_PER_LINE};
+
+        using TileData = std::span<const uint8_t, TILE_DATA_SIZE>;
+        using Row      = std::span<const uint8_t, TILE_SIZE>;
+
+        TileCache();
+
+        /**
+         * @brief Invalidate the tile row holding a byte of the tile data, given by its offset from 0x8000.
+         */
+        void invalidate(uint16_t offset) noexcept;
+        void update(TileData tileData, const LineKernels& kernels);
+
+        /**
+         * @brief The color indices of a tile row, leftmost first, as of the last update().
+         */
+        [[nodiscard]] Row getRow(std::size_t tile, std::size_t row, bool xFlip = false) const noexcept;
+
+      private:
+        static constexpr std::size_t ROW_COUNT{TILE_COUNT * TILE_SIZE};
+
+        std::array<uint8_t, ROW_COUNT * TILE_SIZE> _pixels{};
+        std::array<uint8_t, ROW_COUNT * TILE_SIZE> _flippedPixels{};
+        std::bitset<ROW_COUNT>                     _invalidRows{};
+    };
+}  // namespace Graphics
+
+#endif  // GBEMU_TILECACHE_HXX
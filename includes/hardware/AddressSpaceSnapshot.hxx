@@ -0,0 +1,36 @@
+#ifndef GBEMU_ADDRESSSPACESNAPSHOT_HXX
+#define GBEMU_ADDRESSSPACESNAPSHOT_HXX
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+
+/**
+ * @brief A copy of the address space as a debugger sees it: without side effects, and regardless of OAM DMA. Owned by
+ * the caller, and refreshed in place by the bus.
+ */
+struct AddressSpaceSnapshot
+{
+    enum class Mode : uint8_t
+    {
+        /**
+         * @brief Copy every page.
+         */
+        FULL,
+        /**
+         * @brief Copy only the pages written to since the previous snapshot, along with the pages whose content may
+         * change on its own (I/O registers).
+         */
+        INCREMENTAL,
+    };
+
+    static constexpr std::size_t PAGE_SIZE{0x100};
+
+    std::array<uint8_t, 0x10000> memory{};
+    /**
+     * @brief The pages copied by the last snapshot.
+     */
+    std::bitset<0x100> dirtyPages{};
+};
+
+#endif  // GBEMU_ADDRESSSPACESNAPSHOT_HXX
@@ -6,6 +6,7 @@
 #include <span>
 #include <vector>
 
+#include "AddressSpaceSnapshot.hxx"
 #include "EmulationState.hxx"
 #include "IAddressable.hxx"
 
@@ -21,13 +22,104 @@ class Bus final : public IAddressable
 
     void setPostBootRomRegisters();
 
-    [[nodiscard]] std::array<uint8_t, 0x10000> getAddressSpace() const noexcept;
-
     void attach(IAddressable& addressable);
 
+    /**
+     * @brief Fetch again the host memory backing the pages in range, after their owner has switched the memory it maps
+     * there, e.g. on a bank switch or when a cartridge is loaded.
+     */
+    void remap(AddressRange range);
+
+    /**
+     * @brief Number of accesses to addresses nothing is attached to, since the bus was created.
+     */
+    [[nodiscard]] std::size_t getOpenBusAccesses() const noexcept;
+
+    /**
+     * @brief Refresh snapshot with the current content of the address space. Host memory is copied page by page, and
+     * the rest peeked at. Incremental snapshots rely on the previous one having been taken into the same snapshot.
+     */
+    void takeSnapshot(AddressSpaceSnapshot& snapshot, AddressSpaceSnapshot::Mode mode);
+
   private:
-    const EmulationState&              _emulationState;
-    std::array<IAddressable*, 0x10000> _memoryMap{};
+    static constexpr std::size_t PAGE_COUNT{0x100};
+    static constexpr std::size_t PAGE_SIZE{0x100};
+
+    using PageHandlers = std::array<IAddressable*, PAGE_SIZE>;
+
+    /**
+     * @brief A 256-byte page of the memory map. Plain memory is accessed through the host pointers, anything else
+     * through the handler owning the page, or through the handlers of each address when the page is shared, as the
+     * I/O registers are.
+     */
+    struct Page
+    {
+        const uint8_t*                read{};
+        uint8_t*                      write{};
+        IAddressable*                 handler{};
+        std::unique_ptr<PageHandlers> handlers{};
+    };
+
+    using PageTable = std::array<Page, PAGE_COUNT>;
+
+    /**
+     * @brief Handles the addresses the CPU cannot reach: reads return 0xFF and writes are dropped.
+     */
+    class OpenBus final : public IAddressable
+    {
+      public:
+        [[nodiscard]] uint8_t          read(uint16_t address) const override;
+        [[nodiscard]] uint8_t          peek(uint16_t address) const override;
+        void                           write(uint16_t address, uint8_t value) override;
+        [[nodiscard]] AddressableRange getAddressableRange() const noexcept override;
+
+        [[nodiscard]] std::size_t getAccesses() const noexcept;
+
+      private:
+        mutable std::size_t _accesses{};
+    };
+
+    /**
+     * @brief Handles BOOTM, through which the boot ROM is unmapped.
+     */
+    class BootRomRegister final : public IAddressable
+    {
+      public:
+        explicit BootRomRegister(Bus& bus);
+
+        [[nodiscard]] uint8_t          read(uint16_t address) const override;
+        void                           write(uint16_t address, uint8_t value) override;
+        [[nodiscard]] AddressableRange getAddressableRange() const noexcept override;
+
+      private:
+        Bus& _bus;
+    };
+
+    [[nodiscard]] static PageHandlers  getPageHandlers(const Page& page);
+    static void                        setPageHandlers(Page& page, const PageHandlers& handlers);
+    [[nodiscard]] static IAddressable* getHandler(const Page& page, uint16_t address) noexcept;
+
+    void remapPage(std::size_t page);
+    void updateOamDmaPage(std::size_t page);
+
+    const EmulationState& _emulationState;
+    OpenBus               _openBus;
+    OpenBus               _lockedOut;
+    BootRomRegister       _bootRomRegister{*this};
+
+    /**
+     * @brief The page tables, indexed by whether OAM DMA is in progress. During OAM DMA, the CPU is locked out of
+     * everything but HRAM: the second table maps it alone.
+     */
+    std::array<PageTable, 2>       _tables{};
+    std::array<uint8_t, PAGE_SIZE> _discardedWrites{};
+
+    /**
+     * @brief The snapshot generation each page was last written to, or remapped in. The current generation is the
+     * number of snapshots taken.
+     */
+    std::array<uint32_t, PAGE_COUNT> _writeGenerations{};
+    uint32_t                         _generation{};
 
     /**
      * @brief Indicates whether the boot ROM is currently mapped to the memory map. Active low.
@@ -5,12 +5,35 @@
 #ifndef CARTRIDGE_H
 #define CARTRIDGE_H
 
+#include <array>
 #include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
 #include <string_view>
 #include <vector>
 
+#include "Common.hxx"
+#include "EmulationState.hxx"
 #include "IAddressable.hxx"
+#include "RealTimeClock.hxx"
+#include "RomImage.hxx"
+#include "SaveFile.hxx"
+#include "Scheduler.hxx"
 
+/**
+ * @brief A cartridge and its memory bank controller (MBC1, including multicarts, MBC2, MBC3 or MBC5).
+ *
+ * The host memory of the banks mapped at 0x0000-0x3FFF, 0x4000-0x7FFF and 0xA000-0xBFFF is looked up whenever a bank
+ * register is written, so that reads are a pointer plus an offset. The ROM itself is a RomImage, shared with the other
+ * cartridges running the same file.
+ *
+ * The RAM of battery-backed cartridges persists once a save file is attached. Writes to it then always go through
+ * write(), which tracks the changes to commit. The state of the MBC3 real-time clock is appended to the RAM in the
+ * save.
+ */
 class Cartridge final : public IAddressable
 {
   public:
@@ -46,26 +69,156 @@ class Cartridge final : public IAddressable
         HuC1_RAM_BATTERY               = 0xFF
     };
 
+    /**
+     * @brief Called with the windows whose banks have been switched, for the buses caching their host memory.
+     */
+    using RemapHandler = std::function<void(MemoryMap::AddressRange range)>;
+
+    Cartridge(EmulationState& emulationState, const Scheduler& scheduler);
+
+    /**
+     * @brief Saves the real-time clock, if any, before the save file is written one last time.
+     */
+    ~Cartridge() override;
+
+    Cartridge(const Cartridge&)            = delete;
+    Cartridge& operator=(const Cartridge&) = delete;
+
     void load(const std::filesystem::path& path);
+    void setRemapHandler(RemapHandler handler);
+
+    /**
+     * @brief Whether the RAM of the loaded cartridge is battery-backed, and worth a save file.
+     */
+    [[nodiscard]] bool hasBattery() const noexcept;
+    [[nodiscard]] bool hasRealTimeClock() const noexcept;
+
+    /**
+     * @brief Back the RAM and the real-time clock of the loaded cartridge by the save at path, restoring them if it
+     * exists. The save is detached by the next load().
+     */
+    void attachSave(const std::filesystem::path& path, SaveFile::Mode mode, RealTimeClock::Mode clockMode);
+
+    /**
+     * @brief Hand the RAM written since the last commit over to the save file, without waiting for the disk. Does
+     * nothing if no save is attached.
+     */
+    void commitSave();
+
+    /**
+     * @brief The error of the last failed write of the save, if not taken yet.
+     */
+    [[nodiscard]] std::optional<std::string> takeSaveError();
+
+    [[nodiscard]] uint8_t read(const uint16_t address) const override
+    {
+        if (address <= MemoryMap::ROM.second) [[likely]]
+        {
+            return _romWindows[address / ROM_BANK_SIZE][address % ROM_BANK_SIZE];
+        }
+        if (_ramWindow != nullptr) [[likely]]
+        {
+            return _ramWindow[address % RAM_BANK_SIZE];
+        }
+
+        return readUnmappedRam(address);
+    }
 
-    uint8_t                        read(uint16_t address) const override;
     void                           write(uint16_t address, uint8_t value) override;
     [[nodiscard]] AddressableRange getAddressableRange() const noexcept override;
+    [[nodiscard]] const uint8_t*   getReadablePage(uint16_t address) const noexcept override;
+    [[nodiscard]] uint8_t*         getWritablePage(uint16_t address) noexcept override;
 
     [[nodiscard]] const std::string_view& get_title() const;
     [[nodiscard]] const std::string_view& get_licensee() const;
     [[nodiscard]] Type                    get_type() const;
     [[nodiscard]] std::size_t             get_rom_size() const;
 
-    explicit operator std::span<uint8_t>();
+    explicit operator std::span<const uint8_t>() const;
 
   private:
+    enum class Controller : uint8_t
+    {
+        NONE,
+        MBC1,
+        MBC2,
+        MBC3,
+        MBC5,
+    };
+
+    /**
+     * @brief The bank registers, as last written. Their meaning depends on the controller.
+     */
+    struct BankRegisters
+    {
+        bool     isRamEnabled{};
+        /**
+         * @brief MBC1 BANK1 and MBC2 ROMB, with 0 already turned into 1, MBC3 ROM bank and MBC5 ROMB0/ROMB1.
+         */
+        uint16_t romBank{1};
+        /**
+         * @brief MBC1 BANK2, MBC3 RAM bank or RTC register, MBC5 RAMB.
+         */
+        uint8_t  upperBank{};
+        /**
+         * @brief MBC1 banking mode.
+         */
+        uint8_t  mode{};
+    };
+
+    static constexpr std::size_t ROM_BANK_SIZE{RomImage::BANK_SIZE};
+    static constexpr std::size_t RAM_BANK_SIZE{0x2000};
+
+    void writeBankRegister(uint16_t address, uint8_t value);
+
+    /**
+     * @brief Look up the host memory of the banks selected by the bank registers, and have the buses remap the windows
+     * which changed.
+     */
+    void updateBanks();
+
+    /**
+     * @brief Slow path of the accesses to 0xA000-0xBFFF, when they are not backed by a RAM bank: disabled RAM, MBC2
+     * built-in RAM, MBC3 RTC registers.
+     */
+    [[nodiscard]] uint8_t readUnmappedRam(uint16_t address) const;
+    void                  writeUnmappedRam(uint16_t address, uint8_t value);
+
+    /**
+     * @brief Write the real-time clock to the save, if both exist, and mark it dirty.
+     */
+    void saveRealTimeClock();
+    void detachSave();
+
+    EmulationState& _emulationState;
+    RemapHandler    _remapHandler{};
+
+    Controller    _controller{Controller::NONE};
+    /**
+     * @brief MBC1 multicarts wire BANK2 to bits 4-5 of the ROM bank rather than 5-6.
+     */
+    bool          _isMulticart{};
+    BankRegisters _registers{};
+
+    std::array<const uint8_t*, 2> _romWindows{};
+    uint8_t*                      _ramWindow{};
+
+    /**
+     * @brief The RAM, held by the save file once one is attached, by ramStorage otherwise.
+     */
+    std::span<std::uint8_t>   _ram{};
+    std::vector<std::uint8_t> _ramStorage{};
+    std::unique_ptr<SaveFile> _save{};
+
+    RealTimeClock _realTimeClock;
+
     std::string_view title{};
     std::string_view licensee{};
     std::size_t      rom_size{};
     Type             type{};
 
-    std::vector<std::uint8_t> content{};
+    std::shared_ptr<const RomImage> _image{};
+    std::span<const uint8_t>        content{};
 };
 
 #endif  // CARTRIDGE_H
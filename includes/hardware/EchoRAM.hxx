@@ -15,6 +15,8 @@ class EchoRAM final : public IAddressable
     void                  write(uint16_t address, uint8_t value) override;
 
     [[nodiscard]] AddressableRange getAddressableRange() const noexcept override;
+    [[nodiscard]] const uint8_t*   getReadablePage(uint16_t address) const noexcept override;
+    [[nodiscard]] uint8_t*         getWritablePage(uint16_t address) noexcept override;
 
   private:
     static uint16_t getRealAddress(uint16_t address);
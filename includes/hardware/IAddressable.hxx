@@ -20,6 +20,35 @@ struct IAddressable
     virtual void                  write(uint16_t address, uint8_t value) = 0;
 
     [[nodiscard]] virtual AddressableRange getAddressableRange() const noexcept = 0;
+
+    /**
+     * @brief Read without side effects, for debuggers. Components which catch up lazily on reads report their state as
+     * of their last synchronization.
+     */
+    [[nodiscard]] virtual uint8_t peek(const uint16_t address) const
+    {
+        return read(address);
+    }
+
+    /**
+     * @brief Host memory backing the 256-byte page containing address, for memory whose reads have no side effect. The
+     * bus then reads the page directly instead of calling read(), until it is remapped.
+     */
+    [[nodiscard]] virtual const uint8_t* getReadablePage(uint16_t address) const noexcept
+    {
+        (void) address;
+        return nullptr;
+    }
+
+    /**
+     * @brief Host memory backing the 256-byte page containing address, for memory whose writes have no side effect.
+     * The bus then writes the page directly instead of calling write(), until it is remapped.
+     */
+    [[nodiscard]] virtual uint8_t* getWritablePage(uint16_t address) noexcept
+    {
+        (void) address;
+        return nullptr;
+    }
 };
 
 struct ITicking
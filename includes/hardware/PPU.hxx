@@ -6,16 +6,45 @@
 #define PPU_HXX
 
 #include <array>
+#include <memory>
 #include <queue>
+#include <span>
 
 #include "IRenderer.hxx"
 #include "graphics/Framebuffer.hxx"
+#include "graphics/LineKernels.hxx"
+#include "graphics/Tile.hxx"
+#include "graphics/TileCache.hxx"
 #include "hardware/IAddressable.hxx"
-
-class PPU final : public IComponent
+#include "hardware/Scheduler.hxx"
+
+/**
+ * @brief The PPU catches up to the scheduler time when it is accessed, and schedules itself on the points where it has
+ * an effect on the rest of the system: an interrupt request, or a frame to render.
+ *
+ * How often it wakes up, and whether it draws at all, is a compile-time accuracy policy (see BasicPPU). The policies
+ * are picked at runtime through create().
+ */
+class PPU : public IAddressable, public Scheduler::IHandler
 {
   public:
-    explicit PPU(IAddressable& bus, IRenderer& renderer);
+    enum class Accuracy : uint8_t
+    {
+        /**
+         * @brief The PPU wakes up on every mode transition, so that idle loops polling STAT can be skipped exactly.
+         */
+        CYCLE,
+        /**
+         * @brief The PPU only wakes up at the end of each line, where LY changes and interrupts are requested.
+         * Registers read exactly, but idle loops polling the STAT mode are skipped up to the end of the line.
+         */
+        SCANLINE,
+        /**
+         * @brief Same timing as SCANLINE, but no line is drawn: the renderer is only told about frame boundaries. Meant
+         * for headless runs, where only the emulated machine state matters.
+         */
+        FRAME,
+    };
 
     struct Status
     {
@@ -39,13 +68,37 @@ class PPU final : public IComponent
         static constexpr uint8_t LCDAndPPUEnable{1 << 7};
     };
 
-    [[nodiscard]] uint8_t read(uint16_t address) const override;
-    void                  write(uint16_t address, uint8_t value) override;
-    void                  tick(size_t machineCycle) override;
-    void                  setPostBootRomRegisters();
+    [[nodiscard]] static std::unique_ptr<PPU> create(Accuracy accuracy, IAddressable& bus, IRenderer& renderer,
+                                                     Scheduler& scheduler);
+
+    virtual void                   setPostBootRomRegisters() = 0;
+    [[nodiscard]] virtual Accuracy getAccuracy() const noexcept = 0;
+};
+
+/**
+ * @brief The PPU, with the bookkeeping its accuracy policy does not need compiled out.
+ */
+template <PPU::Accuracy ACCURACY>
+class BasicPPU final : public PPU
+{
+  public:
+    BasicPPU(IAddressable& bus, IRenderer& renderer, Scheduler& scheduler);
+
+    [[nodiscard]] uint8_t        read(uint16_t address) const override;
+    [[nodiscard]] uint8_t        peek(uint16_t address) const override;
+    [[nodiscard]] const uint8_t* getReadablePage(uint16_t address) const noexcept override;
+    void                         write(uint16_t address, uint8_t value) override;
+    void                         onEvent(Scheduler::Event event, Scheduler::Timestamp timestamp) override;
+    void                         setPostBootRomRegisters() override;
 
+    [[nodiscard]] Accuracy         getAccuracy() const noexcept override;
     [[nodiscard]] AddressableRange getAddressableRange() const noexcept override;
 
+    /**
+     * @brief Draw lines with the kernels of another instruction set than the best one supported, e.g. to compare them.
+     */
+    void setInstructionSet(Graphics::LineKernels::InstructionSet instructionSet);
+
   private:
     enum class Mode : uint8_t
     {
@@ -132,8 +185,8 @@ class PPU final : public IComponent
          * bank 0 or 1, depending on bit 3 of the following byte. In 8×16 mode (LCDC bit 2 = 1), the memory area at
          * $8000-$8FFF is still interpreted as a series of 8×8 tiles, where every 2 tiles form an object. In this mode,
          * this byte specifies the index of the first (top) tile of the object. This is enforced by the hardware: the
-         * least significant bit of the tile index is ignored; that is, the top 8×8 tile is “NN & $FE”, and the bottom
-         * 8×8 tile is “NN | $01”.
+         * least significant bit of the tile index is ignored; that is, the top 8×8 tile is “NN & $FE”, and the
+         * bottom 8×8 tile is “NN | $01”.
          */
         uint8_t tileIndex{};
 
@@ -179,36 +232,80 @@ class PPU final : public IComponent
     };
 
     using OAMArray         = std::array<OAMEntry, 40>;
-    using OAMArrayItVector = std::vector<OAMArray::const_iterator>;
-    using ObjPixel         = std::pair<OAMArray::const_iterator, uint8_t>;
-    using BgPixel          = std::pair<bool, uint8_t>;
+    using OAMArrayItVector = std::vector<typename OAMArray::const_iterator>;
     using VideoRAM         = std::array<uint8_t, 0x2000>;
 
+    /**
+     * @brief Color indices of the background and window pixels of a line, with the window ones tagged as such.
+     */
+    struct BackgroundLine
+    {
+        std::array<uint8_t, Graphics::LINE_WIDTH> pixels{};
+        /**
+         * @brief The pixels from this one on are window pixels.
+         */
+        std::size_t windowStart{Graphics::LINE_WIDTH};
+    };
+
     static_assert(sizeof(OAMEntry) == 4, "There should be no padding!");
 
     void                   _drawLine();
-    [[nodiscard]] ObjPixel _spriteFetch(uint8_t x) const;
-    [[nodiscard]] BgPixel  _bgFetch(uint8_t x) const;
-    [[nodiscard]] uint8_t  _pixelMixing(const ObjPixel& objPixel, const BgPixel& bgPixel) const;
+    /**
+     * @brief Rasterize the objects selected for the line once, following ObjectPixel.
+     */
+    [[nodiscard]] std::array<uint8_t, Graphics::LINE_WIDTH> _fetchObjectLine() const;
+
+    /**
+     * @brief Walk the tile maps once per tile rather than once per pixel, decoding the tile rows of the line at once.
+     */
+    [[nodiscard]] BackgroundLine _fetchBackgroundLine() const;
+    /**
+     * @brief Copy the decoded row of consecutive tiles of a tile map, from a column on, wrapping around the map.
+     */
+    void _fetchTileRows(uint16_t tileMapAddress, uint8_t column, uint8_t row, std::span<uint8_t> pixels) const;
+
+    /**
+     * @brief Run the PPU up to a machine cycle.
+     */
+    void _synchronize(Scheduler::Timestamp timestamp);
+    void _schedule();
+
+    /**
+     * @brief Number of dots until the current mode ends.
+     */
+    [[nodiscard]] size_t _getDotsToModeEnd() const noexcept;
+    /**
+     * @brief Number of dots until the PPU has to wake up, as per its accuracy policy.
+     */
+    [[nodiscard]] size_t _getDotsToNextEvent() const noexcept;
+    void                 _endMode();
 
     void _transition(Mode transitionTo);
     void _triggerStatInterrupt(bool value);
 
-    IRenderer&       _renderer;
-    IAddressable&    _bus;
-    VideoRAM         _videoRam{};
-    OAMArray         _oamEntries{};
-    OAMArrayItVector _oamEntriesToDraw{};
-    bool             _videoRamAccessible{true};
-    bool             _oamAccessible{true};
-    bool             _irq{};
-    Registers        _registers{};
-    uint16_t         _dots{};
-    uint8_t          _pixelsToDiscard{};
-    uint8_t          _windowLineCounter{};
-    Mode             _mode{Mode::Disabled};
+    IRenderer&                   _renderer;
+    IAddressable&                _bus;
+    Scheduler&                   _scheduler;
+    Scheduler::Timestamp         _synchronizedAt{};
+    const Graphics::LineKernels* _lineKernels;
+    VideoRAM                     _videoRam{};
+    Graphics::TileCache          _tileCache{};
+    OAMArray                     _oamEntries{};
+    OAMArrayItVector             _oamEntriesToDraw{};
+    bool                         _videoRamAccessible{true};
+    bool                         _oamAccessible{true};
+    bool                         _irq{};
+    Registers                    _registers{};
+    uint16_t                     _dots{};
+    uint8_t                      _pixelsToDiscard{};
+    uint8_t                      _windowLineCounter{};
+    Mode                         _mode{Mode::Disabled};
 
     friend class MooneyeAcceptance;
 };
 
+extern template class BasicPPU<PPU::Accuracy::CYCLE>;
+extern template class BasicPPU<PPU::Accuracy::SCANLINE>;
+extern template class BasicPPU<PPU::Accuracy::FRAME>;
+
 #endif  // PPU_HXX
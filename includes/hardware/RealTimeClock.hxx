@@ -0,0 +1,110 @@
+#ifndef GBEMU_REALTIMECLOCK_HXX
+#define GBEMU_REALTIMECLOCK_HXX
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "hardware/Scheduler.hxx"
+
+/**
+ * @brief The real-time clock of MBC3 cartridges, mapped at 0xA000-0xBFFF when RTC registers 0x08-0x0C are selected.
+ *
+ * The clock is never ticked: it keeps its time as of a machine cycle, and catches up to the scheduler time when
+ * accessed. Registers written out of range are folded into the higher ones rather than counting up to their overflow.
+ */
+class RealTimeClock
+{
+  public:
+    enum class Mode : uint8_t
+    {
+        /**
+         * @brief The time elapsed since a save was written is added when it is restored, as if the battery kept the
+         * clock running while the emulator was closed.
+         */
+        REAL_TIME,
+        /**
+         * @brief The clock only follows the emulated time, so that runs are reproducible.
+         */
+        EMULATED,
+    };
+
+    enum class Register : uint8_t
+    {
+        SECONDS   = 0x08,
+        MINUTES   = 0x09,
+        HOURS     = 0x0A,
+        DAYS_LOW  = 0x0B,
+        DAYS_HIGH = 0x0C,
+    };
+
+    /**
+     * @brief Size of the state appended to save files, in the layout most emulators share: the registers and the
+     * latched registers as 32-bit little-endian words, then the UNIX time of the save as a 64-bit one.
+     */
+    static constexpr std::size_t SAVE_SIZE{48};
+
+    explicit RealTimeClock(const Scheduler& scheduler);
+
+    /**
+     * @brief Set the clock back to day 0, 00:00:00, running.
+     */
+    void reset();
+
+    [[nodiscard]] static bool isRegister(uint8_t select) noexcept;
+
+    /**
+     * @brief The register as of the last latch.
+     */
+    [[nodiscard]] uint8_t read(Register reg) const noexcept;
+    void                  write(Register reg, uint8_t value);
+
+    /**
+     * @brief Writes to 0x6000-0x7FFF. Writing 0x00 then 0x01 copies the registers to the ones read.
+     */
+    void latch(uint8_t value);
+
+    void save(std::span<uint8_t, SAVE_SIZE> state);
+
+    /**
+     * @brief Restore a state written by save(). A blank state, from a save written without the clock, resets it.
+     */
+    void restore(std::span<const uint8_t, SAVE_SIZE> state, Mode mode);
+
+  private:
+    static constexpr Scheduler::Timestamp CYCLES_PER_SECOND{0x100000};
+    static constexpr uint64_t             SECONDS_PER_DAY{24 * 60 * 60};
+    static constexpr uint64_t             DAY_COUNT{512};
+
+    static constexpr uint8_t DAY_HIGH_MASK{0x01};
+    static constexpr uint8_t HALT_MASK{0x40};
+    static constexpr uint8_t DAY_CARRY_MASK{0x80};
+
+    using Registers = std::array<uint8_t, 5>;
+
+    /**
+     * @brief Elapse the machine cycles since the last synchronization, unless halted.
+     */
+    void synchronize();
+    void elapse(uint64_t seconds) noexcept;
+
+    [[nodiscard]] Registers getRegisters() const noexcept;
+    void                    setRegisters(const Registers& registers) noexcept;
+
+    const Scheduler&     _scheduler;
+    Scheduler::Timestamp _synchronizedAt{};
+
+    /**
+     * @brief Time since day 0, 00:00:00, below 512 days.
+     */
+    uint64_t             _seconds{};
+    Scheduler::Timestamp _cycles{};
+    bool                 _isHalted{};
+    bool                 _isDayCarry{};
+
+    Registers _latched{};
+    uint8_t   _latch{0xFF};
+};
+
+#endif  // GBEMU_REALTIMECLOCK_HXX
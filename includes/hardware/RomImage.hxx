@@ -0,0 +1,76 @@
+#ifndef GBEMU_ROMIMAGE_HXX
+#define GBEMU_ROMIMAGE_HXX
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief A ROM file, mapped read-only and shared by every cartridge running it.
+ *
+ * Images are cached by path, size and modification time as long as a cartridge holds them: opening the same ROM again
+ * neither reads nor copies it. Pages are only read from the file when first accessed. Files whose size is not a whole
+ * number of banks are copied and padded instead, as are all files where mapping is not supported.
+ */
+class RomImage
+{
+  public:
+    struct Header
+    {
+        std::string_view title;
+        std::string_view newLicensee;
+        uint8_t          oldLicensee;
+        uint8_t          type;
+        uint8_t          romSize;
+        uint8_t          ramSize;
+    };
+
+    static constexpr std::size_t BANK_SIZE{0x4000};
+
+    /**
+     * @brief The image of the ROM at path, checked once when first opened. Throws if the file cannot be read, or if
+     * its size or its header checksum is invalid.
+     */
+    [[nodiscard]] static std::shared_ptr<const RomImage> open(const std::filesystem::path& path);
+
+    RomImage(const RomImage&)            = delete;
+    RomImage& operator=(const RomImage&) = delete;
+
+    /**
+     * @brief The ROM, in whole banks.
+     */
+    [[nodiscard]] std::span<const uint8_t> getData() const noexcept;
+    [[nodiscard]] const Header&            getHeader() const noexcept;
+
+  private:
+    /**
+     * @brief Unmaps the file when destroyed, including when the header of the image turns out to be invalid.
+     */
+    struct Mapping
+    {
+        Mapping() = default;
+        ~Mapping();
+
+        Mapping(const Mapping&)            = delete;
+        Mapping& operator=(const Mapping&) = delete;
+
+        void*       address{};
+        std::size_t size{};
+    };
+
+    explicit RomImage(const std::filesystem::path& path);
+
+    void map(const std::filesystem::path& path, std::size_t size);
+    void copy(const std::filesystem::path& path, std::size_t size);
+
+    std::span<const uint8_t> _data{};
+    Header                   _header{};
+
+    Mapping              _mapping{};
+    std::vector<uint8_t> _copy{};
+};
+
+#endif  // GBEMU_ROMIMAGE_HXX
@@ -0,0 +1,106 @@
+#ifndef GBEMU_SAVEFILE_HXX
+#define GBEMU_SAVEFILE_HXX
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief The battery-backed RAM of a cartridge, persisted to a save file without the emulation thread ever waiting on
+ * the disk.
+ */
+class SaveFile
+{
+  public:
+    enum class Mode : uint8_t
+    {
+        /**
+         * @brief The RAM is copied whenever it is committed, and a background thread writes the copy to a temporary
+         * file renamed over the save: a crash leaves either the previous save or the new one.
+         */
+        COPY,
+        /**
+         * @brief The RAM is the save file, mapped in memory, and the kernel writes it back on its own. A crash may
+         * leave a save written half-way. Falls back to COPY where mapping is not supported.
+         */
+        MAPPED,
+    };
+
+    /**
+     * @brief Open the save at path, or create it. Saves shorter than size, e.g. from another emulator, are padded
+     * with 0xFF.
+     */
+    SaveFile(std::filesystem::path path, std::size_t size, Mode mode);
+
+    /**
+     * @brief Write the last changes, waiting for the disk this time.
+     */
+    ~SaveFile();
+
+    SaveFile(const SaveFile&)            = delete;
+    SaveFile& operator=(const SaveFile&) = delete;
+
+    /**
+     * @brief The RAM itself. Writes to it must be followed by markDirty().
+     */
+    [[nodiscard]] std::span<uint8_t> getRam() noexcept;
+
+    void markDirty() noexcept
+    {
+        _isDirty = true;
+    }
+
+    /**
+     * @brief Hand the changes since the last commit over to the background thread. Does nothing when there are none,
+     * or when the background thread is still busy with the previous ones: they are then coalesced with the next
+     * commit. Changes the background thread failed to write are handed over again. Meant to be called regularly by the
+     * emulation thread, e.g. once a frame.
+     */
+    void commit();
+
+    /**
+     * @brief The error of the last failed background write, if not taken yet.
+     */
+    [[nodiscard]] std::optional<std::string> takeError();
+
+  private:
+    void run(const std::stop_token& stopToken);
+    void load();
+    void map();
+    void write(std::span<const uint8_t> ram) const;
+
+    std::filesystem::path _path;
+    Mode                  _mode;
+    std::vector<uint8_t>  _ram{};
+    std::span<uint8_t>    _mapping{};
+
+    /**
+     * @brief Only touched by the emulation thread.
+     */
+    bool _isDirty{};
+
+    /**
+     * @brief The copy of the RAM being written. It belongs to the background thread while isPending is set, and to the
+     * emulation thread otherwise.
+     */
+    std::vector<uint8_t>        _pending{};
+    std::atomic<bool>           _isPending{};
+    /**
+     * @brief Set by the background thread when it fails to write the pending changes, before clearing isPending. The
+     * error itself is guarded by the mutex.
+     */
+    std::atomic<bool>           _hasFailed{};
+    std::optional<std::string>  _error{};
+    std::mutex                  _mutex{};
+    std::condition_variable_any _wakeUp{};
+    std::jthread                _thread{};
+};
+
+#endif  // GBEMU_SAVEFILE_HXX
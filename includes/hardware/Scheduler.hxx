@@ -0,0 +1,109 @@
+#ifndef GBEMU_SCHEDULER_HXX
+#define GBEMU_SCHEDULER_HXX
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief Keeps the emulated time, in machine cycles, and the deadlines of the events the components are waiting for.
+ *
+ * Components are not ticked on every machine cycle anymore: they catch up to the current time when they are accessed,
+ * and ask to be woken up at the next point where they have an effect on the rest of the system (an interrupt request,
+ * a frame to render, the end of an OAM DMA...). There is a single deadline per kind of event, so the pending events
+ * are kept in a small table indexed by event, along with its earliest deadline.
+ */
+class Scheduler
+{
+  public:
+    using Timestamp = uint64_t;
+
+    static constexpr Timestamp NEVER{std::numeric_limits<Timestamp>::max()};
+
+    /**
+     * @brief Kinds of events. Events due on the same machine cycle are dispatched in this order.
+     */
+    enum class Event : uint8_t
+    {
+        OAM_DMA_START,
+        OAM_DMA_END,
+        TIMER,
+        PPU,
+        COUNT,
+    };
+
+    struct IHandler
+    {
+        virtual ~IHandler() = default;
+
+        /**
+         * @brief Called when an event is due.
+         * @param event The event.
+         * @param timestamp The machine cycle the event is due on. Components are never further than the previous one.
+         */
+        virtual void onEvent(Event event, Timestamp timestamp) = 0;
+    };
+
+    Scheduler();
+
+    void setHandler(Event event, IHandler& handler);
+
+    /**
+     * @brief Schedule an event, replacing its previous deadline if any.
+     */
+    void schedule(Event event, Timestamp timestamp);
+    void cancel(Event event);
+
+    [[nodiscard]] bool      isScheduled(Event event) const noexcept;
+    [[nodiscard]] Timestamp getDeadline(Event event) const noexcept;
+
+    /**
+     * @brief Number of machine cycles elapsed so far.
+     */
+    [[nodiscard]] Timestamp getTimestamp() const noexcept
+    {
+        return _timestamp;
+    }
+
+    /**
+     * @brief Earliest deadline among the scheduled events, or NEVER.
+     */
+    [[nodiscard]] Timestamp getNextDeadline() const noexcept
+    {
+        return _nextDeadline;
+    }
+
+    /**
+     * @brief Elapse machine cycles on which no event is due, at once. Throws if an event is due within them.
+     */
+    void skip(Timestamp machineCycles);
+
+    /**
+     * @brief Elapse one machine cycle, dispatching the events due on it.
+     */
+    void tick()
+    {
+        const auto timestamp{_timestamp + 1};
+
+        if (timestamp >= _nextDeadline) [[unlikely]]
+        {
+            dispatch(timestamp);
+        }
+
+        _timestamp = timestamp;
+    }
+
+  private:
+    static constexpr auto EVENT_COUNT{static_cast<std::size_t>(Event::COUNT)};
+
+    void dispatch(Timestamp timestamp);
+    void updateNextDeadline() noexcept;
+
+    std::array<Timestamp, EVENT_COUNT> _deadlines{};
+    std::array<IHandler*, EVENT_COUNT> _handlers{};
+    Timestamp                          _timestamp{};
+    Timestamp                          _nextDeadline{NEVER};
+};
+
+#endif  // GBEMU_SCHEDULER_HXX
@@ -0,0 +1,429 @@
+#ifndef GBEMU_STATICBUS_HXX
+#define GBEMU_STATICBUS_HXX
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "AddressSpaceSnapshot.hxx"
+#include "Common.hxx"
+#include "EmulationState.hxx"
+#include "IAddressable.hxx"
+#include "Utils.hxx"
+
+namespace AddressDecoder
+{
+    /**
+     * @brief The component an address is routed to by a StaticBus.
+     */
+    enum class Target : uint8_t
+    {
+        BOOT_ROM,
+        CARTRIDGE,
+        PPU,
+        TIMER,
+        CPU,
+        JOYPAD,
+        WORK_RAM,
+        ECHO_RAM,
+        BOOT_ROM_REGISTER,
+        RAM,
+        /**
+         * @brief Out of reach during OAM DMA: reads return 0xFF and writes are dropped.
+         */
+        LOCKED_OUT,
+    };
+
+    [[nodiscard]] constexpr Target decode(const uint16_t address, const bool isInOamDma) noexcept
+    {
+        using namespace MemoryMap;
+
+        if (isInOamDma && !Utils::addressIn(address, HIGH_RAM))
+        {
+            return Target::LOCKED_OUT;
+        }
+
+        if (Utils::addressIn(address, BOOT_ROM))
+        {
+            return Target::BOOT_ROM;
+        }
+        if (Utils::addressIn(address, ROM) || Utils::addressIn(address, EXT_RAM))
+        {
+            return Target::CARTRIDGE;
+        }
+        if (Utils::addressIn(address, VIDEO_RAM) || Utils::addressIn(address, OAM))
+        {
+            return Target::PPU;
+        }
+        if (Utils::addressIn(address, WORK_RAM))
+        {
+            return Target::WORK_RAM;
+        }
+        if (Utils::addressIn(address, ECHO_RAM))
+        {
+            return Target::ECHO_RAM;
+        }
+
+        switch (address)
+        {
+            case IORegisters::DIV:
+            case IORegisters::TIMA:
+            case IORegisters::TMA:
+            case IORegisters::TAC:
+                return Target::TIMER;
+            case IORegisters::LCDC:
+            case IORegisters::STAT:
+            case IORegisters::SCY:
+            case IORegisters::SCX:
+            case IORegisters::LY:
+            case IORegisters::LYC:
+            case IORegisters::BGP:
+            case IORegisters::OBP0:
+            case IORegisters::OBP1:
+            case IORegisters::WY:
+            case IORegisters::WX:
+                return Target::PPU;
+            case IORegisters::IF:
+            case IORegisters::DMA:
+            case IE:
+                return Target::CPU;
+            case IORegisters::JOYPAD:
+                return Target::JOYPAD;
+            case IORegisters::BOOTM:
+                return Target::BOOT_ROM_REGISTER;
+            default:
+                return Target::RAM;
+        }
+    }
+
+    /**
+     * @brief The target of every address, indexed by whether OAM DMA is in progress.
+     */
+    inline constexpr auto TARGETS{[]
+    {
+        std::array<std::array<Target, 0x10000>, 2> targets{};
+
+        for (std::size_t address{0}; address < 0x10000; ++address)
+        {
+            targets[false][address] = decode(static_cast<uint16_t>(address), false);
+            targets[true][address]  = decode(static_cast<uint16_t>(address), true);
+        }
+
+        return targets;
+    }()};
+
+    /**
+     * @brief Whether each 256-byte page is routed to a single target, outside of OAM DMA.
+     */
+    inline constexpr auto UNIFORM_PAGES{[]
+    {
+        std::array<bool, 0x100> uniformPages{};
+
+        for (std::size_t page{0}; page < uniformPages.size(); ++page)
+        {
+            uniformPages[page] = true;
+
+            for (std::size_t offset{0}; offset < 0x100; ++offset)
+            {
+                uniformPages[page] =
+                    uniformPages[page] && TARGETS[false][page * 0x100 + offset] == TARGETS[false][page * 0x100];
+            }
+        }
+
+        return uniformPages;
+    }()};
+}  // namespace AddressDecoder
+
+/**
+ * @brief A bus whose components are known at compile time. Addresses are decoded through constexpr tables, and
+ * accesses dispatched with direct calls to the concrete, final component types rather than through the IAddressable of
+ * each component. Echo RAM is folded onto work RAM. Whatever is not routed elsewhere goes to RAMType, as the catch-all
+ * FakeRAM is attached last to the dynamic Bus.
+ *
+ * The same object may fill several roles, e.g. a FakeRAM holding the program as the cartridge.
+ */
+template <typename CartridgeType, typename PPUType, typename TimerType, typename CPUType, typename JoypadType,
+          typename WorkRAMType, typename RAMType>
+class StaticBus final : public IAddressable
+{
+  public:
+    StaticBus(const EmulationState& emulationState, CartridgeType& cartridge, PPUType& ppu, TimerType& timer,
+              CPUType& cpu, JoypadType& joypad, WorkRAMType& workRam, RAMType& ram)
+        : _emulationState(emulationState),
+          _cartridge(cartridge),
+          _ppu(ppu),
+          _timer(timer),
+          _cpu(cpu),
+          _joypad(joypad),
+          _workRam(workRam),
+          _ram(ram)
+    {
+    }
+
+    void loadBootRom(const std::array<uint8_t, 256>& bootRom) noexcept
+    {
+        _bootRom = bootRom;
+    }
+
+    void setPostBootRomRegisters()
+    {
+        _bootRomMapped = 1;
+    }
+
+    [[nodiscard]] uint8_t read(const uint16_t address) const override
+    {
+        using enum AddressDecoder::Target;
+
+        switch (AddressDecoder::TARGETS[_emulationState.isInOamDma][address])
+        {
+            case BOOT_ROM:
+                return _bootRomMapped ? _cartridge.read(address) : _bootRom[address];
+            case CARTRIDGE:
+                return _cartridge.read(address);
+            case PPU:
+                return _ppu.read(address);
+            case TIMER:
+                return _timer.read(address);
+            case CPU:
+                return _cpu.read(address);
+            case JOYPAD:
+                return _joypad.read(address);
+            case WORK_RAM:
+                return _workRam.read(address);
+            case ECHO_RAM:
+                return _workRam.read(getWorkRamAddress(address));
+            case BOOT_ROM_REGISTER:
+                return _bootRomMapped;
+            case RAM:
+                return _ram.read(address);
+            case LOCKED_OUT:
+            default:
+                return 0xFF;
+        }
+    }
+
+    void write(const uint16_t address, const uint8_t value) override
+    {
+        using enum AddressDecoder::Target;
+
+        const auto target{AddressDecoder::TARGETS[_emulationState.isInOamDma][address]};
+
+        markWritten(address, target);
+
+        switch (target)
+        {
+            case BOOT_ROM:
+                if (_bootRomMapped)
+                {
+                    _cartridge.write(address, value);
+                }
+                else
+                {
+                    _bootRom[address] = value;
+                }
+                break;
+            case CARTRIDGE:
+                _cartridge.write(address, value);
+                break;
+            case PPU:
+                _ppu.write(address, value);
+                break;
+            case TIMER:
+                _timer.write(address, value);
+                break;
+            case CPU:
+                _cpu.write(address, value);
+                break;
+            case JOYPAD:
+                _joypad.write(address, value);
+                break;
+            case WORK_RAM:
+                _workRam.write(address, value);
+                break;
+            case ECHO_RAM:
+                _workRam.write(getWorkRamAddress(address), value);
+                break;
+            case BOOT_ROM_REGISTER:
+                _bootRomMapped = value;
+                break;
+            case RAM:
+                _ram.write(address, value);
+                break;
+            case LOCKED_OUT:
+            default:
+                break;
+        }
+    }
+
+    [[nodiscard]] uint8_t peek(const uint16_t address) const override
+    {
+        using enum AddressDecoder::Target;
+
+        switch (AddressDecoder::TARGETS[false][address])
+        {
+            case BOOT_ROM:
+                return _bootRomMapped ? _cartridge.peek(address) : _bootRom[address];
+            case CARTRIDGE:
+                return _cartridge.peek(address);
+            case PPU:
+                return _ppu.peek(address);
+            case TIMER:
+                return _timer.peek(address);
+            case CPU:
+                return _cpu.peek(address);
+            case JOYPAD:
+                return _joypad.peek(address);
+            case WORK_RAM:
+                return _workRam.peek(address);
+            case ECHO_RAM:
+                return _workRam.peek(getWorkRamAddress(address));
+            case BOOT_ROM_REGISTER:
+                return _bootRomMapped;
+            case RAM:
+                return _ram.peek(address);
+            case LOCKED_OUT:
+            default:
+                return 0xFF;
+        }
+    }
+
+    [[nodiscard]] AddressableRange getAddressableRange() const noexcept override
+    {
+        return {std::make_pair(0x0000, 0xFFFF)};
+    }
+
+    /**
+     * @brief Host memory backing a page routed to a single target, if the target has some.
+     */
+    [[nodiscard]] const uint8_t* getReadablePage(const uint16_t address) const noexcept override
+    {
+        using enum AddressDecoder::Target;
+
+        switch (AddressDecoder::TARGETS[false][address])
+        {
+            case BOOT_ROM:
+                return _bootRomMapped ? _cartridge.getReadablePage(address) : _bootRom.data();
+            case CARTRIDGE:
+                return _cartridge.getReadablePage(address);
+            case PPU:
+                return _ppu.getReadablePage(address);
+            case WORK_RAM:
+                return _workRam.getReadablePage(address);
+            case ECHO_RAM:
+                return _workRam.getReadablePage(getWorkRamAddress(address));
+            case RAM:
+                return _ram.getReadablePage(address);
+            default:
+                return nullptr;
+        }
+    }
+
+    /**
+     * @brief Refresh snapshot with the current content of the address space, as Bus::takeSnapshot() does.
+     */
+    void takeSnapshot(AddressSpaceSnapshot& snapshot, const AddressSpaceSnapshot::Mode mode)
+    {
+        constexpr auto PAGE_SIZE{AddressSpaceSnapshot::PAGE_SIZE};
+
+        for (std::size_t page{0}; page < _writeGenerations.size(); ++page)
+        {
+            const auto  address{static_cast<uint16_t>(page * PAGE_SIZE)};
+            const auto* hostMemory{AddressDecoder::UNIFORM_PAGES[page] ? getReadablePage(address) : nullptr};
+            auto* const memory{snapshot.memory.data() + address};
+
+            /* Pages without host memory belong to components whose content may change on its own, such as LY or DIV. */
+            if (mode == AddressSpaceSnapshot::Mode::INCREMENTAL && hostMemory != nullptr &&
+                _writeGenerations[page] != _generation)
+            {
+                snapshot.dirtyPages.reset(page);
+                continue;
+            }
+
+            snapshot.dirtyPages.set(page);
+
+            if (hostMemory != nullptr)
+            {
+                std::memcpy(memory, hostMemory, PAGE_SIZE);
+                continue;
+            }
+
+            for (std::size_t offset{0}; offset < PAGE_SIZE; ++offset)
+            {
+                memory[offset] = peek(static_cast<uint16_t>(address + offset));
+            }
+        }
+
+        _generation += 1;
+    }
+
+  private:
+    /**
+     * @brief Record a write to address for incremental snapshots, along with the pages it may change through aliasing
+     * or bank switching.
+     */
+    void markWritten(const uint16_t address, const AddressDecoder::Target target) noexcept
+    {
+        using enum AddressDecoder::Target;
+
+        _writeGenerations[address >> 8] = _generation;
+
+        switch (target)
+        {
+            case BOOT_ROM:
+            case CARTRIDGE:
+                /* Writes to the ROM may switch any bank. */
+                if (address <= MemoryMap::ROM.second)
+                {
+                    for (const auto& [first, last] : {MemoryMap::ROM, MemoryMap::EXT_RAM})
+                    {
+                        std::fill(_writeGenerations.begin() + (first >> 8), _writeGenerations.begin() + (last >> 8) + 1,
+                                  _generation);
+                    }
+                }
+                break;
+            case WORK_RAM:
+                if (const auto echo{static_cast<uint16_t>(address + 0x2000)}; echo <= MemoryMap::ECHO_RAM.second)
+                {
+                    _writeGenerations[echo >> 8] = _generation;
+                }
+                break;
+            case ECHO_RAM:
+                _writeGenerations[getWorkRamAddress(address) >> 8] = _generation;
+                break;
+            case BOOT_ROM_REGISTER:
+                _writeGenerations[0] = _generation;
+                break;
+            default:
+                break;
+        }
+    }
+
+    [[nodiscard]] static constexpr uint16_t getWorkRamAddress(const uint16_t address) noexcept
+    {
+        return MemoryMap::WORK_RAM.first + static_cast<uint16_t>(address & 0x1FFF);
+    }
+
+    const EmulationState& _emulationState;
+    CartridgeType&        _cartridge;
+    PPUType&              _ppu;
+    TimerType&            _timer;
+    CPUType&              _cpu;
+    JoypadType&           _joypad;
+    WorkRAMType&          _workRam;
+    RAMType&              _ram;
+
+    /**
+     * @brief Indicates whether the boot ROM is currently mapped to the memory map. Active low.
+     */
+    uint8_t                    _bootRomMapped{};
+    std::array<uint8_t, 0x100> _bootRom{};
+
+    /**
+     * @brief The snapshot generation each page was last written to. The current generation is the number of snapshots
+     * taken.
+     */
+    std::array<uint32_t, 0x100> _writeGenerations{};
+    uint32_t                    _generation{};
+};
+
+#endif  // GBEMU_STATICBUS_HXX
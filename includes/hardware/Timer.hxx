@@ -6,8 +6,13 @@
 #define TIMER_HPP
 
 #include "hardware/IAddressable.hxx"
+#include "hardware/Scheduler.hxx"
 
-class Timer final : public IComponent
+/**
+ * @brief DIV and TIMA. The timer catches up to the scheduler time when it is accessed, and schedules itself on the
+ * machine cycle it requests an interrupt on.
+ */
+class Timer final : public IAddressable, public Scheduler::IHandler
 {
   public:
     enum class State
@@ -17,19 +22,36 @@ class Timer final : public IComponent
         RELOADING_TIMA_TO_TMA,
     };
 
-    explicit Timer(IAddressable& bus);
+    Timer(IAddressable& bus, Scheduler& scheduler);
     ~Timer() override;
 
     void                           write(uint16_t address, uint8_t value) override;
     uint8_t                        read(uint16_t address) const override;
+    [[nodiscard]] uint8_t          peek(uint16_t address) const override;
     [[nodiscard]] AddressableRange getAddressableRange() const noexcept override;
-    void                           tick(size_t machineCycle = 1) override;
+    void                           onEvent(Scheduler::Event event, Scheduler::Timestamp timestamp) override;
 
   private:
+    /**
+     * @brief Run the timer up to a machine cycle.
+     */
+    void synchronize(Scheduler::Timestamp timestamp);
+    void step();
+    void schedule();
+
+    /**
+     * @brief Number of machine cycles after which the n-th falling edge of the selected system counter bit occurs.
+     */
+    [[nodiscard]] size_t getMachineCyclesToEdge(size_t edge) const noexcept;
+    [[nodiscard]] bool   getSelectedBit() const noexcept;
+
     void setSystemCounter(uint16_t value);
     void detectFallingEdge(bool bit);
 
     IAddressable& bus;
+    Scheduler&    scheduler;
+
+    Scheduler::Timestamp synchronizedAt{};
 
     uint16_t system_counter{0xABCC};
     uint8_t  TIMA{};
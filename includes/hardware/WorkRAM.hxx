@@ -28,6 +28,16 @@ class FixedSizeRAM : public IAddressable
         content[address - O] = value;
     }
 
+    [[nodiscard]] const uint8_t* getReadablePage(uint16_t address) const noexcept override
+    {
+        return content.data() + ((address - O) & ~0xFF);
+    }
+
+    [[nodiscard]] uint8_t* getWritablePage(uint16_t address) noexcept override
+    {
+        return content.data() + ((address - O) & ~0xFF);
+    }
+
   private:
     std::array<uint8_t, N> content{};
 };
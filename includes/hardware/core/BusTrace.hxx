@@ -0,0 +1,146 @@
+#ifndef GBEMU_BUSTRACE_HXX
+#define GBEMU_BUSTRACE_HXX
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iosfwd>
+#include <new>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hardware/Scheduler.hxx"
+
+/**
+ * @brief Records the memory accesses of the CPU, to be streamed to a binary file and decoded to text offline.
+ *
+ * The CPU pushes records into a RingBuffer, and a Writer thread drains it to the file. The CPU never waits for the
+ * writer: records pushed while the buffer is full are dropped, and counted.
+ */
+namespace BusTrace
+{
+    enum class Kind : uint8_t
+    {
+        READ    = 'R',
+        WRITE   = 'W',
+        /**
+         * @brief An instruction starts at the address. The value is its opcode.
+         */
+        EXECUTE = 'X',
+    };
+
+    /**
+     * @brief One access, as stored in the ring buffer and in trace files.
+     */
+    struct Record
+    {
+        Scheduler::Timestamp timestamp;
+        /**
+         * @brief Address of the instruction performing the access.
+         */
+        uint16_t pc;
+        uint16_t address;
+        uint8_t  value;
+        Kind     kind;
+    };
+
+    static_assert(sizeof(Record) == 16, "Records are written to trace files as is");
+
+    /**
+     * @brief Starts every trace file, followed by the records in host byte order.
+     */
+    struct FileHeader
+    {
+        static constexpr std::array<char, 8> MAGIC{'G', 'B', 'T', 'R', 'A', 'C', 'E', '\0'};
+        static constexpr uint32_t            VERSION{1};
+
+        std::array<char, 8> magic{MAGIC};
+        uint32_t            version{VERSION};
+        uint32_t            recordSize{sizeof(Record)};
+    };
+
+    /**
+     * @brief Lock-free ring buffer with a single producer, the CPU, and a single consumer.
+     */
+    class RingBuffer
+    {
+      public:
+        /**
+         * @brief Capacity is rounded up to a power of two.
+         */
+        explicit RingBuffer(std::size_t capacity);
+
+        /**
+         * @return false if the buffer is full, in which case the record is dropped.
+         */
+        bool push(const Record& record) noexcept;
+
+        /**
+         * @brief Move up to records.size() records out of the buffer, oldest first.
+         * @return The number of records moved.
+         */
+        std::size_t pop(std::span<Record> records) noexcept;
+
+        /**
+         * @brief Number of records dropped because the buffer was full.
+         */
+        [[nodiscard]] std::size_t getDropped() const noexcept;
+
+      private:
+        static constexpr std::size_t CACHE_LINE_SIZE{64};
+
+        std::vector<Record> _records;
+        std::size_t         _mask;
+
+        /**
+         * @brief Both indices only ever increase, and are kept apart so that the producer and the consumer do not
+         * share a cache line.
+         */
+        alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> _head{};
+        std::size_t _dropped{};
+        alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> _tail{};
+    };
+
+    /**
+     * @brief Streams the records of a ring buffer to a trace file, from its own thread, until stopped or destroyed. The
+     * records still buffered when stopping are written too.
+     */
+    class Writer
+    {
+      public:
+        Writer(RingBuffer& ringBuffer, const std::string& path);
+
+        Writer(const Writer&)            = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        /**
+         * @brief Write the records still buffered, and wait for the thread to end.
+         */
+        void stop();
+
+        /**
+         * @brief Whether writing to the file failed, e.g. on a full disk. The records taken out of the ring buffer
+         * from then on are lost, and the trace is truncated. Final once stopped.
+         */
+        [[nodiscard]] bool hasFailed() const noexcept;
+
+      private:
+        void run(const std::stop_token& stopToken);
+
+        RingBuffer&       _ringBuffer;
+        std::ofstream     _file;
+        std::atomic<bool> _hasFailed{};
+        std::jthread      _thread;
+    };
+
+    /**
+     * @brief Decode a trace file to text, one access per line. Throws if input is not a trace file.
+     */
+    void decode(std::istream& input, std::ostream& output);
+}  // namespace BusTrace
+
+#endif  // GBEMU_BUSTRACE_HXX
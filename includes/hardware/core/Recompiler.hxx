@@ -0,0 +1,99 @@
+#ifndef GBEMU_RECOMPILER_HXX
+#define GBEMU_RECOMPILER_HXX
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "hardware/core/SM83.hxx"
+
+/**
+ * @brief Translates SM83 basic blocks to native x86-64 code.
+ *
+ * Only the instructions working on registers are translated: the run of such instructions at the start of a block
+ * becomes a native function, and everything else is left to the interpreter. Since translated instructions never touch
+ * the bus, the CPU can account for their machine cycles before running them, and stop the run right after the
+ * instruction that lets an interrupt in.
+ */
+class Recompiler
+{
+  public:
+    /**
+     * @brief CPU registers as seen by the translated code, which addresses them by their offset in the register file.
+     */
+    using Registers = SM83::Registers;
+
+    struct CompiledBlock
+    {
+        struct Instruction
+        {
+            /**
+             * @brief Address of the next instruction, which PC holds once this one has run.
+             */
+            uint16_t nextAddress{};
+            uint8_t  machineCycles{};
+        };
+
+        const void*              entry{};
+        uint16_t                 bank{};
+        uint16_t                 address{};
+        uint16_t                 end{};
+        std::vector<Instruction> instructions{};
+    };
+
+    Recompiler();
+    ~Recompiler();
+
+    Recompiler(const Recompiler&)            = delete;
+    Recompiler& operator=(const Recompiler&) = delete;
+
+    /**
+     * @brief Whether native code can be generated and run on this platform.
+     */
+    [[nodiscard]] static bool isSupported() noexcept;
+
+    /**
+     * @brief Whether an instruction only works on registers, and thus can be translated.
+     */
+    [[nodiscard]] static bool isRecompilable(const SM83::BlockCache::Instruction& instruction) noexcept;
+
+    /**
+     * @brief Get the native code of a block, translating it if needed.
+     * @return The translated block, or nullptr if its first instruction cannot be translated.
+     */
+    [[nodiscard]] const CompiledBlock* get(const SM83::BlockCache::Block& block, uint16_t bank);
+
+    /**
+     * @brief Run the first count instructions of a translated block.
+     */
+    static void execute(const CompiledBlock& block, Registers& registers, std::size_t count);
+
+    /**
+     * @brief Drop every translated block containing the byte at address.
+     */
+    void invalidate(uint16_t address);
+    void flush();
+
+  private:
+    static constexpr std::size_t CODE_BUFFER_SIZE{4 * 1024 * 1024};
+    static constexpr std::size_t MAX_BLOCK_CODE_SIZE{64 * SM83::BlockCache::MAX_INSTRUCTIONS_PER_BLOCK};
+
+    [[nodiscard]] CompiledBlock compile(const SM83::BlockCache::Block& block);
+
+    std::unordered_map<uint32_t, CompiledBlock> _blocks{};
+    /**
+     * @brief Keys of the translated blocks starting in each 256-byte page, as in SM83::BlockCache.
+     */
+    std::array<std::vector<uint32_t>, 0x100> _pageKeys{};
+    /**
+     * @brief Last block looked up at each address, to spare the hash lookup on hot paths.
+     */
+    std::array<const CompiledBlock*, 0x10000> _entries{};
+
+    uint8_t*    _code{};
+    std::size_t _codeSize{};
+};
+
+#endif  // GBEMU_RECOMPILER_HXX
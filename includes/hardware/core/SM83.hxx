@@ -1,24 +1,37 @@
 #ifndef CPU_H
 #define CPU_H
 
+#include <array>
+#include <bit>
+#include <bitset>
 #include <cstdint>
+#include <cstring>
 #include <functional>
+#include <limits>
 #include <map>
+#include <memory>
 #include <optional>
 #include <span>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "Common.hxx"
 #include "EmulationState.hxx"
 #include "hardware/IAddressable.hxx"
 #include "hardware/PPU.hxx"
+#include "hardware/Scheduler.hxx"
+#include "hardware/core/BusTrace.hxx"
 
 namespace Test
 {
     class SM83;
 }
 
-class SM83 final : public IComponent
+class Recompiler;
+
+class SM83 final : public IComponent, public Scheduler::IHandler
 {
   public:
     enum class Flags : uint8_t
@@ -63,6 +76,82 @@ class SM83 final : public IComponent
         STOPPED,
     };
 
+    /**
+     * @brief Why runUntil() returned. Each reason but BUDGET is a bit of the stop mask given to runUntil().
+     */
+    enum class StopReason : uint8_t
+    {
+        NONE = 0,
+        /**
+         * @brief The machine cycle budget is spent. Always enabled.
+         */
+        BUDGET = 1 << 0,
+        /**
+         * @brief The next instruction is at a breakpoint.
+         */
+        BREAKPOINT = 1 << 1,
+        /**
+         * @brief A frame has been rendered. Requested from outside, see requestStop().
+         */
+        FRAME = 1 << 2,
+        /**
+         * @brief A serial transfer has been started by a write to SC.
+         */
+        SERIAL = 1 << 3,
+        /**
+         * @brief A watchpoint has been hit, see getWatchpointHit().
+         */
+        WATCHPOINT = 1 << 4,
+    };
+
+    /**
+     * @brief The kinds of access a watchpoint triggers on.
+     */
+    enum class Access : uint8_t
+    {
+        NONE    = 0,
+        READ    = 1 << 0,
+        WRITE   = 1 << 1,
+        /**
+         * @brief The next instruction starts in the watched range.
+         */
+        EXECUTE = 1 << 2,
+    };
+
+    struct Watchpoint
+    {
+        MemoryMap::AddressRange range;
+        Access                  access;
+    };
+
+    struct WatchpointHit
+    {
+        /**
+         * @brief Address of the instruction performing the access.
+         */
+        uint16_t             pc;
+        uint16_t             address;
+        /**
+         * @brief Value before and after the access. Both are the value read for reads, and the opcode for executions.
+         */
+        uint8_t              oldValue;
+        uint8_t              newValue;
+        Access               access;
+        Scheduler::Timestamp timestamp;
+    };
+
+    enum class Backend
+    {
+        /**
+         * @brief Every instruction is interpreted.
+         */
+        INTERPRETER,
+        /**
+         * @brief Runs of register-only instructions are translated to native code, the rest is interpreted.
+         */
+        RECOMPILER,
+    };
+
     class Disassembler
     {
       public:
@@ -97,45 +186,170 @@ class SM83 final : public IComponent
         static const InstructionLookup prefixedInstructionLookup;
     };
 
-    struct View
+    /**
+     * @brief Cache of predecoded basic blocks, keyed by ROM bank and address.
+     *
+     * A block is a straight run of instructions ending at the first control transfer. Its instructions hold their
+     * opcode and operand bytes, so that the CPU does not go through the bus to fetch them. Blocks are only built from
+     * ROM, Work RAM and High RAM, and the blocks covering a byte of RAM are dropped as soon as that byte is written.
+     */
+    class BlockCache
     {
-        struct Registers
+      public:
+        struct Instruction
+        {
+            uint16_t               address{};
+            std::array<uint8_t, 3> bytes{};
+            uint8_t                length{};
+            /**
+             * @brief Machine cycles taken by the instruction, with any conditional branch not taken.
+             */
+            uint8_t machineCycles{};
+        };
+
+        struct Block
+        {
+            uint16_t                 bank{};
+            std::vector<Instruction> instructions{};
+            std::size_t              machineCycles{};
+        };
+
+        static constexpr std::size_t MAX_INSTRUCTIONS_PER_BLOCK{32};
+        /**
+         * @brief Bytes spanned by a block at most, instructions being up to 3 bytes long.
+         */
+        static constexpr std::size_t MAX_BLOCK_SIZE{MAX_INSTRUCTIONS_PER_BLOCK * 3};
+
+        /**
+         * @brief Get the block starting at address, decoding it from memory if it is not cached yet.
+         * @return The block, or nullptr if no instruction can be cached at this address.
+         */
+        [[nodiscard]] const Block* get(uint16_t address, uint16_t bank, const IAddressable& memory);
+
+        /**
+         * @brief Drop every block containing the byte at address.
+         */
+        void invalidate(uint16_t address);
+        void flush();
+
+        [[nodiscard]] bool isCode(const uint16_t address) const noexcept
+        {
+            return _codeReferences[address] != 0;
+        }
+        [[nodiscard]] std::size_t size() const noexcept
         {
-            uint8_t A{};
-            uint8_t F{};
-            uint8_t B{};
-            uint8_t C{};
-            uint8_t D{};
-            uint8_t E{};
-            uint8_t H{};
-            uint8_t L{};
+            return _blocks.size();
+        }
+
+        [[nodiscard]] static bool    isCacheable(uint16_t address) noexcept;
+        [[nodiscard]] static uint8_t getInstructionLength(uint8_t opcode) noexcept;
+        [[nodiscard]] static uint8_t getMachineCycles(uint8_t opcode, uint8_t extendedOpcode) noexcept;
+
+      private:
+        [[nodiscard]] static Block decode(uint16_t address, const IAddressable& memory);
+        void                       reference(const Block& block, int delta);
+
+        std::unordered_map<uint32_t, Block> _blocks{};
+        /**
+         * @brief Keys of the blocks starting in each 256-byte page, in any bank: invalidating a byte only looks at the
+         * blocks starting less than MAX_BLOCK_SIZE bytes before it.
+         */
+        std::array<std::vector<uint32_t>, 0x100> _pageKeys{};
+        /**
+         * @brief Last block looked up at each address, to spare the hash lookup on hot paths.
+         */
+        std::array<const Block*, 0x10000> _entries{};
+        /**
+         * @brief Number of cached blocks covering each byte of the address space.
+         */
+        std::array<uint16_t, 0x10000> _codeReferences{};
+    };
 
+    /**
+     * @brief The register file. Each register pair is a native 16-bit word, with its two 8-bit registers aliased over
+     * its bytes: 16-bit operations need no packing and unpacking. It fits in 16 bytes, thus a single cache line.
+     */
+    struct alignas(16) Registers
+    {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+        union
+        {
             uint16_t AF{};
+            struct
+            {
+                uint8_t F;
+                uint8_t A;
+            };
+        };
+        union
+        {
             uint16_t BC{};
+            struct
+            {
+                uint8_t C;
+                uint8_t B;
+            };
+        };
+        union
+        {
             uint16_t DE{};
+            struct
+            {
+                uint8_t E;
+                uint8_t D;
+            };
+        };
+        union
+        {
             uint16_t HL{};
+            struct
+            {
+                uint8_t L;
+                uint8_t H;
+            };
+        };
+#pragma GCC diagnostic pop
 
-            uint16_t SP{};
-            uint16_t PC{};
-        } registers;
+        uint16_t SP{};
+        uint16_t PC{};
 
-        struct Flags
-        {
-            bool zero{};
-            bool subtract{};
-            bool halfCarry{};
-            bool carry{};
-        } flags;
+        /**
+         * @brief Interrupt Enable.
+         */
+        uint8_t IE{};
+        /**
+         * @brief Interrupt Flags.
+         */
+        uint8_t IF{};
+        /**
+         * @brief Instruction Register.
+         */
+        uint8_t IR{};
+        /**
+         * @brief Interrupt Master Enable flag.
+         */
+        bool IME{};
+    };
+
+    static_assert(std::endian::native == std::endian::little, "Register pairs alias their bytes in host order");
+    static_assert(sizeof(Registers) == 16);
 
-        struct Interrupts
+    /**
+     * @brief Snapshot of the registers, with the flags up to date in F. Trivially copyable, and compared bytewise.
+     */
+    struct View
+    {
+        Registers registers;
+
+        bool operator==(const View& other) const noexcept
         {
-            bool    IME{};
-            uint8_t IE{};
-            uint8_t IF{};
-        } interrupts;
+            return std::memcmp(&registers, &other.registers, sizeof(Registers)) == 0;
+        }
     };
 
-    SM83(EmulationState& emulationState, IAddressable& bus, ITicking& timer, ITicking& ppu);
+    SM83(EmulationState& emulationState, IAddressable& bus, Scheduler& scheduler);
+    ~SM83() override;
 
     void                           write(uint16_t address, uint8_t value) override;
     [[nodiscard]] uint8_t          read(uint16_t address) const override;
@@ -146,10 +360,133 @@ class SM83 final : public IComponent
     void tick(size_t machineCycle) override;
     void runInstruction();
 
+    /**
+     * @brief Run instructions until at least machineCycles have elapsed, or until one of the stop conditions in
+     * stopMask fires. Conditions are checked in between instructions: the instruction causing the stop is completed.
+     * @return The reason the run stopped.
+     */
+    StopReason runUntil(std::size_t machineCycles, StopReason stopMask);
+
+    /**
+     * @brief Stop the current runUntil() once the running instruction has completed, if reason is part of its stop
+     * mask. Meant for components and frontends, e.g. at the end of a frame.
+     */
+    void requestStop(StopReason reason) noexcept;
+
+    void addBreakpoint(uint16_t address);
+    void removeBreakpoint(uint16_t address);
+    void addWatchpoint(const Watchpoint& watchpoint);
+    void removeWatchpoint(const Watchpoint& watchpoint);
+
+    /**
+     * @brief The watchpoint hit which stopped the last run, if it stopped on a watchpoint.
+     */
+    [[nodiscard]] const std::optional<WatchpointHit>& getWatchpointHit() const noexcept;
+
+    /**
+     * @brief Record every instruction and memory access into trace, or stop tracing if trace is null. Tracing runs
+     * every instruction through the interpreter, and leaves out the accesses of fast-forwarded idle loops.
+     */
+    void setTrace(BusTrace::RingBuffer* trace);
+
+    /**
+     * @brief Start and end of OAM DMA.
+     */
+    void onEvent(Scheduler::Event event, Scheduler::Timestamp timestamp) override;
+
     void               applyView(const View& view);
     [[nodiscard]] View getView() const;
 
+    /**
+     * @brief Select how instructions are run. Throws if the recompiler is not supported on this platform.
+     */
+    void                  setBackend(Backend backend);
+    [[nodiscard]] Backend getBackend() const noexcept;
+
+    /**
+     * @brief Number of instructions executed since power on.
+     */
+    [[nodiscard]] std::size_t getRetiredInstructions() const noexcept;
+
+    /**
+     * @brief Fast-forward the loops polling memory until the next scheduled event, instead of running them. Disabled
+     * by default.
+     */
+    void               setIdleLoopSkipping(bool enabled) noexcept;
+    [[nodiscard]] bool isIdleLoopSkipping() const noexcept;
+
+    /**
+     * @brief Number of machine cycles fast-forwarded in idle loops since power on.
+     */
+    [[nodiscard]] std::size_t getSkippedMachineCycles() const noexcept;
+
   private:
+    /**
+     * @brief 8-bit operand encoded in bits 0-2 (source) or bits 3-5 (destination) of an opcode.
+     */
+    enum class Operand8 : uint8_t
+    {
+        B,
+        C,
+        D,
+        E,
+        H,
+        L,
+        IndirectHL,
+        A,
+    };
+
+    /**
+     * @brief 16-bit register pair encoded in bits 4-5 of an opcode. PUSH and POP encode AF in place of SP.
+     */
+    enum class Operand16 : uint8_t
+    {
+        BC,
+        DE,
+        HL,
+        SP,
+        AF,
+    };
+
+    /**
+     * @brief Last flag setting operation, whose flags are only computed when something reads them.
+     */
+    enum class FlagOperation : uint8_t
+    {
+        NONE,
+        /**
+         * @brief 8-bit addition of lhs, rhs and carry.
+         */
+        ADD,
+        /**
+         * @brief 8-bit subtraction of rhs and carry from lhs.
+         */
+        SUB,
+        /**
+         * @brief 8-bit increment, giving lhs. Carry is left untouched.
+         */
+        INC,
+        /**
+         * @brief 8-bit decrement, giving lhs. Carry is left untouched.
+         */
+        DEC,
+        /**
+         * @brief Zero is set from the result in lhs, the other flags are given by rhs.
+         */
+        RESULT,
+    };
+
+    struct PendingFlags
+    {
+        FlagOperation operation{FlagOperation::NONE};
+        uint8_t       lhs{};
+        uint8_t       rhs{};
+        uint8_t       carry{};
+    };
+
+    using InstructionHandler = void (SM83::*)();
+    using InstructionTable   = std::array<InstructionHandler, 0x100>;
+
     void onMachineCycle();
 
     /**
@@ -162,47 +499,85 @@ class SM83 final : public IComponent
      */
     void decodeExecuteInstruction(bool extended_set = false);
 
-    [[nodiscard]] uint8_t fetchMemory(uint16_t address);
-    [[nodiscard]] uint8_t fetchOperand();
-    void                  writeMemory(uint16_t address, uint8_t value);
+    /**
+     * @brief Handler of a single opcode. Every operand encoded in the opcode is resolved at compile time.
+     */
+    template <uint8_t Opcode>
+    void executeInstruction();
 
     /**
-     * @brief AF register getter.
+     * @brief Handler of a single 0xCB prefixed opcode.
      */
-    [[nodiscard]] uint16_t AF() const;
+    template <uint8_t Opcode>
+    void executeExtendedInstruction();
+
+    template <Operand8 Operand>
+    [[nodiscard]] uint8_t readOperand();
+    template <Operand8 Operand>
+    void writeOperand(uint8_t value);
+    template <Operand16 Operand>
+    [[nodiscard]] uint16_t readOperand() const;
+    template <Operand16 Operand>
+    void writeOperand(uint16_t value);
+
+    /**
+     * @brief Apply one of the eight 8-bit ALU operations (ADD, ADC, SUB, SBC, AND, XOR, OR, CP) to A.
+     */
+    template <uint8_t Operation>
+    void alu(uint8_t value);
+
+    [[nodiscard]] uint8_t fetchMemory(uint16_t address);
     /**
-     * @brief BC register getter.
+     * @brief fetchMemory(), without checking the read against the watchpoints: for instruction bytes.
      */
-    [[nodiscard]] uint16_t BC() const;
+    [[nodiscard]] uint8_t readMemory(uint16_t address);
+    [[nodiscard]] uint8_t fetchOperand();
     /**
-     * @brief DE register getter.
+     * @brief Read the byte at PC and increment PC, from the instruction cache when the current instruction is cached.
      */
-    [[nodiscard]] uint16_t DE() const;
+    [[nodiscard]] uint8_t fetchCode();
     /**
-     * @brief HL register getter.
+     * @brief Look up the cached instruction starting at PC, following the current block when possible.
      */
-    [[nodiscard]] uint16_t HL() const;
+    [[nodiscard]] const BlockCache::Instruction* lookupCachedInstruction();
+    /**
+     * @brief The ROM bank mapped where PC is, 0 outside of the ROM: decoded instructions are cached per bank.
+     */
+    [[nodiscard]] uint16_t getCodeBank() const noexcept;
 
     /**
-     * @brief Sets the contents of the A and F registers using the provided 16-bit value.
-     * @param value The 16-bit value to be split and assigned to the A and F registers.
+     * @brief Run the translated instructions starting at PC, if any.
+     * @return false if the instruction at PC has to be interpreted.
      */
-    void AF(uint16_t value);
+    [[nodiscard]] bool runRecompiledInstructions();
+    void                  writeMemory(uint16_t address, uint8_t value);
     /**
-     * @brief Sets the BC register pair by splitting a 16-bit value into two 8-bit values.
-     * @param value The 16-bit value to be split and stored in the B and C registers.
+     * @brief Slow path of the accesses to a watched page, or to any page while tracing: trace the access, then check
+     * it against the watchpoints. The value is the one read, or the one being written.
      */
-    void BC(uint16_t value);
+    void onWatchedAccess(uint16_t address, uint8_t value, Access access);
     /**
-     * @brief Sets the DE register using the specified 16-bit value.
-     * @param value The 16-bit value to be split and stored into the D and E registers.
+     * @brief Stop the run if one of the watchpoints covers the access.
      */
-    void DE(uint16_t value);
+    void checkWatchpoints(uint16_t address, uint8_t value, Access access);
+    void traceExecution();
+    void updateWatchedPages() noexcept;
+
+    /**
+     * @brief Called at the end of a backward jump, to a loop ending at end. Once an iteration has brought the CPU back
+     * to the same state, without any side effect or event in between, the iterations running before the next event are
+     * skipped.
+     */
+    void skipIdleLoop(uint16_t end);
+
     /**
-     * @brief Sets the HL register pair using the provided 16-bit value.
-     * @param value A 16-bit value split into two 8-bit values for the H and L registers.
+     * @brief AF register getter, with the flags of the pending operation applied.
      */
-    void HL(uint16_t value);
+    [[nodiscard]] uint16_t AF() const;
+    /**
+     * @brief Sets the contents of the A and F registers, discarding the pending flags.
+     */
+    void AF(uint16_t value);
 
     /**
      * @brief Performs an 8-bit addition with optional carry flag support.
@@ -293,47 +668,32 @@ class SM83 final : public IComponent
 
     void                  setFlag(Flags flag, bool value);
     [[nodiscard]] bool    getFlag(Flags flag) const;
-    [[nodiscard]] bool    isConditionMet(Conditionals conditional) const;
-    [[nodiscard]] uint8_t getInterruptRequest() const;
-    void                  interrupts();
-
-    uint8_t  A{};
-    uint8_t  F{};
-    uint8_t  B{};
-    uint8_t  C{};
-    uint8_t  D{};
-    uint8_t  E{};
-    uint8_t  H{};
-    uint8_t  L{};
-    uint16_t SP{};
-    uint16_t PC{};
-
     /**
-     * @brief Interrupt Enable.
+     * @brief Record the operation that sets the flags. F is left as is until the flags are read.
      */
-    uint8_t IE{};
+    void setFlags(FlagOperation operation, uint8_t lhs, uint8_t rhs = 0, uint8_t carry = 0);
     /**
-     * @brief Interrupt Flags.
+     * @brief Contents of F, with the flags of the pending operation applied.
      */
-    uint8_t IF{};
+    [[nodiscard]] uint8_t flags() const;
     /**
-     * @brief Instruction Register.
+     * @brief Apply the flags of the pending operation to F.
      */
-    uint8_t IR{};
+    void materializeFlags();
+    [[nodiscard]] bool    isConditionMet(Conditionals conditional) const;
+    [[nodiscard]] uint8_t getInterruptRequest() const;
+    void                  interrupts();
 
-    /**
-     * @brief State of the CPU.
-     */
-    State state{State::NORMAL};
+    static const InstructionTable instructionTable;
+    static const InstructionTable extendedInstructionTable;
 
-    /**
-     * @brief Represents the current operation code being executed.
-     */
+    Registers    _registers{};
+    PendingFlags _pendingFlags{};
 
     /**
-     * @brief Interrupt Master Enable flag.
+     * @brief State of the CPU.
      */
-    bool IME{};
+    State state{State::NORMAL};
 
     uint8_t requestIme{};
 
@@ -345,18 +705,94 @@ class SM83 final : public IComponent
      * - Second element: Target address in OAM (16-bit).
      */
     uint16_t oamDmaSourceAddress{};
-    uint8_t  requestOamDma{};
-    uint8_t  oamDmaElapsedMachineCycles{};
 
     EmulationState& emulationState;
     IAddressable&   bus;
-    ITicking&       timer;
-    ITicking&       ppu;
+    Scheduler&      scheduler;
 
     size_t _machineCyclesElapsed{};
+    /**
+     * @brief Machine cycles the current tick() or runUntil() is to run for, which skipping idle loops and HALT does not
+     * go past.
+     */
+    size_t _machineCycleBudget{std::numeric_limits<size_t>::max()};
+
+    BlockCache                     _blockCache;
+    const BlockCache::Block*       _block{};
+    std::size_t                    _blockIndex{};
+    const BlockCache::Instruction* _cachedInstruction{};
+
+    Backend                     _backend{Backend::INTERPRETER};
+    std::unique_ptr<Recompiler> _recompiler;
+    std::size_t                 _retiredInstructions{};
+
+    /**
+     * @brief State of the CPU when it last jumped back to the start of a loop.
+     */
+    struct IdleLoop
+    {
+        uint16_t             start{};
+        uint16_t             end{};
+        Scheduler::Timestamp timestamp{};
+        Scheduler::Timestamp nextDeadline{};
+        std::size_t          retiredInstructions{};
+        std::size_t          sideEffects{};
+        View                 view{};
+    };
+
+    static constexpr uint16_t MAX_IDLE_LOOP_SIZE{16};
+
+    bool                    _idleLoopSkipping{};
+    std::optional<IdleLoop> _idleLoop{};
+    /**
+     * @brief Counts the memory writes, and the reads of registers changing in between events (DIV, TIMA).
+     */
+    std::size_t _sideEffects{};
+    std::size_t _skippedMachineCycles{};
+
+    StopReason           _stopMask{StopReason::NONE};
+    StopReason           _stopReason{StopReason::NONE};
+    std::bitset<0x10000> _breakpoints{};
+
+    std::vector<Watchpoint>      _watchpoints{};
+    std::optional<WatchpointHit> _watchpointHit{};
+    /**
+     * @brief The kinds of access watched in each 256-byte page, every read and write while tracing. Accesses to the
+     * other pages skip the watchpoints.
+     */
+    std::array<Access, 0x100> _watchedPages{};
+    BusTrace::RingBuffer*     _trace{};
+    /**
+     * @brief Address of the instruction running under runUntil(), or traced, reported by watchpoint hits and traces.
+     */
+    uint16_t _instructionAddress{};
+    /**
+     * @brief Whether the current run has to stop in between any two instructions, which rules out translated blocks.
+     */
+    bool _isStepping{};
 
     friend class MooneyeAcceptance;
     friend class Test::SM83;
 };
 
+[[nodiscard]] constexpr SM83::StopReason operator|(const SM83::StopReason lhs, const SM83::StopReason rhs) noexcept
+{
+    return static_cast<SM83::StopReason>(std::to_underlying(lhs) | std::to_underlying(rhs));
+}
+
+[[nodiscard]] constexpr SM83::StopReason operator&(const SM83::StopReason lhs, const SM83::StopReason rhs) noexcept
+{
+    return static_cast<SM83::StopReason>(std::to_underlying(lhs) & std::to_underlying(rhs));
+}
+
+[[nodiscard]] constexpr SM83::Access operator|(const SM83::Access lhs, const SM83::Access rhs) noexcept
+{
+    return static_cast<SM83::Access>(std::to_underlying(lhs) | std::to_underlying(rhs));
+}
+
+[[nodiscard]] constexpr SM83::Access operator&(const SM83::Access lhs, const SM83::Access rhs) noexcept
+{
+    return static_cast<SM83::Access>(std::to_underlying(lhs) & std::to_underlying(rhs));
+}
+
 #endif
\ No newline at end of file
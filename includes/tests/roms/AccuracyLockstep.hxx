@@ -0,0 +1,24 @@
+#ifndef GBEMU_ACCURACYLOCKSTEP_HXX
+#define GBEMU_ACCURACYLOCKSTEP_HXX
+
+#include "TestRom.hxx"
+
+/**
+ * @brief Runs a mooneye ROM with each of the coarser PPU accuracies, along with a cycle-accurate reference, and
+ * compares the CPU views and the emulated time of both after every instruction. Without idle loop skipping, the
+ * accuracy policy must not be observable by the CPU.
+ */
+class AccuracyLockstep : public TestRom
+{
+  protected:
+    std::unique_ptr<Component> _reference{};
+
+    void TearDown() override;
+
+    void executeROM(const std::string& romName) override;
+
+  private:
+    void run();
+};
+
+#endif  // GBEMU_ACCURACYLOCKSTEP_HXX
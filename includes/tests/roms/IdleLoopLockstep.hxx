@@ -0,0 +1,28 @@
+#ifndef GBEMU_IDLELOOPLOCKSTEP_HXX
+#define GBEMU_IDLELOOPLOCKSTEP_HXX
+
+#include <span>
+
+#include "TestRom.hxx"
+
+/**
+ * @brief Runs a program with idle loop skipping, along with a CPU running every iteration as a reference, and compares
+ * the CPU views and the emulated time of both every time they have executed the same number of instructions. The
+ * program ends the mooneye way.
+ */
+class IdleLoopLockstep : public TestRom
+{
+  protected:
+    std::unique_ptr<Component> _reference{};
+
+    void SetUp() override;
+    void TearDown() override;
+
+    void executeROM(const std::string& romName) override;
+    void executeProgram(std::span<const uint8_t> program);
+
+  private:
+    void run();
+};
+
+#endif  // GBEMU_IDLELOOPLOCKSTEP_HXX
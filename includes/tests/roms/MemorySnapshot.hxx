@@ -0,0 +1,19 @@
+#ifndef GBEMU_MEMORYSNAPSHOT_HXX
+#define GBEMU_MEMORYSNAPSHOT_HXX
+
+#include <span>
+
+#include "TestRom.hxx"
+
+/**
+ * @brief Takes snapshots of the address space through Bus::takeSnapshot(), and checks them against what the CPU reads.
+ * Incremental snapshots must copy at least the pages written to since the previous one, and leave the others alone.
+ */
+class MemorySnapshot : public TestRom
+{
+  protected:
+    void executeROM(const std::string& romName) override;
+    void executeProgram(std::span<const uint8_t> program) const;
+};
+
+#endif  // GBEMU_MEMORYSNAPSHOT_HXX
@@ -0,0 +1,74 @@
+#ifndef GBEMU_MOONEYEMBC_HXX
+#define GBEMU_MOONEYEMBC_HXX
+
+#include "EmulationState.hxx"
+#include "HeadlessRenderer.hxx"
+#include "gtest/gtest.h"
+#include "hardware/Bus.hxx"
+#include "hardware/Cartridge.hxx"
+#include "hardware/EchoRAM.hxx"
+#include "hardware/Scheduler.hxx"
+#include "hardware/StaticBus.hxx"
+#include "hardware/Timer.hxx"
+#include "hardware/WorkRAM.hxx"
+#include "hardware/core/SM83.hxx"
+
+/**
+ * @brief Runs the mooneye emulator-only MBC ROMs, which pass in the same way as the acceptance ones, on a Cartridge
+ * attached to the dynamic Bus, then on a Cartridge composed with a StaticBus. The parameter is the ROM path, relative
+ * to the emulator-only directory.
+ */
+class MooneyeMbc : public ::testing::TestWithParam<const char*>
+{
+  protected:
+    struct DynamicComponent
+    {
+      private:
+        EmulationState   _state;
+        HeadlessRenderer _renderer;
+
+      public:
+        DynamicComponent();
+
+        void setPostBootRomRegisters();
+
+        Bus                  bus;
+        Scheduler            scheduler;
+        SM83                 cpu;
+        Cartridge            cartridge;
+        WorkRAM              workRam;
+        EchoRAM              echoRam;
+        FakeRAM              fakeRam;
+        Timer                timer;
+        std::unique_ptr<PPU> ppu;
+    };
+
+    struct StaticComponent
+    {
+      private:
+        EmulationState   _state;
+        HeadlessRenderer _renderer;
+
+      public:
+        StaticComponent();
+
+        void setPostBootRomRegisters();
+
+        using PPUType = BasicPPU<PPU::Accuracy::CYCLE>;
+        using BusType = StaticBus<Cartridge, PPUType, Timer, SM83, FakeRAM, WorkRAM, FakeRAM>;
+
+        BusType   bus;
+        Scheduler scheduler;
+        SM83      cpu;
+        Cartridge cartridge;
+        WorkRAM   workRam;
+        FakeRAM   fakeRam;
+        Timer     timer;
+        PPUType   ppu;
+    };
+
+    template <typename Component>
+    static void executeROM(Component& component, const std::string& romName);
+};
+
+#endif  // GBEMU_MOONEYEMBC_HXX
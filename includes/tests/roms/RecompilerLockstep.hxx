@@ -0,0 +1,21 @@
+#ifndef GBEMU_RECOMPILERLOCKSTEP_HXX
+#define GBEMU_RECOMPILERLOCKSTEP_HXX
+
+#include "TestRom.hxx"
+
+/**
+ * @brief Runs a ROM with the recompiler, along with the interpreter as a reference, and compares the CPU views of both
+ * every time they have executed the same number of instructions.
+ */
+class RecompilerLockstep : public TestRom
+{
+  protected:
+    std::unique_ptr<Component> _reference{};
+
+    void SetUp() override;
+    void TearDown() override;
+
+    void executeROM(const std::string& romName) override;
+};
+
+#endif  // GBEMU_RECOMPILERLOCKSTEP_HXX
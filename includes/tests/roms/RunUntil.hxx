@@ -0,0 +1,19 @@
+#ifndef GBEMU_RUNUNTIL_HXX
+#define GBEMU_RUNUNTIL_HXX
+
+#include <span>
+
+#include "TestRom.hxx"
+
+/**
+ * @brief Runs programs through SM83::runUntil() and checks where each stop condition leaves the CPU. Mooneye ROMs are
+ * run from serial byte to serial byte, and pass when they send the Fibonacci sequence.
+ */
+class RunUntil : public TestRom
+{
+  protected:
+    void executeROM(const std::string& romName) override;
+    void executeProgram(std::span<const uint8_t> program) const;
+};
+
+#endif  // GBEMU_RUNUNTIL_HXX
@@ -0,0 +1,44 @@
+#ifndef GBEMU_STATICBUSLOCKSTEP_HXX
+#define GBEMU_STATICBUSLOCKSTEP_HXX
+
+#include "TestRom.hxx"
+#include "hardware/StaticBus.hxx"
+
+/**
+ * @brief Runs a mooneye ROM on components composed with a StaticBus, along with the same components attached to the
+ * dynamic Bus as a reference, and compares the CPU views and the emulated time of both after every instruction, then
+ * the whole address space, both as read and as snapshotted.
+ */
+class StaticBusLockstep : public TestRom
+{
+  protected:
+    struct StaticComponent
+    {
+      private:
+        EmulationState   _state;
+        HeadlessRenderer _renderer;
+
+      public:
+        StaticComponent();
+
+        using PPUType = BasicPPU<PPU::Accuracy::CYCLE>;
+        using BusType = StaticBus<FakeRAM, PPUType, Timer, SM83, FakeRAM, WorkRAM, FakeRAM>;
+
+        BusType   bus;
+        Scheduler scheduler;
+        SM83      cpu;
+        WorkRAM   workRam;
+        FakeRAM   fakeRam;
+        Timer     timer;
+        PPUType   ppu;
+    };
+
+    std::unique_ptr<StaticComponent> _static{};
+
+    void SetUp() override;
+    void TearDown() override;
+
+    void executeROM(const std::string& romName) override;
+};
+
+#endif  // GBEMU_STATICBUSLOCKSTEP_HXX
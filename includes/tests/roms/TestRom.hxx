@@ -8,9 +8,11 @@
 #include <hardware/core/SM83.hxx>
 
 #include "EmulationState.hxx"
+#include "HeadlessRenderer.hxx"
 #include "gtest/gtest.h"
 #include "hardware/Bus.hxx"
 #include "hardware/EchoRAM.hxx"
+#include "hardware/Scheduler.hxx"
 #include "hardware/Timer.hxx"
 #include "hardware/WorkRAM.hxx"
 
@@ -20,20 +22,41 @@ class TestRom : public ::testing::Test
     struct Component
     {
       private:
-        EmulationState _state;
+        EmulationState   _state;
+        HeadlessRenderer _renderer;
 
       public:
-        Component();
-
-        Bus     bus;
-        SM83    cpu;
-        WorkRAM workRam;
-        EchoRAM echoRam;
-        FakeRAM fakeRam;
-        Timer   timer;
-        PPU     ppu;
+        explicit Component(PPU::Accuracy accuracy = PPU::Accuracy::CYCLE);
+
+        Bus                  bus;
+        Scheduler            scheduler;
+        SM83                 cpu;
+        WorkRAM              workRam;
+        EchoRAM              echoRam;
+        FakeRAM              fakeRam;
+        Timer                timer;
+        std::unique_ptr<PPU> ppu;
+    };
+
+    /**
+     * @brief Where a mooneye ROM stands, as signalled through its registers.
+     */
+    enum class MooneyeResult : uint8_t
+    {
+        RUNNING,
+        PASSED,
+        FAILED,
+        /**
+         * @brief Still running after MAX_MACHINE_CYCLES: a failing ROM, or program, may loop forever.
+         */
+        TIMED_OUT,
     };
 
+    /**
+     * @brief Twenty seconds of emulated time, far more than any of the ROMs needs.
+     */
+    static constexpr Scheduler::Timestamp MAX_MACHINE_CYCLES{20 * 0x100000};
+
     std::unique_ptr<Component> _component{};
 
     void SetUp() override;
@@ -41,6 +64,8 @@ class TestRom : public ::testing::Test
 
     void         loadROM(const std::string& romPath) const;
     virtual void executeROM(const std::string& romName) = 0;
+
+    [[nodiscard]] static MooneyeResult getMooneyeResult(const Component& component);
 };
 
 #endif  // GBEMU_TESTROM_HXX
@@ -0,0 +1,19 @@
+#ifndef GBEMU_TRACING_HXX
+#define GBEMU_TRACING_HXX
+
+#include <span>
+
+#include "TestRom.hxx"
+
+/**
+ * @brief Runs programs with SM83::setTrace() enabled, and checks the recorded accesses, along with the trace files
+ * written from them.
+ */
+class Tracing : public TestRom
+{
+  protected:
+    void executeROM(const std::string& romName) override;
+    void executeProgram(std::span<const uint8_t> program) const;
+};
+
+#endif  // GBEMU_TRACING_HXX
@@ -37,6 +37,7 @@ class MainWindow final : public QMainWindow
     void onBreakpointHit();
     void onFrameReady(const Graphics::Framebuffer& framebuffer);
     void onEmulationFatalError(const QString& message);
+    void onSaveError(const QString& message);
 
   signals:
     void requestSetBreakpoint(uint16_t address);
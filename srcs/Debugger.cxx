@@ -8,22 +8,25 @@ Emulator::Debugger::Debugger(SM83& cpu) : _cpu(cpu) {}
 
 void Emulator::Debugger::addBreakpoint(uint16_t address)
 {
-    _breakpoints.insert(address);
+    _cpu.addBreakpoint(address);
 }
 
 void Emulator::Debugger::removeBreakpoint(uint16_t address)
 {
-    _breakpoints.erase(address);
+    _cpu.removeBreakpoint(address);
 }
 
-bool Emulator::Debugger::shouldBreak() const
+void Emulator::Debugger::addWatchpoint(const SM83::Watchpoint& watchpoint)
 {
-    const SM83::View cpuView{_cpu.getView()};
+    _cpu.addWatchpoint(watchpoint);
+}
 
-    if (_breakpoints.contains(cpuView.registers.PC))
-    {
-        return true;
-    }
+void Emulator::Debugger::removeWatchpoint(const SM83::Watchpoint& watchpoint)
+{
+    _cpu.removeWatchpoint(watchpoint);
+}
 
-    return false;
+const std::optional<SM83::WatchpointHit>& Emulator::Debugger::getWatchpointHit() const noexcept
+{
+    return _cpu.getWatchpointHit();
 }
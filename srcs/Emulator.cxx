@@ -8,10 +8,13 @@
 #include <QThread>
 #include <QTimer>
 #include <iostream>
+#include <limits>
 
 Emulator::Emulator(const std::optional<QString>& bootRomPath, QObject* parent)
     : QObject(parent), _renderer(new QtRenderer(this)), _components(*_renderer), _debugger(_components.cpu)
 {
+    connect(_renderer, &QtRenderer::onRender, this, &Emulator::onRender, Qt::DirectConnection);
+
     if (!bootRomPath.has_value())
     {
         _components.bus.setPostBootRomRegisters();
@@ -20,8 +23,6 @@ Emulator::Emulator(const std::optional<QString>& bootRomPath, QObject* parent)
         return;
     }
 
-    connect(_renderer, &QtRenderer::onRender, this, &Emulator::onRender, Qt::DirectConnection);
-
     QFile                      file{bootRomPath.value()};
     std::array<uint8_t, 0x100> bootRom{};
 
@@ -48,7 +49,14 @@ void Emulator::startEmulation(const QString& path)
 {
     try
     {
-        _components.cartridge.load(path.toStdString());
+        auto& cartridge{_components.cartridge};
+
+        cartridge.load(path.toStdString());
+        if (cartridge.hasBattery())
+        {
+            cartridge.attachSave(std::filesystem::path{path.toStdString()}.replace_extension(".sav"),
+                                 SaveFile::Mode::COPY, RealTimeClock::Mode::REAL_TIME);
+        }
     }
     catch (const std::exception& e)
     {
@@ -74,20 +82,31 @@ void Emulator::setBreakpoint(const uint16_t address)
     _debugger.addBreakpoint(address);
 }
 
+void Emulator::refreshMemoryView()
+{
+    using enum AddressSpaceSnapshot::Mode;
+
+    _components.bus.takeSnapshot(_memorySnapshot, _isMemorySnapshotTaken ? INCREMENTAL : FULL);
+    _isMemorySnapshotTaken = true;
+
+    emit memoryViewChanged(_memorySnapshot);
+}
+
 void Emulator::runFrame()
 {
     const auto frameStart{std::chrono::steady_clock::now()};
 
     try
     {
-        _running = true;
+        using enum SM83::StopReason;
 
-        while (_running)
+        /* The debugger tells a watchpoint from a breakpoint through the watchpoint hit. */
+        if (const auto reason{_components.cpu.runUntil(std::numeric_limits<std::size_t>::max(),
+                                                       FRAME | BREAKPOINT | WATCHPOINT)};
+            reason == BREAKPOINT || reason == WATCHPOINT)
         {
-            if (stepInstruction())
-            {
-                return;
-            }
+            emit breakpointHit();
+            return;
         }
     }
     catch (const std::exception& e)
@@ -96,6 +115,13 @@ void Emulator::runFrame()
         return;
     }
 
+    /* Only copies the RAM, if it changed: the save is written to the disk in the background. */
+    _components.cartridge.commitSave();
+    if (const auto error{_components.cartridge.takeSaveError()})
+    {
+        emit saveError(QString::fromStdString(*error));
+    }
+
     const auto frameEnd{std::chrono::steady_clock::now()};
 
     if (const auto emulationTime{frameEnd - frameStart}; emulationTime < _frameDuration)
@@ -108,9 +134,7 @@ void Emulator::runFrame()
 
 bool Emulator::stepInstruction()
 {
-    _components.cpu.runInstruction();
-
-    if (_debugger.shouldBreak())
+    if (_components.cpu.runUntil(1, SM83::StopReason::BREAKPOINT) == SM83::StopReason::BREAKPOINT)
     {
         emit breakpointHit();
         return true;
@@ -121,21 +145,18 @@ bool Emulator::stepInstruction()
 
 void Emulator::onRender(const Graphics::Framebuffer& framebuffer)
 {
-    _running = false;
+    _components.cpu.requestStop(SM83::StopReason::FRAME);
 
     /* This signal will be delivered via a QueuedConnection and won't block here. */
     emit frameReady(framebuffer);
 }
 
 Emulator::Components::Components(IRenderer& renderer)
-    : _state(), bus(_state), timer(bus), ppu(bus, renderer), cpu(_state, bus, timer, ppu), echoRam(workRam)
+    : _state(),
+      bus(_state, cartridge, ppu, timer, cpu, joypad, workRam, fakeRam),
+      cartridge(_state, scheduler),
+      timer(bus, scheduler),
+      ppu(bus, renderer, scheduler),
+      cpu(_state, bus, scheduler)
 {
-    bus.attach(cartridge);
-    bus.attach(timer);
-    bus.attach(ppu);
-    bus.attach(cpu);
-    bus.attach(echoRam);
-    bus.attach(joypad);
-    bus.attach(workRam);
-    bus.attach(fakeRam);
 }
\ No newline at end of file
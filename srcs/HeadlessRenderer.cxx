@@ -0,0 +1,21 @@
+#include "HeadlessRenderer.hxx"
+
+IRenderer::Line HeadlessRenderer::getLine(const uint8_t y) noexcept
+{
+    return _framebuffer[y];
+}
+
+void HeadlessRenderer::render()
+{
+    _frameCount += 1;
+}
+
+const Graphics::Framebuffer& HeadlessRenderer::getFramebuffer() const noexcept
+{
+    return _framebuffer;
+}
+
+std::size_t HeadlessRenderer::getFrameCount() const noexcept
+{
+    return _frameCount;
+}
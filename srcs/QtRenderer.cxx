@@ -2,9 +2,9 @@
 
 QtRenderer::QtRenderer(QObject* parent) : QObject(parent) {}
 
-void QtRenderer::setPixel(const uint8_t x, const uint8_t y, const uint8_t pixel) noexcept
+IRenderer::Line QtRenderer::getLine(const uint8_t y) noexcept
 {
-    _framebuffer[y][x] = pixel;
+    return _framebuffer[y];
 }
 
 void QtRenderer::render()
@@ -0,0 +1,144 @@
+//
+// Measures the raw throughput of the SM83 interpreter, in instructions per second, on a test ROM.
+//
+// Usage: gbemu_bench [rom] [instructions] [interpreter|recompiler] [skip-idle-loops] [cycle|scanline|frame] [trace]
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "EmulationState.hxx"
+#include "HeadlessRenderer.hxx"
+#include "hardware/Bus.hxx"
+#include "hardware/EchoRAM.hxx"
+#include "hardware/PPU.hxx"
+#include "hardware/Scheduler.hxx"
+#include "hardware/Timer.hxx"
+#include "hardware/WorkRAM.hxx"
+#include "hardware/core/BusTrace.hxx"
+#include "hardware/core/SM83.hxx"
+
+namespace
+{
+    struct Components
+    {
+      private:
+        EmulationState   _state;
+        HeadlessRenderer _renderer;
+
+      public:
+        explicit Components(const PPU::Accuracy accuracy)
+            : _state(),
+              bus(_state),
+              cpu(_state, bus, scheduler),
+              echoRam(workRam),
+              timer(bus, scheduler),
+              ppu(PPU::create(accuracy, bus, _renderer, scheduler))
+        {
+            bus.attach(timer);
+            bus.attach(*ppu);
+            bus.attach(cpu);
+            bus.attach(echoRam);
+            bus.attach(workRam);
+            bus.attach(fakeRam);
+        }
+
+        Bus                  bus;
+        Scheduler            scheduler;
+        SM83                 cpu;
+        WorkRAM              workRam;
+        EchoRAM              echoRam;
+        FakeRAM              fakeRam;
+        Timer                timer;
+        std::unique_ptr<PPU> ppu;
+    };
+
+    void loadROM(FakeRAM& fakeRam, const std::string& romPath)
+    {
+        std::ifstream               input{romPath, std::ios::binary};
+        std::array<uint8_t, 0x8000> buffer{};
+
+        input.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        input.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+
+        for (std::size_t address{0}; address < buffer.size(); ++address)
+        {
+            fakeRam.write(static_cast<uint16_t>(address), buffer[address]);
+        }
+    }
+}  // namespace
+
+int main(const int argc, char* argv[])
+{
+    const std::string romPath{argc > 1 ? argv[1] : ROMS_PATH "/blargg/cpu_instrs/09-op r,r.gb"};
+    const std::size_t instructions{argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50'000'000ULL};
+    const std::string backend{argc > 3 ? argv[3] : "interpreter"};
+    const bool        skipIdleLoops{argc > 4 && std::string{argv[4]} == "skip-idle-loops"};
+    const std::string accuracy{argc > 5 ? argv[5] : "cycle"};
+    const std::string tracePath{argc > 6 ? argv[6] : ""};
+
+    Components components{accuracy == "frame"      ? PPU::Accuracy::FRAME
+                          : accuracy == "scanline" ? PPU::Accuracy::SCANLINE
+                                                   : PPU::Accuracy::CYCLE};
+
+    if (backend == "recompiler")
+    {
+        components.cpu.setBackend(SM83::Backend::RECOMPILER);
+    }
+
+    components.cpu.setIdleLoopSkipping(skipIdleLoops);
+
+    BusTrace::RingBuffer              trace{1 << 20};
+    std::unique_ptr<BusTrace::Writer> traceWriter{};
+
+    if (!tracePath.empty())
+    {
+        traceWriter = std::make_unique<BusTrace::Writer>(trace, tracePath);
+        components.cpu.setTrace(&trace);
+    }
+
+    loadROM(components.fakeRam, romPath);
+    components.cpu.setPostBootRomRegisters();
+    components.bus.setPostBootRomRegisters();
+    components.ppu->setPostBootRomRegisters();
+
+    const auto start{std::chrono::steady_clock::now()};
+
+    while (components.cpu.getRetiredInstructions() < instructions)
+    {
+        components.cpu.runInstruction();
+    }
+
+    const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+    const auto                          retired{components.cpu.getRetiredInstructions()};
+
+    if (traceWriter != nullptr)
+    {
+        traceWriter->stop();
+    }
+
+    std::cout << romPath << " (" << backend << ", " << accuracy << " accuracy)" << '\n';
+    std::cout << retired << " instructions in " << elapsed.count() << " s: "
+              << static_cast<double>(retired) / elapsed.count() / 1e6 << " MIPS" << '\n';
+
+    if (skipIdleLoops)
+    {
+        std::cout << components.cpu.getSkippedMachineCycles() << " machine cycles skipped in idle loops" << '\n';
+    }
+
+    if (!tracePath.empty())
+    {
+        std::cout << trace.getDropped() << " accesses dropped from the trace" << '\n';
+        if (traceWriter->hasFailed())
+        {
+            std::cerr << "Failed to write the trace to " << tracePath << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
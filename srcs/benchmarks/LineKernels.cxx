@@ -0,0 +1,172 @@
+//
+// Measures the throughput of the PPU line kernels for each supported instruction set: the tile row decoding and the
+// pixel mixing on their own, then whole frames drawn by the PPU.
+//
+// Usage: gbemu_bench_ppu [lines] [frames]
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Common.hxx"
+#include "HeadlessRenderer.hxx"
+#include "graphics/LineKernels.hxx"
+#include "graphics/Tile.hxx"
+#include "hardware/PPU.hxx"
+#include "hardware/Scheduler.hxx"
+
+namespace
+{
+    using InstructionSet = Graphics::LineKernels::InstructionSet;
+
+    constexpr std::size_t          TILES_PER_LINE{21};
+    constexpr Scheduler::Timestamp MACHINE_CYCLES_PER_FRAME{154 * 114};
+
+    /**
+     * @brief Stands for the rest of the bus, which the PPU only reaches to request interrupts.
+     */
+    class NullBus final : public IAddressable
+    {
+      public:
+        [[nodiscard]] uint8_t read(const uint16_t address) const override
+        {
+            (void) address;
+            return 0;
+        }
+
+        void write(const uint16_t address, const uint8_t value) override
+        {
+            (void) address;
+            (void) value;
+        }
+
+        [[nodiscard]] AddressableRange getAddressableRange() const noexcept override
+        {
+            return {};
+        }
+    };
+
+    const char* getName(const InstructionSet instructionSet)
+    {
+        switch (instructionSet)
+        {
+            case InstructionSet::SSE2:
+                return "sse2";
+            case InstructionSet::AVX2:
+                return "avx2";
+            default:
+                return "scalar";
+        }
+    }
+
+    template <typename Function>
+    double measure(const std::size_t iterations, Function function)
+    {
+        const auto start{std::chrono::steady_clock::now()};
+
+        for (std::size_t iteration{0}; iteration < iterations; ++iteration)
+        {
+            function(iteration);
+        }
+
+        const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+
+        return elapsed.count();
+    }
+}  // namespace
+
+int main(const int argc, char* argv[])
+{
+    const std::size_t lines{argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000ULL};
+    const std::size_t frames{argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2'000ULL};
+
+    std::mt19937                            generator{0x6B656D75};
+    std::uniform_int_distribution<unsigned> distribution{0x00, 0xFF};
+
+    const auto random{[&](const uint8_t mask = 0xFF) { return static_cast<uint8_t>(distribution(generator) & mask); }};
+
+    /* A few distinct lines, so that the kernels do not work on the very same data over and over. */
+    constexpr std::size_t        SAMPLES{64};
+    std::vector<uint8_t>         bitplanes(SAMPLES * 2 * TILES_PER_LINE);
+    std::vector<uint8_t>         background(SAMPLES * Graphics::LINE_WIDTH);
+    std::vector<uint8_t>         objects(SAMPLES * Graphics::LINE_WIDTH);
+    std::vector<uint8_t>         pixels(TILES_PER_LINE * Graphics::TILE_SIZE);
+    std::vector<Graphics::Pixel> line(Graphics::LINE_WIDTH);
+    std::vector<uint8_t>         videoRam(0x2000);
+    std::vector<uint8_t>         oam(0xA0);
+
+    for (auto& byte : bitplanes)
+    {
+        byte = random();
+    }
+    for (std::size_t x{0}; x < background.size(); ++x)
+    {
+        background[x] = random(0x07);
+        objects[x]    = random(0x1F);
+    }
+    for (auto& byte : videoRam)
+    {
+        byte = random();
+    }
+    for (auto& byte : oam)
+    {
+        byte = random();
+    }
+
+    for (const auto instructionSet : {InstructionSet::SCALAR, InstructionSet::SSE2, InstructionSet::AVX2})
+    {
+        if (!Graphics::LineKernels::isSupported(instructionSet))
+        {
+            std::cout << getName(instructionSet) << ": not supported" << '\n';
+            continue;
+        }
+
+        const auto& kernels{Graphics::LineKernels::get(instructionSet)};
+
+        const auto decodeTime{measure(lines, [&](const std::size_t iteration)
+        {
+            kernels.decodeTileRows(&bitplanes[iteration % SAMPLES * 2 * TILES_PER_LINE], TILES_PER_LINE,
+                                   pixels.data());
+        })};
+        const auto mixTime{measure(lines, [&](const std::size_t iteration)
+        {
+            const auto offset{iteration % SAMPLES * Graphics::LINE_WIDTH};
+
+            kernels.mixLine(&background[offset], &objects[offset], {0xE4, 0xD2, 0x1B}, line.data());
+        })};
+
+        Scheduler                         scheduler{};
+        NullBus                           bus{};
+        HeadlessRenderer                  renderer{};
+        BasicPPU<PPU::Accuracy::SCANLINE> ppu{bus, renderer, scheduler};
+
+        ppu.setInstructionSet(instructionSet);
+        for (std::size_t address{0}; address < videoRam.size(); ++address)
+        {
+            ppu.write(static_cast<uint16_t>(MemoryMap::VIDEO_RAM.first + address), videoRam[address]);
+        }
+        for (std::size_t address{0}; address < oam.size(); ++address)
+        {
+            ppu.write(static_cast<uint16_t>(MemoryMap::OAM.first + address), oam[address]);
+        }
+        ppu.write(MemoryMap::IORegisters::SCX, 0x03);
+        ppu.write(MemoryMap::IORegisters::WY, 0x40);
+        ppu.write(MemoryMap::IORegisters::WX, 0x57);
+        ppu.write(MemoryMap::IORegisters::BGP, 0xE4);
+        ppu.write(MemoryMap::IORegisters::LCDC, 0xF3);
+
+        const auto frameTime{measure(frames * MACHINE_CYCLES_PER_FRAME, [&](const std::size_t) { scheduler.tick(); })};
+
+        std::cout << getName(instructionSet) << ":" << '\n';
+        std::cout << "  decode " << static_cast<double>(lines * TILES_PER_LINE) / decodeTime / 1e6
+                  << " M tile rows/s" << '\n';
+        std::cout << "  mix    " << static_cast<double>(lines) / mixTime / 1e6 << " M lines/s" << '\n';
+        std::cout << "  frames " << static_cast<double>(renderer.getFrameCount()) / frameTime << " frames/s"
+                  << '\n';
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,303 @@
+#include "graphics/LineKernels.hxx"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#include "graphics/Tile.hxx"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define GBEMU_X86_KERNELS_SUPPORTED
+#include <immintrin.h>
+#endif
+
+namespace Graphics
+{
+    namespace
+    {
+        constexpr uint8_t OBJECT_TYPE{PixelType::Object << 2};
+
+        void decodeTileRowsScalar(const uint8_t* bitplanes, const std::size_t count, uint8_t* pixels)
+        {
+            for (std::size_t tile{0}; tile < count; ++tile)
+            {
+                const auto tileRow{decodeTileRow(bitplanes[2 * tile], bitplanes[2 * tile + 1])};
+
+                std::memcpy(pixels + TILE_SIZE * tile, tileRow.data(), tileRow.size());
+            }
+        }
+
+        void mixLineScalar(const uint8_t* background, const uint8_t* objects, const Palettes palettes, Pixel* line)
+        {
+            for (std::size_t x{0}; x < LINE_WIDTH; ++x)
+            {
+                const uint8_t backgroundColor{static_cast<uint8_t>(background[x] & 0b11)};
+                const uint8_t objectColor{static_cast<uint8_t>(objects[x] & ObjectPixel::Color)};
+                const bool    isObjectDrawn{(objects[x] & ObjectPixel::Present) != 0 &&
+                                         ((objects[x] & ObjectPixel::Priority) != 0 ? backgroundColor == 0
+                                                                                     : objectColor != 0)};
+
+                if (isObjectDrawn)
+                {
+                    const auto palette{(objects[x] & ObjectPixel::Palette) != 0 ? palettes.OBP1 : palettes.OBP0};
+
+                    line[x] = static_cast<Pixel>(getRealColorIndexFromPaletteRegister(objectColor, palette) |
+                                                 OBJECT_TYPE);
+                }
+                else
+                {
+                    line[x] = static_cast<Pixel>(getRealColorIndexFromPaletteRegister(backgroundColor, palettes.BGP) |
+                                                 (background[x] & 0b1100));
+                }
+            }
+        }
+
+#ifdef GBEMU_X86_KERNELS_SUPPORTED
+        /**
+         * @brief Bit 7 to bit 0, the bit of each pixel of a tile row in its bitplanes, for two tile rows.
+         */
+        __m128i getPixelBitsSse2()
+        {
+            return _mm_setr_epi8(static_cast<char>(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+                                 static_cast<char>(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+        }
+
+        /**
+         * @brief Map 16 color indices through a palette register, one index at a time.
+         */
+        __m128i mapPaletteSse2(const __m128i colors, const uint8_t palette)
+        {
+            __m128i mapped{_mm_setzero_si128()};
+
+            for (uint8_t color{0}; color < 4; ++color)
+            {
+                const auto isColor{_mm_cmpeq_epi8(colors, _mm_set1_epi8(static_cast<char>(color)))};
+                const auto value{
+                    _mm_set1_epi8(static_cast<char>(getRealColorIndexFromPaletteRegister(color, palette)))};
+
+                mapped = _mm_or_si128(mapped, _mm_and_si128(isColor, value));
+            }
+
+            return mapped;
+        }
+
+        __m128i hasFlagSse2(const __m128i objectPixels, const uint8_t flag)
+        {
+            const auto mask{_mm_set1_epi8(static_cast<char>(flag))};
+
+            return _mm_cmpeq_epi8(_mm_and_si128(objectPixels, mask), mask);
+        }
+
+        void decodeTileRowsSse2(const uint8_t* bitplanes, const std::size_t count, uint8_t* pixels)
+        {
+            const auto  pixelBits{getPixelBitsSse2()};
+            const auto  ones{_mm_set1_epi8(1)};
+            std::size_t tile{0};
+
+            /* Two tile rows at a time: each bitplane byte is broadcast to the 8 bytes of its pixels. */
+            for (; tile + 2 <= count; tile += 2)
+            {
+                int32_t packed{};
+
+                std::memcpy(&packed, bitplanes + 2 * tile, sizeof(packed));
+
+                auto bytes{_mm_cvtsi32_si128(packed)};
+
+                bytes = _mm_unpacklo_epi8(bytes, bytes);
+                bytes = _mm_unpacklo_epi16(bytes, bytes);
+
+                const auto lows{_mm_shuffle_epi32(bytes, _MM_SHUFFLE(2, 2, 0, 0))};
+                const auto highs{_mm_shuffle_epi32(bytes, _MM_SHUFFLE(3, 3, 1, 1))};
+                const auto lowBits{_mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(lows, pixelBits), pixelBits), ones)};
+                const auto highBits{_mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(highs, pixelBits), pixelBits), ones)};
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + TILE_SIZE * tile),
+                                 _mm_or_si128(lowBits, _mm_add_epi8(highBits, highBits)));
+            }
+
+            decodeTileRowsScalar(bitplanes + 2 * tile, count - tile, pixels + TILE_SIZE * tile);
+        }
+
+        void mixLineSse2(const uint8_t* background, const uint8_t* objects, const Palettes palettes, Pixel* line)
+        {
+            const auto zero{_mm_setzero_si128()};
+            const auto allSet{_mm_cmpeq_epi8(zero, zero)};
+
+            for (std::size_t x{0}; x < LINE_WIDTH; x += 16)
+            {
+                const auto backgroundPixels{_mm_loadu_si128(reinterpret_cast<const __m128i*>(background + x))};
+                const auto objectPixels{_mm_loadu_si128(reinterpret_cast<const __m128i*>(objects + x))};
+                const auto backgroundColors{_mm_and_si128(backgroundPixels, _mm_set1_epi8(0b11))};
+                const auto objectColors{_mm_and_si128(objectPixels, _mm_set1_epi8(ObjectPixel::Color))};
+
+                /* Priority objects show through background color 0, others through their own color 0. */
+                const auto hasPriority{hasFlagSse2(objectPixels, ObjectPixel::Priority)};
+                const auto isObjectDrawn{_mm_and_si128(
+                    hasFlagSse2(objectPixels, ObjectPixel::Present),
+                    _mm_or_si128(_mm_and_si128(hasPriority, _mm_cmpeq_epi8(backgroundColors, zero)),
+                                 _mm_andnot_si128(_mm_or_si128(hasPriority, _mm_cmpeq_epi8(objectColors, zero)),
+                                                  allSet)))};
+
+                const auto usesObp1{hasFlagSse2(objectPixels, ObjectPixel::Palette)};
+                const auto objectOutput{
+                    _mm_or_si128(_mm_or_si128(_mm_and_si128(usesObp1, mapPaletteSse2(objectColors, palettes.OBP1)),
+                                              _mm_andnot_si128(usesObp1, mapPaletteSse2(objectColors, palettes.OBP0))),
+                                 _mm_set1_epi8(OBJECT_TYPE))};
+                const auto backgroundOutput{_mm_or_si128(mapPaletteSse2(backgroundColors, palettes.BGP),
+                                                         _mm_and_si128(backgroundPixels, _mm_set1_epi8(0b1100)))};
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(line + x),
+                                 _mm_or_si128(_mm_and_si128(isObjectDrawn, objectOutput),
+                                              _mm_andnot_si128(isObjectDrawn, backgroundOutput)));
+            }
+        }
+
+        __attribute__((target("avx2"))) __m256i hasFlagAvx2(const __m256i objectPixels, const uint8_t flag)
+        {
+            const auto mask{_mm256_set1_epi8(static_cast<char>(flag))};
+
+            return _mm256_cmpeq_epi8(_mm256_and_si256(objectPixels, mask), mask);
+        }
+
+        __attribute__((target("avx2"))) void decodeTileRowsAvx2(const uint8_t* bitplanes, const std::size_t count,
+                                                                uint8_t* pixels)
+        {
+            /* pshufb shuffles within 128-bit lanes: each lane gets a copy of the 4 tile rows, and picks 2 of them. */
+            const auto  lowIndices{_mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2,  //
+                                                    4, 4, 4, 4, 4, 4, 4, 4, 6, 6, 6, 6, 6, 6, 6, 6)};
+            const auto  highIndices{_mm256_add_epi8(lowIndices, _mm256_set1_epi8(1))};
+            const auto  pixelBits{_mm256_broadcastsi128_si256(getPixelBitsSse2())};
+            const auto  ones{_mm256_set1_epi8(1)};
+            std::size_t tile{0};
+
+            for (; tile + 4 <= count; tile += 4)
+            {
+                int64_t packed{};
+
+                std::memcpy(&packed, bitplanes + 2 * tile, sizeof(packed));
+
+                const auto bytes{_mm256_set1_epi64x(packed)};
+                const auto lows{_mm256_shuffle_epi8(bytes, lowIndices)};
+                const auto highs{_mm256_shuffle_epi8(bytes, highIndices)};
+                const auto lowBits{
+                    _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(lows, pixelBits), pixelBits), ones)};
+                const auto highBits{
+                    _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(highs, pixelBits), pixelBits), ones)};
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + TILE_SIZE * tile),
+                                    _mm256_or_si256(lowBits, _mm256_add_epi8(highBits, highBits)));
+            }
+
+            decodeTileRowsSse2(bitplanes + 2 * tile, count - tile, pixels + TILE_SIZE * tile);
+        }
+
+        __attribute__((target("avx2"))) void mixLineAvx2(const uint8_t* background, const uint8_t* objects,
+                                                         const Palettes palettes, Pixel* line)
+        {
+            std::array<uint8_t, 16> backgroundTable{};
+            std::array<uint8_t, 16> objectTable{};
+
+            /* Background pixels index their table with their type and color, objects with their palette and color. */
+            for (uint8_t index{0}; index < 16; ++index)
+            {
+                backgroundTable[index] = static_cast<uint8_t>(
+                    getRealColorIndexFromPaletteRegister(index & 0b11, palettes.BGP) | (index & 0b1100));
+                objectTable[index] = static_cast<uint8_t>(
+                    getRealColorIndexFromPaletteRegister(index & 0b11,
+                                                         (index & ObjectPixel::Palette) != 0 ? palettes.OBP1
+                                                                                             : palettes.OBP0) |
+                    OBJECT_TYPE);
+            }
+
+            const auto backgroundLookup{
+                _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(backgroundTable.data())))};
+            const auto objectLookup{
+                _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(objectTable.data())))};
+            const auto zero{_mm256_setzero_si256()};
+            const auto allSet{_mm256_cmpeq_epi8(zero, zero)};
+
+            for (std::size_t x{0}; x < LINE_WIDTH; x += 32)
+            {
+                const auto backgroundPixels{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(background + x))};
+                const auto objectPixels{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(objects + x))};
+                const auto backgroundColors{_mm256_and_si256(backgroundPixels, _mm256_set1_epi8(0b11))};
+                const auto objectColors{_mm256_and_si256(objectPixels, _mm256_set1_epi8(ObjectPixel::Color))};
+
+                const auto hasPriority{hasFlagAvx2(objectPixels, ObjectPixel::Priority)};
+                const auto isObjectDrawn{_mm256_and_si256(
+                    hasFlagAvx2(objectPixels, ObjectPixel::Present),
+                    _mm256_or_si256(_mm256_and_si256(hasPriority, _mm256_cmpeq_epi8(backgroundColors, zero)),
+                                    _mm256_andnot_si256(
+                                        _mm256_or_si256(hasPriority, _mm256_cmpeq_epi8(objectColors, zero)), allSet)))};
+
+                const auto objectOutput{_mm256_shuffle_epi8(
+                    objectLookup,
+                    _mm256_and_si256(objectPixels, _mm256_set1_epi8(ObjectPixel::Palette | ObjectPixel::Color)))};
+                const auto backgroundOutput{
+                    _mm256_shuffle_epi8(backgroundLookup, _mm256_and_si256(backgroundPixels, _mm256_set1_epi8(0x0F)))};
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(line + x),
+                                    _mm256_blendv_epi8(backgroundOutput, objectOutput, isObjectDrawn));
+            }
+        }
+#endif
+
+        constexpr LineKernels SCALAR_KERNELS{decodeTileRowsScalar, mixLineScalar};
+#ifdef GBEMU_X86_KERNELS_SUPPORTED
+        constexpr LineKernels SSE2_KERNELS{decodeTileRowsSse2, mixLineSse2};
+        constexpr LineKernels AVX2_KERNELS{decodeTileRowsAvx2, mixLineAvx2};
+#endif
+    }  // namespace
+
+    const LineKernels& LineKernels::get(const InstructionSet instructionSet)
+    {
+        if (!isSupported(instructionSet))
+        {
+            throw std::logic_error("Unsupported instruction set");
+        }
+
+        switch (instructionSet)
+        {
+#ifdef GBEMU_X86_KERNELS_SUPPORTED
+            case InstructionSet::SSE2:
+                return SSE2_KERNELS;
+            case InstructionSet::AVX2:
+                return AVX2_KERNELS;
+#endif
+            default:
+                return SCALAR_KERNELS;
+        }
+    }
+
+    bool LineKernels::isSupported(const InstructionSet instructionSet) noexcept
+    {
+        switch (instructionSet)
+        {
+            case InstructionSet::SCALAR:
+                return true;
+#ifdef GBEMU_X86_KERNELS_SUPPORTED
+            case InstructionSet::SSE2:
+                /* Part of the x86-64 baseline. */
+                return true;
+            case InstructionSet::AVX2:
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("avx2") != 0;
+#endif
+            default:
+                return false;
+        }
+    }
+
+    LineKernels::InstructionSet LineKernels::getBestInstructionSet() noexcept
+    {
+        for (const auto instructionSet : {InstructionSet::AVX2, InstructionSet::SSE2})
+        {
+            if (isSupported(instructionSet))
+            {
+                return instructionSet;
+            }
+        }
+
+        return InstructionSet::SCALAR;
+    }
+}  // namespace Graphics
@@ -0,0 +1,62 @@
+#include "graphics/TileCache.hxx"
+
+#include <algorithm>
+
+namespace Graphics
+{
+    TileCache::TileCache()
+    {
+        _invalidRows.set();
+    }
+
+    void TileCache::invalidate(const uint16_t offset) noexcept
+    {
+        if (offset < TILE_DATA_SIZE)
+        {
+            _invalidRows.set(offset / 2);
+        }
+    }
+
+    void TileCache::update(const TileData tileData, const LineKernels& kernels)
+    {
+        if (_invalidRows.none())
+        {
+            return;
+        }
+
+        for (std::size_t row{0}; row < ROW_COUNT;)
+        {
+            if (!_invalidRows.test(row))
+            {
+                ++row;
+                continue;
+            }
+
+            auto end{row + 1};
+
+            while (end < ROW_COUNT && _invalidRows.test(end))
+            {
+                ++end;
+            }
+
+            kernels.decodeTileRows(&tileData[2 * row], end - row, &_pixels[TILE_SIZE * row]);
+
+            for (auto flipped{row}; flipped < end; ++flipped)
+            {
+                std::ranges::reverse_copy(std::span{_pixels}.subspan(TILE_SIZE * flipped, TILE_SIZE),
+                                          &_flippedPixels[TILE_SIZE * flipped]);
+            }
+
+            row = end;
+        }
+
+        _invalidRows.reset();
+    }
+
+    TileCache::Row TileCache::getRow(const std::size_t tile, const std::size_t row, const bool xFlip) const noexcept
+    {
+        const auto& pixels{xFlip ? _flippedPixels : _pixels};
+
+        return Row{pixels.data() + TILE_SIZE * (TILE_SIZE * tile + row), TILE_SIZE};
+    }
+}  // namespace Graphics
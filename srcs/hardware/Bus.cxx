@@ -4,13 +4,35 @@
 
 #include "hardware/Bus.hxx"
 
-#include <format>
+#include <algorithm>
+#include <cstring>
 #include <utility>
 
 #include "Common.hxx"
 #include "Utils.hxx"
 
-Bus::Bus(const EmulationState& emulationState) : _emulationState(emulationState) {}
+namespace
+{
+    constexpr auto OPEN_BUS_PAGE{[]
+    {
+        std::array<uint8_t, 0x100> page{};
+
+        page.fill(0xFF);
+        return page;
+    }()};
+}  // namespace
+
+Bus::Bus(const EmulationState& emulationState) : _emulationState(emulationState)
+{
+    for (std::size_t page{0}; page < PAGE_COUNT; ++page)
+    {
+        _tables[false][page].handler = &_openBus;
+        remapPage(page);
+        updateOamDmaPage(page);
+    }
+
+    attach(_bootRomRegister);
+}
 
 void Bus::loadBootRom(const std::array<uint8_t, 256>& bootRom) noexcept
 {
@@ -25,18 +47,7 @@ IAddressable::AddressableRange Bus::getAddressableRange() const noexcept
 void Bus::setPostBootRomRegisters()
 {
     _bootRomMapped = 1;
-}
-
-std::array<uint8_t, 0x10000> Bus::getAddressSpace() const noexcept
-{
-    std::array<uint8_t, 0x10000> snapshot{};
-
-    for (auto i = 0ULL; i < _memoryMap.size(); i++)
-    {
-        snapshot[i] = read(i);
-    }
-
-    return snapshot;
+    remapPage(0);
 }
 
 /**
@@ -53,80 +64,253 @@ void Bus::attach(IAddressable& addressable)
 {
     for (const auto& range : addressable.getAddressableRange())
     {
-        if (const auto memoryLocation{std::get_if<uint16_t>(&range)}; memoryLocation)
-        {
-            if (_memoryMap[*memoryLocation] == nullptr)
-            {
-                _memoryMap[*memoryLocation] = &addressable;
-            }
-        }
-        else if (const auto memoryRange{std::get_if<AddressRange>(&range)}; memoryRange)
+        const auto [first, last]{std::holds_alternative<uint16_t>(range)
+                                     ? AddressRange{std::get<uint16_t>(range), std::get<uint16_t>(range)}
+                                     : std::get<AddressRange>(range)};
+
+        for (std::size_t page{first / PAGE_SIZE}; page <= last / PAGE_SIZE; ++page)
         {
-            for (std::size_t address = memoryRange->first; address <= memoryRange->second; ++address)
+            auto handlers{getPageHandlers(_tables[false][page])};
+
+            for (std::size_t address{std::max(page * PAGE_SIZE, std::size_t{first})};
+                 address <= std::min(page * PAGE_SIZE + PAGE_SIZE - 1, std::size_t{last}); ++address)
             {
-                if (_memoryMap[address] == nullptr)
+                if (handlers[address % PAGE_SIZE] == &_openBus)
                 {
-                    _memoryMap[address] = &addressable;
+                    handlers[address % PAGE_SIZE] = &addressable;
                 }
             }
+
+            setPageHandlers(_tables[false][page], handlers);
+            remapPage(page);
+            updateOamDmaPage(page);
         }
     }
 }
 
-void Bus::write(const uint16_t address, const uint8_t value)
+void Bus::remap(const AddressRange range)
 {
-    if (_emulationState.isInOamDma)
+    for (std::size_t page{range.first / PAGE_SIZE}; page <= range.second / PAGE_SIZE; ++page)
     {
-        if (!Utils::addressIn(address, MemoryMap::HIGH_RAM))
+        remapPage(page);
+    }
+}
+
+std::size_t Bus::getOpenBusAccesses() const noexcept
+{
+    return _openBus.getAccesses();
+}
+
+void Bus::takeSnapshot(AddressSpaceSnapshot& snapshot, const AddressSpaceSnapshot::Mode mode)
+{
+    const auto&                            pages{_tables[false]};
+    std::array<const uint8_t*, PAGE_COUNT> writtenMemory{};
+    std::size_t                            writtenPages{0};
+
+    /* A page may alias the memory of another one, as echo RAM does: look for written pages by their host memory. */
+    for (std::size_t page{0}; page < PAGE_COUNT; ++page)
+    {
+        if (pages[page].read != nullptr && _writeGenerations[page] == _generation)
         {
-            return;
+            writtenMemory[writtenPages++] = pages[page].read;
         }
     }
 
-    if (Utils::addressIn(address, MemoryMap::BOOT_ROM) && !_bootRomMapped)
+    for (std::size_t page{0}; page < PAGE_COUNT; ++page)
     {
-        _bootRom[address] = value;
-        return;
+        const auto& entry{pages[page]};
+        auto* const memory{snapshot.memory.data() + page * PAGE_SIZE};
+
+        /* Pages without host memory belong to handlers whose content may change on its own, such as LY or DIV. */
+        if (mode == AddressSpaceSnapshot::Mode::INCREMENTAL && entry.read != nullptr &&
+            std::ranges::find(writtenMemory.begin(), writtenMemory.begin() + writtenPages, entry.read) ==
+                writtenMemory.begin() + writtenPages)
+        {
+            snapshot.dirtyPages.reset(page);
+            continue;
+        }
+
+        snapshot.dirtyPages.set(page);
+
+        if (entry.read != nullptr)
+        {
+            std::memcpy(memory, entry.read, PAGE_SIZE);
+            continue;
+        }
+
+        for (std::size_t offset{0}; offset < PAGE_SIZE; ++offset)
+        {
+            const auto address{static_cast<uint16_t>(page * PAGE_SIZE + offset)};
+
+            memory[offset] = getHandler(entry, address)->peek(address);
+        }
     }
 
-    if (address == MemoryMap::IORegisters::BOOTM)
+    _generation += 1;
+}
+
+Bus::PageHandlers Bus::getPageHandlers(const Page& page)
+{
+    PageHandlers handlers{};
+
+    if (page.handlers != nullptr)
     {
-        _bootRomMapped = value;
-        return;
+        handlers = *page.handlers;
     }
-
-    if (_memoryMap[address] == nullptr)
+    else
     {
-        throw std::logic_error{std::format("Cannot perform bus write at {:#04x}.", address)};
+        handlers.fill(page.handler);
     }
 
-    _memoryMap[address]->write(address, value);
+    return handlers;
 }
 
-uint8_t Bus::read(const uint16_t address) const
+void Bus::setPageHandlers(Page& page, const PageHandlers& handlers)
 {
-    if (_emulationState.isInOamDma)
+    /* Only a page owned by a single handler can be backed by its host memory. */
+    if (std::ranges::all_of(handlers, [&](const auto* handler) { return handler == handlers.front(); }))
     {
-        if (!Utils::addressIn(address, MemoryMap::HIGH_RAM))
-        {
-            return 0xFF;
-        }
+        page.handler = handlers.front();
+        page.handlers.reset();
+    }
+    else
+    {
+        page.handler  = nullptr;
+        page.handlers = std::make_unique<PageHandlers>(handlers);
     }
+}
+
+IAddressable* Bus::getHandler(const Page& page, const uint16_t address) noexcept
+{
+    return page.handlers != nullptr ? (*page.handlers)[address % PAGE_SIZE] : page.handler;
+}
+
+void Bus::remapPage(const std::size_t page)
+{
+    auto&          entry{_tables[false][page]};
+    const uint16_t address{static_cast<uint16_t>(page * PAGE_SIZE)};
+
+    _writeGenerations[page] = _generation;
 
     if (Utils::addressIn(address, MemoryMap::BOOT_ROM) && !_bootRomMapped)
     {
-        return _bootRom[address];
+        entry.read  = _bootRom.data();
+        entry.write = _bootRom.data();
+        return;
     }
 
-    if (address == MemoryMap::IORegisters::BOOTM)
+    entry.read  = entry.handler != nullptr ? entry.handler->getReadablePage(address) : nullptr;
+    entry.write = entry.handler != nullptr ? entry.handler->getWritablePage(address) : nullptr;
+}
+
+void Bus::updateOamDmaPage(const std::size_t page)
+{
+    auto&          entry{_tables[true][page]};
+    const uint16_t first{static_cast<uint16_t>(page * PAGE_SIZE)};
+    const uint16_t last{static_cast<uint16_t>(first + PAGE_SIZE - 1)};
+
+    if (last < MemoryMap::HIGH_RAM.first || first > MemoryMap::HIGH_RAM.second)
     {
-        return _bootRomMapped;
+        entry.read    = OPEN_BUS_PAGE.data();
+        entry.write   = _discardedWrites.data();
+        entry.handler = &_lockedOut;
+        entry.handlers.reset();
+        return;
     }
 
-    if (_memoryMap[address] == nullptr)
+    auto handlers{getPageHandlers(_tables[false][page])};
+
+    for (std::size_t offset{0}; offset < PAGE_SIZE; ++offset)
     {
-        throw std::logic_error{std::format("Cannot perform bus read at {:#04x}.", address)};
+        if (!Utils::addressIn(static_cast<uint16_t>(first + offset), MemoryMap::HIGH_RAM))
+        {
+            handlers[offset] = &_lockedOut;
+        }
     }
 
-    return _memoryMap[address]->read(address);
-}
\ No newline at end of file
+    entry.read  = nullptr;
+    entry.write = nullptr;
+    setPageHandlers(entry, handlers);
+}
+
+void Bus::write(const uint16_t address, const uint8_t value)
+{
+    const auto& page{_tables[_emulationState.isInOamDma][address / PAGE_SIZE]};
+
+    _writeGenerations[address / PAGE_SIZE] = _generation;
+
+    if (page.write != nullptr) [[likely]]
+    {
+        page.write[address % PAGE_SIZE] = value;
+        return;
+    }
+
+    getHandler(page, address)->write(address, value);
+}
+
+uint8_t Bus::read(const uint16_t address) const
+{
+    const auto& page{_tables[_emulationState.isInOamDma][address / PAGE_SIZE]};
+
+    if (page.read != nullptr) [[likely]]
+    {
+        return page.read[address % PAGE_SIZE];
+    }
+
+    return getHandler(page, address)->read(address);
+}
+
+uint8_t Bus::OpenBus::read(const uint16_t address) const
+{
+    (void) address;
+
+    _accesses += 1;
+    return 0xFF;
+}
+
+void Bus::OpenBus::write(const uint16_t address, const uint8_t value)
+{
+    (void) address;
+    (void) value;
+
+    _accesses += 1;
+}
+
+uint8_t Bus::OpenBus::peek(const uint16_t address) const
+{
+    (void) address;
+
+    return 0xFF;
+}
+
+IAddressable::AddressableRange Bus::OpenBus::getAddressableRange() const noexcept
+{
+    return {};
+}
+
+std::size_t Bus::OpenBus::getAccesses() const noexcept
+{
+    return _accesses;
+}
+
+Bus::BootRomRegister::BootRomRegister(Bus& bus) : _bus(bus) {}
+
+uint8_t Bus::BootRomRegister::read(const uint16_t address) const
+{
+    (void) address;
+
+    return _bus._bootRomMapped;
+}
+
+void Bus::BootRomRegister::write(const uint16_t address, const uint8_t value)
+{
+    (void) address;
+
+    _bus._bootRomMapped = value;
+    _bus.remapPage(0);
+}
+
+IAddressable::AddressableRange Bus::BootRomRegister::getAddressableRange() const noexcept
+{
+    return {MemoryMap::IORegisters::BOOTM};
+}
@@ -3,7 +3,8 @@
 
 #include "../../includes/hardware/Cartridge.hxx"
 
-#include <fstream>
+#include <algorithm>
+#include <format>
 #include <iostream>
 #include <string_view>
 #include <unordered_map>
@@ -225,44 +226,63 @@ static const std::unordered_map<std::string_view, std::string_view> new_licensee
     {"DK", "Kodansha"},
 }};
 
-void Cartridge::load(const std::filesystem::path& path)
+namespace
 {
-    if (!std::filesystem::is_regular_file(path))
+    /**
+     * @brief Mapped in place of the ROM until a cartridge is loaded.
+     */
+    constexpr auto UNMAPPED_ROM_BANK{[]
     {
-        throw std::runtime_error(std::format("File {} does not exist or is not a regular file.", path.string()));
-    }
+        std::array<uint8_t, 0x4000> bank{};
 
-    const auto    cartridgeSize{std::filesystem::file_size(path)};
-    std::ifstream input{path, std::ios::binary};
+        bank.fill(0xFF);
+        return bank;
+    }()};
 
-    input.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    /**
+     * @brief External RAM size, indexed by the RAM size byte of the header.
+     */
+    constexpr std::array<std::size_t, 6> RAM_SIZES{0, 0x800, 0x2000, 0x8000, 0x20000, 0x10000};
 
-    if (cartridgeSize < 2 << 14)
-    {
-        throw std::runtime_error(std::format("Cartridge size ({:#010x}) is too small.", cartridgeSize));
-    }
+    /**
+     * @brief Offset of the Nintendo logo, which every game on a multicart has in its first bank.
+     */
+    constexpr std::size_t LOGO_OFFSET{0x0104};
+    constexpr std::size_t LOGO_SIZE{0x30};
+}  // namespace
+
+Cartridge::Cartridge(EmulationState& emulationState, const Scheduler& scheduler)
+    : _emulationState(emulationState), _realTimeClock(scheduler)
+{
+    _romWindows.fill(UNMAPPED_ROM_BANK.data());
+}
+
+Cartridge::~Cartridge()
+{
+    detachSave();
+}
 
-    input.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    content.resize(cartridgeSize);
-    input.read(reinterpret_cast<char*>(content.data()), static_cast<std::streamsize>(cartridgeSize));
+void Cartridge::load(const std::filesystem::path& path)
+{
+    detachSave();
+    _image  = RomImage::open(path);
+    content = _image->getData();
 
-    const auto title        = reinterpret_cast<const char*>(&content[0x0134]);
-    const auto new_licensee = reinterpret_cast<const char*>(&content[0x0144]);
-    const auto old_licensee = content[0x014B];
-    const auto type         = content[0x0147];
-    const auto rom_size     = content[0x0149];
+    const auto& header{_image->getHeader()};
+    const auto  type{header.type};
+    const auto  ram_size{header.ramSize};
 
-    this->title    = std::string_view{title, 16};
-    this->rom_size = (2 << 14) * (1 << rom_size);
+    this->title    = header.title;
+    this->rom_size = (2 << 14) * (1 << header.romSize);
     try
     {
-        if (old_licensee == 0x33)
+        if (header.oldLicensee == 0x33)
         {
-            this->licensee = new_licensee_code.at(std::string_view{new_licensee, 2});
+            this->licensee = new_licensee_code.at(header.newLicensee);
         }
         else
         {
-            this->licensee = old_licensee_code.at(old_licensee);
+            this->licensee = old_licensee_code.at(header.oldLicensee);
         }
     }
     catch (const std::out_of_range& e)
@@ -270,30 +290,391 @@ void Cartridge::load(const std::filesystem::path& path)
         this->licensee = "Unknown";
     }
 
-    switch (type)
+    switch (static_cast<Type>(type))
     {
-        case std::to_underlying<Type>(Type::ROM_ONLY):
-            this->type = static_cast<Type>(type);
+        using enum Type;
+
+        case ROM_ONLY:
+        case ROM_RAM:
+        case ROM_RAM_BATTERY:
+            _controller = Controller::NONE;
+            break;
+        case MBC1:
+        case MBC1_RAM:
+        case MBC1_RAM_BATTERY:
+            _controller = Controller::MBC1;
+            break;
+        case MBC2:
+        case MBC2_BATTERY:
+            _controller = Controller::MBC2;
+            break;
+        case MBC3_TIMER_BATTERY:
+        case MBC3_TIMER_RAM_BATTERY:
+        case MBC3:
+        case MBC3_RAM:
+        case MBC3_RAM_BATTERY:
+            _controller = Controller::MBC3;
+            break;
+        case MBC5:
+        case MBC5_RAM:
+        case MBC5_RAM_BATTERY:
+        case MBC5_RUMBLE:
+        case MBC5_RUMBLE_RAM:
+        case MBC5_RUMBLE_RAM_BATTERY:
+            _controller = Controller::MBC5;
             break;
         default:
             throw std::runtime_error(std::format("Cartridge type ({:#04x}) not supported.", type));
     }
+
+    this->type = static_cast<Type>(type);
+
+    /* MBC2 has 512 half-bytes built in. Smaller RAMs are mapped as a whole bank, without mirroring. */
+    if (_controller == Controller::MBC2)
+    {
+        _ramStorage.assign(0x200, 0xFF);
+    }
+    else if (ram_size < RAM_SIZES.size() && RAM_SIZES[ram_size] != 0)
+    {
+        _ramStorage.assign(std::max(RAM_SIZES[ram_size], RAM_BANK_SIZE), 0xFF);
+    }
+    else
+    {
+        _ramStorage.clear();
+    }
+    _ram = _ramStorage;
+
+    /* 8 Mbit MBC1 multicarts hold four games of 2 Mbit, each starting with its own header. */
+    _isMulticart = _controller == Controller::MBC1 && content.size() == 0x100000 &&
+                   std::equal(content.begin() + LOGO_OFFSET, content.begin() + LOGO_OFFSET + LOGO_SIZE,
+                              content.begin() + 0x40000 + LOGO_OFFSET);
+
+    _registers  = {};
+    _romWindows = {};
+    _ramWindow  = nullptr;
+    updateBanks();
+    _realTimeClock.reset();
+}
+
+void Cartridge::setRemapHandler(RemapHandler handler)
+{
+    _remapHandler = std::move(handler);
+}
+
+bool Cartridge::hasBattery() const noexcept
+{
+    switch (type)
+    {
+        using enum Type;
+
+        case MBC1_RAM_BATTERY:
+        case MBC2_BATTERY:
+        case ROM_RAM_BATTERY:
+        case MBC3_RAM_BATTERY:
+        case MBC5_RAM_BATTERY:
+        case MBC5_RUMBLE_RAM_BATTERY:
+            return !_ram.empty();
+        /* The battery keeps the clock running, with or without RAM. */
+        case MBC3_TIMER_BATTERY:
+        case MBC3_TIMER_RAM_BATTERY:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool Cartridge::hasRealTimeClock() const noexcept
+{
+    return type == Type::MBC3_TIMER_BATTERY || type == Type::MBC3_TIMER_RAM_BATTERY;
+}
+
+void Cartridge::attachSave(const std::filesystem::path& path, const SaveFile::Mode mode,
+                           const RealTimeClock::Mode clockMode)
+{
+    if (!hasBattery())
+    {
+        throw std::logic_error("Cartridge has no battery-backed memory to save.");
+    }
+
+    const auto ramSize{_ram.size()};
+
+    detachSave();
+    _save = std::make_unique<SaveFile>(path, ramSize + (hasRealTimeClock() ? RealTimeClock::SAVE_SIZE : 0), mode);
+    _ram  = _save->getRam().first(ramSize);
+    _ramStorage.clear();
+
+    if (hasRealTimeClock())
+    {
+        _realTimeClock.restore(_save->getRam().subspan(ramSize).first<RealTimeClock::SAVE_SIZE>(), clockMode);
+    }
+
+    /* The RAM window now points to the save, and writes to it must no longer bypass write(). */
+    updateBanks();
+}
+
+void Cartridge::saveRealTimeClock()
+{
+    if (_save == nullptr || !hasRealTimeClock())
+    {
+        return;
+    }
+
+    _realTimeClock.save(_save->getRam().subspan(_ram.size()).first<RealTimeClock::SAVE_SIZE>());
+    _save->markDirty();
 }
 
-uint8_t Cartridge::read(const uint16_t address) const
+void Cartridge::detachSave()
 {
-    return content[address];
+    saveRealTimeClock();
+    _save.reset();
+}
+
+void Cartridge::commitSave()
+{
+    if (_save != nullptr)
+    {
+        _save->commit();
+    }
 }
 
-void Cartridge::write(const uint16_t address, uint8_t value)
+std::optional<std::string> Cartridge::takeSaveError()
 {
-    (void) address;
-    (void) value;
+    return _save != nullptr ? _save->takeError() : std::nullopt;
+}
+
+void Cartridge::write(const uint16_t address, const uint8_t value)
+{
+    if (address <= MemoryMap::ROM.second)
+    {
+        writeBankRegister(address, value);
+        updateBanks();
+        return;
+    }
+
+    if (_ramWindow != nullptr)
+    {
+        _ramWindow[address % RAM_BANK_SIZE] = value;
+        if (_save != nullptr)
+        {
+            _save->markDirty();
+        }
+        return;
+    }
+
+    writeUnmappedRam(address, value);
+}
+
+void Cartridge::writeBankRegister(const uint16_t address, const uint8_t value)
+{
+    /* MBC1, MBC2 and MBC3 only look at the low nibble. */
+    const auto isRamEnable{(value & 0x0F) == 0x0A};
+
+    switch (_controller)
+    {
+        case Controller::NONE:
+            break;
+        case Controller::MBC1:
+            switch (address >> 13)
+            {
+                case 0:
+                    _registers.isRamEnabled = isRamEnable;
+                    break;
+                case 1:
+                    _registers.romBank = std::max(value & 0x1F, 1);
+                    break;
+                case 2:
+                    _registers.upperBank = value & 0x03;
+                    break;
+                default:
+                    _registers.mode = value & 0x01;
+                    break;
+            }
+            break;
+        case Controller::MBC2:
+            /* Bit 8 of the address tells ROMB from RAMG, anywhere in 0x0000-0x3FFF. */
+            if (address > 0x3FFF)
+            {
+                break;
+            }
+            if ((address & 0x0100) != 0)
+            {
+                _registers.romBank = std::max(value & 0x0F, 1);
+            }
+            else
+            {
+                _registers.isRamEnabled = isRamEnable;
+            }
+            break;
+        case Controller::MBC3:
+            switch (address >> 13)
+            {
+                case 0:
+                    _registers.isRamEnabled = isRamEnable;
+                    break;
+                case 1:
+                    _registers.romBank = std::max(value & 0x7F, 1);
+                    break;
+                case 2:
+                    _registers.upperBank = value & 0x0F;
+                    break;
+                default:
+                    _realTimeClock.latch(value);
+                    break;
+            }
+            break;
+        case Controller::MBC5:
+            switch (address >> 12)
+            {
+                case 0:
+                case 1:
+                    /* All 8 bits are compared. */
+                    _registers.isRamEnabled = value == 0x0A;
+                    break;
+                case 2:
+                    _registers.romBank = static_cast<uint16_t>((_registers.romBank & 0x100) | value);
+                    break;
+                case 3:
+                    _registers.romBank = static_cast<uint16_t>((_registers.romBank & 0xFF) | (value & 0x01) << 8);
+                    break;
+                case 4:
+                case 5:
+                    _registers.upperBank = value & 0x0F;
+                    break;
+                default:
+                    break;
+            }
+            break;
+    }
+}
+
+void Cartridge::updateBanks()
+{
+    const auto romBankCount{content.size() / ROM_BANK_SIZE};
+    const auto ramBankCount{_ram.size() / RAM_BANK_SIZE};
+    const auto previousRomWindows{_romWindows};
+    const auto previousRamWindow{_ramWindow};
+
+    std::size_t lowRomBank{0};
+    std::size_t romBank{_registers.romBank};
+    std::size_t ramBank{0};
+    bool        isRamMapped{ramBankCount != 0 && (_registers.isRamEnabled || _controller == Controller::NONE)};
+
+    switch (_controller)
+    {
+        case Controller::NONE:
+            romBank = 1;
+            break;
+        case Controller::MBC1:
+        {
+            const auto upperBank{static_cast<std::size_t>(_registers.upperBank) << (_isMulticart ? 4 : 5)};
+
+            romBank = upperBank | (_registers.romBank & (_isMulticart ? 0x0F : 0x1F));
+            if (_registers.mode != 0)
+            {
+                lowRomBank = upperBank;
+                ramBank    = _registers.upperBank;
+            }
+            break;
+        }
+        case Controller::MBC2:
+            isRamMapped = false;
+            break;
+        case Controller::MBC3:
+            /* 0x08-0x0C select the real-time clock registers. */
+            isRamMapped = isRamMapped && _registers.upperBank < 0x08;
+            ramBank     = _registers.upperBank;
+            break;
+        case Controller::MBC5:
+            ramBank = _registers.upperBank;
+            break;
+    }
+
+    lowRomBank %= romBankCount;
+    romBank %= romBankCount;
+
+    _romWindows[0] = content.data() + lowRomBank * ROM_BANK_SIZE;
+    _romWindows[1] = content.data() + romBank * ROM_BANK_SIZE;
+    _ramWindow     = isRamMapped ? _ram.data() + ramBank % ramBankCount * RAM_BANK_SIZE : nullptr;
+
+    _emulationState.lowRomBank = static_cast<uint16_t>(lowRomBank);
+    _emulationState.romBank    = static_cast<uint16_t>(romBank);
+
+    if (_remapHandler == nullptr)
+    {
+        return;
+    }
+
+    if (_romWindows[0] != previousRomWindows[0])
+    {
+        _remapHandler({MemoryMap::ROM.first, ROM_BANK_SIZE - 1});
+    }
+    if (_romWindows[1] != previousRomWindows[1])
+    {
+        _remapHandler({ROM_BANK_SIZE, MemoryMap::ROM.second});
+    }
+    if (_ramWindow != previousRamWindow)
+    {
+        _remapHandler(MemoryMap::EXT_RAM);
+    }
+}
+
+uint8_t Cartridge::readUnmappedRam(const uint16_t address) const
+{
+    /* The upper half of each MBC2 byte is not wired, and reads as ones. The 512 bytes are mirrored. */
+    if (_controller == Controller::MBC2 && _registers.isRamEnabled)
+    {
+        return _ram[address & 0x01FF] | 0xF0;
+    }
+    if (hasRealTimeClock() && _registers.isRamEnabled && RealTimeClock::isRegister(_registers.upperBank))
+    {
+        return _realTimeClock.read(static_cast<RealTimeClock::Register>(_registers.upperBank));
+    }
+
+    return 0xFF;
+}
+
+void Cartridge::writeUnmappedRam(const uint16_t address, const uint8_t value)
+{
+    if (_controller == Controller::MBC2 && _registers.isRamEnabled)
+    {
+        _ram[address & 0x01FF] = value & 0x0F;
+        if (_save != nullptr)
+        {
+            _save->markDirty();
+        }
+    }
+    else if (hasRealTimeClock() && _registers.isRamEnabled && RealTimeClock::isRegister(_registers.upperBank))
+    {
+        _realTimeClock.write(static_cast<RealTimeClock::Register>(_registers.upperBank), value);
+        saveRealTimeClock();
+    }
 }
 
 IAddressable::AddressableRange Cartridge::getAddressableRange() const noexcept
 {
-    return {std::make_pair(0x0000, 0x7FFF)};
+    return {MemoryMap::ROM, MemoryMap::EXT_RAM};
+}
+
+const uint8_t* Cartridge::getReadablePage(const uint16_t address) const noexcept
+{
+    /* Writes to the ROM select banks: only reads go straight to it. */
+    if (address <= MemoryMap::ROM.second)
+    {
+        return _romWindows[address / ROM_BANK_SIZE] + (address % ROM_BANK_SIZE & ~0xFF);
+    }
+
+    return _ramWindow != nullptr ? _ramWindow + (address % RAM_BANK_SIZE & ~0xFF) : nullptr;
+}
+
+uint8_t* Cartridge::getWritablePage(const uint16_t address) noexcept
+{
+    /* Writes to a saved RAM are tracked by write(). */
+    if (address <= MemoryMap::ROM.second || _ramWindow == nullptr || _save != nullptr)
+    {
+        return nullptr;
+    }
+
+    return _ramWindow + (address % RAM_BANK_SIZE & ~0xFF);
 }
 
 const std::string_view& Cartridge::get_title() const
@@ -316,7 +697,7 @@ std::size_t Cartridge::get_rom_size() const
     return rom_size;
 }
 
-Cartridge::operator std::span<uint8_t>()
+Cartridge::operator std::span<const uint8_t>() const
 {
-    return {content.data(), content.size()};
+    return content;
 }
\ No newline at end of file
@@ -20,6 +20,16 @@ IAddressable::AddressableRange EchoRAM::getAddressableRange() const noexcept
     return {MemoryMap::ECHO_RAM};
 }
 
+const uint8_t* EchoRAM::getReadablePage(const uint16_t address) const noexcept
+{
+    return _workRam.getReadablePage(getRealAddress(address));
+}
+
+uint8_t* EchoRAM::getWritablePage(const uint16_t address) noexcept
+{
+    return _workRam.getWritablePage(getRealAddress(address));
+}
+
 uint16_t EchoRAM::getRealAddress(const uint16_t address)
 {
     return MemoryMap::WORK_RAM.first + static_cast<uint16_t>(address & 0x1FFF);
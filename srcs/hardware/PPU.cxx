@@ -11,12 +11,43 @@
 #include "graphics/Tile.hxx"
 #include "hardware/core/SM83.hxx"
 
-PPU::PPU(IAddressable& bus, IRenderer& renderer) : _bus(bus), _renderer(renderer)
+std::unique_ptr<PPU> PPU::create(const Accuracy accuracy, IAddressable& bus, IRenderer& renderer, Scheduler& scheduler)
+{
+    switch (accuracy)
+    {
+        case Accuracy::CYCLE:
+            return std::make_unique<BasicPPU<Accuracy::CYCLE>>(bus, renderer, scheduler);
+        case Accuracy::SCANLINE:
+            return std::make_unique<BasicPPU<Accuracy::SCANLINE>>(bus, renderer, scheduler);
+        case Accuracy::FRAME:
+            return std::make_unique<BasicPPU<Accuracy::FRAME>>(bus, renderer, scheduler);
+    }
+
+    throw std::logic_error{"Invalid PPU accuracy"};
+}
+
+template <PPU::Accuracy ACCURACY>
+BasicPPU<ACCURACY>::BasicPPU(IAddressable& bus, IRenderer& renderer, Scheduler& scheduler)
+    : _bus(bus),
+      _renderer(renderer),
+      _scheduler(scheduler),
+      _lineKernels(&Graphics::LineKernels::get(Graphics::LineKernels::getBestInstructionSet()))
 {
     _oamEntriesToDraw.reserve(10);
+    _scheduler.setHandler(Scheduler::Event::PPU, *this);
+}
+
+template <PPU::Accuracy ACCURACY>
+uint8_t BasicPPU<ACCURACY>::read(const uint16_t address) const
+{
+    /* Reads are const to the bus, but have to observe the PPU as of now. */
+    const_cast<BasicPPU&>(*this)._synchronize(_scheduler.getTimestamp());
+
+    return peek(address);
 }
 
-uint8_t PPU::read(const uint16_t address) const
+template <PPU::Accuracy ACCURACY>
+uint8_t BasicPPU<ACCURACY>::peek(const uint16_t address) const
 {
     if (Utils::addressIn(address, MemoryMap::VIDEO_RAM))
     {
@@ -74,11 +105,28 @@ uint8_t PPU::read(const uint16_t address) const
     throw std::logic_error{"Invalid PPU Read"};
 }
 
-void PPU::write(const uint16_t address, uint8_t value)
+template <PPU::Accuracy ACCURACY>
+const uint8_t* BasicPPU<ACCURACY>::getReadablePage(const uint16_t address) const noexcept
+{
+    /* Nothing in VRAM depends on the PPU being synchronized: it can be read directly. Writes still go through write(),
+     * which synchronizes first. */
+    if (Utils::addressIn(address, MemoryMap::VIDEO_RAM))
+    {
+        return &_videoRam[address & 0x7F00];
+    }
+
+    return nullptr;
+}
+
+template <PPU::Accuracy ACCURACY>
+void BasicPPU<ACCURACY>::write(const uint16_t address, uint8_t value)
 {
+    _synchronize(_scheduler.getTimestamp());
+
     if (Utils::addressIn(address, MemoryMap::VIDEO_RAM))
     {
         _videoRam[address & 0x7FFF] = value;
+        _tileCache.invalidate(address & 0x7FFF);
     }
     else if (Utils::addressIn(address, MemoryMap::OAM))
     {
@@ -140,437 +188,405 @@ void PPU::write(const uint16_t address, uint8_t value)
     {
         throw std::logic_error{"Invalid PPU Write"};
     }
+
+    _schedule();
 }
 
-void PPU::tick(const size_t machineCycle)
+template <PPU::Accuracy ACCURACY>
+void BasicPPU<ACCURACY>::onEvent(Scheduler::Event event, const Scheduler::Timestamp timestamp)
 {
-    using namespace Utils;
-
-    for (size_t i{0}; i < machineCycle * 4; ++i)
-    {
-        _dots += 1;
+    (void) event;
 
-        switch (_mode)
-        {
-            case Mode::OAMScan:
-                _videoRamAccessible = true;
-                _oamAccessible      = false;
-
-                if (_dots == 80)
-                {
-                    for (auto oamEntry{_oamEntries.cbegin()}; oamEntry != _oamEntries.cend(); oamEntry++)
-                    {
-                        if (const auto objSize{_registers.LCDC & LCDControlFlags::ObjSize ? 16 : 8};
-                            _registers.LY + 16 >= oamEntry->y && _registers.LY + 16 < oamEntry->y + objSize)
-                        {
-                            if (_oamEntriesToDraw.size() < 10)
-                            {
-                                _oamEntriesToDraw.emplace_back(oamEntry);
-                            }
-                        }
-                    }
-
-                    /*
-                     * In Non-CGB mode, the smaller the X coordinate, the higher the priority. When X coordinates are
-                     * identical, the object located first in OAM has higher priority.
-                     * A stable sort preserves the original order of the OAM if two OAM entries X position are equal.
-                     */
-                    std::ranges::stable_sort(_oamEntriesToDraw, {}, &OAMEntry::x);
+    _synchronize(timestamp);
+    _schedule();
+}
 
-                    _transition(Mode::Drawing);
-                }
-                break;
-            case Mode::Drawing:
-                _videoRamAccessible = false;
-                _oamAccessible      = false;
+template <PPU::Accuracy ACCURACY>
+void BasicPPU<ACCURACY>::_synchronize(const Scheduler::Timestamp timestamp)
+{
+    if (timestamp <= _synchronizedAt)
+    {
+        return;
+    }
 
-                /* Minimum length : 172 dots. */
-                if (_dots == 252)
-                {
-                    _drawLine();
-                    _transition(Mode::HorizontalBlank);
-                }
-                break;
-            case Mode::HorizontalBlank:
-                _videoRamAccessible = true;
-                _oamAccessible      = true;
+    const auto machineCycles{static_cast<size_t>(timestamp - _synchronizedAt)};
 
-                if (_dots == 456)
-                {
-                    _dots = 0;
+    _synchronizedAt = timestamp;
 
-                    _registers.LY += 1;
+    if (_mode == Mode::Disabled)
+    {
+        /* While disabled, a single dot is counted per machine cycle. */
+        _dots = static_cast<uint16_t>(_dots + machineCycles);
+        return;
+    }
 
-                    if (_registers.LY == _registers.LYC)
-                    {
-                        if (_registers.STAT & Status::LYC)
-                        {
-                            _bus.write(MemoryMap::IORegisters::IF,
-                                       _bus.read(MemoryMap::IORegisters::IF) | (1 << Interrupts::LCD));
-                        }
+    /* Nothing but the accessibility flags changes in between two mode transitions. */
+    for (auto dots{machineCycles * 4}; dots > 0;)
+    {
+        const auto dotsToModeEnd{_getDotsToModeEnd()};
 
-                        _registers.STAT |= Status::LYCCompare;
-                    }
-                    else
-                    {
-                        _registers.STAT &= ~Status::LYCCompare;
-                    }
+        _videoRamAccessible = _mode != Mode::Drawing;
+        _oamAccessible      = _mode != Mode::OAMScan && _mode != Mode::Drawing;
 
-                    if (_registers.LY == 144)
-                    {
-                        _transition(Mode::VerticalBlank);
-                    }
-                    else
-                    {
-                        _transition(Mode::OAMScan);
-                    }
-                }
-                break;
-            case Mode::VerticalBlank:
-                _videoRamAccessible = true;
-                _oamAccessible      = true;
+        if (dots < dotsToModeEnd)
+        {
+            _dots = static_cast<uint16_t>(_dots + dots);
+            return;
+        }
 
-                if (_dots == 456)
-                {
-                    _dots = 0;
-                    _registers.LY += 1;
+        _dots = static_cast<uint16_t>(_dots + dotsToModeEnd);
+        dots -= dotsToModeEnd;
 
-                    if (_registers.LY == 154)
-                    {
-                        _transition(Mode::OAMScan);
-                    }
-                }
-                break;
-            case Mode::Disabled:
-                return;
-        }
+        _endMode();
     }
 }
 
-void PPU::setPostBootRomRegisters()
+template <PPU::Accuracy ACCURACY>
+void BasicPPU<ACCURACY>::_schedule()
 {
-    _registers.LCDC = 0x91;
-    _registers.STAT = 0x85;
-}
+    if (_mode == Mode::Disabled)
+    {
+        _scheduler.cancel(Scheduler::Event::PPU);
+        return;
+    }
 
-IAddressable::AddressableRange PPU::getAddressableRange() const noexcept
-{
-    return {MemoryMap::VIDEO_RAM,         MemoryMap::OAM,
-            MemoryMap::IORegisters::SCX,  MemoryMap::IORegisters::SCY,
-            MemoryMap::IORegisters::WX,   MemoryMap::IORegisters::WY,
-            MemoryMap::IORegisters::BGP,  MemoryMap::IORegisters::LY,
-            MemoryMap::IORegisters::LYC,  MemoryMap::IORegisters::STAT,
-            MemoryMap::IORegisters::LCDC, MemoryMap::IORegisters::OBP0,
-            MemoryMap::IORegisters::OBP1};
+    /* The PPU is always synchronized on a machine cycle boundary, that is, 4 dots. */
+    _scheduler.schedule(Scheduler::Event::PPU, _synchronizedAt + (_getDotsToNextEvent() + 3) / 4);
 }
 
-void PPU::_drawLine()
+template <PPU::Accuracy ACCURACY>
+size_t BasicPPU<ACCURACY>::_getDotsToNextEvent() const noexcept
 {
-    bool hasWndPixel{};
+    const auto dotsToModeEnd{_getDotsToModeEnd()};
 
-    for (uint8_t x{0}; x < 160; ++x)
+    if constexpr (ACCURACY == Accuracy::CYCLE)
     {
-        ObjPixel objPixel{_oamEntries.cend(), 0};
-        BgPixel  bgPixel{false, 0};
-
-        if (_registers.LCDC & LCDControlFlags::ObjEnable)
-        {
-            objPixel = _spriteFetch(x);
-        }
-
-        if (_registers.LCDC & LCDControlFlags::BGWindowEnableOrPriority)
-        {
-            bgPixel = _bgFetch(x);
-        }
-
-        if (bgPixel.first)
-        {
-            hasWndPixel = true;
-        }
-
-        _renderer.setPixel(x, _registers.LY, _pixelMixing(objPixel, bgPixel));
+        return dotsToModeEnd;
     }
 
-    if (hasWndPixel)
+    /* Interrupts are only requested, and frames only completed, at the end of a line. */
+    switch (_mode)
     {
-        _windowLineCounter += 1;
+        case Mode::OAMScan:
+            return dotsToModeEnd + (252 - 80) + (456 - 252);
+        case Mode::Drawing:
+            return dotsToModeEnd + (456 - 252);
+        default:
+            return dotsToModeEnd;
     }
 }
 
-PPU::ObjPixel PPU::_spriteFetch(const uint8_t x) const
+template <PPU::Accuracy ACCURACY>
+size_t BasicPPU<ACCURACY>::_getDotsToModeEnd() const noexcept
 {
-    auto    objFetched{_oamEntries.cend()};
-    uint8_t objPixel{};
-    uint8_t objColOffset{};
+    uint16_t modeEnd{};
 
-    for (const auto oamEntryToDraw : _oamEntriesToDraw)
+    switch (_mode)
     {
-        if (x + 8 >= oamEntryToDraw->x && x + 8 < oamEntryToDraw->x + 8)
-        {
-            uint8_t  objHeight{};
-            uint8_t  rowOffset{};
-            uint16_t tileDataAddress{};
-            uint8_t  tileIndex{};
-            uint8_t  objTileDataLow{};
-            uint8_t  objTileDataHigh{};
+        case Mode::OAMScan:
+            modeEnd = 80;
+            break;
+        case Mode::Drawing:
+            /* Minimum length : 172 dots. */
+            modeEnd = 252;
+            break;
+        case Mode::HorizontalBlank:
+        case Mode::VerticalBlank:
+            modeEnd = 456;
+            break;
+        case Mode::Disabled:
+            return 0;
+    }
 
-            objFetched = oamEntryToDraw;
+    /* The dot counter is not reset when the PPU is enabled back: it may have to wrap around to reach the end. */
+    const auto dotsToModeEnd{static_cast<uint16_t>(modeEnd - _dots)};
 
-            if (_registers.LCDC & LCDControlFlags::ObjSize)
+    return dotsToModeEnd == 0 ? 0x10000 : dotsToModeEnd;
+}
+
+template <PPU::Accuracy ACCURACY>
+void BasicPPU<ACCURACY>::_endMode()
+{
+    switch (_mode)
+    {
+        case Mode::OAMScan:
+        {
+            if constexpr (ACCURACY == Accuracy::FRAME)
             {
-                objHeight = 16;
-                tileIndex = objFetched->tileIndex & 0xFE;
+                _transition(Mode::Drawing);
+                break;
             }
-            else
+
+            for (auto oamEntry{_oamEntries.cbegin()}; oamEntry != _oamEntries.cend(); oamEntry++)
             {
-                objHeight = 8;
-                tileIndex = objFetched->tileIndex;
+                if (const auto objSize{_registers.LCDC & LCDControlFlags::ObjSize ? 16 : 8};
+                    _registers.LY + 16 >= oamEntry->y && _registers.LY + 16 < oamEntry->y + objSize)
+                {
+                    if (_oamEntriesToDraw.size() < 10)
+                    {
+                        _oamEntriesToDraw.emplace_back(oamEntry);
+                    }
+                }
             }
 
-            if (objFetched->yFlip)
+            /*
+             * In Non-CGB mode, the smaller the X coordinate, the higher the priority. When X coordinates are
+             * identical, the object located first in OAM has higher priority.
+             * A stable sort preserves the original order of the OAM if two OAM entries X position are equal.
+             */
+            std::ranges::stable_sort(_oamEntriesToDraw, {}, &OAMEntry::x);
+
+            _transition(Mode::Drawing);
+            break;
+        }
+        case Mode::Drawing:
+            if constexpr (ACCURACY != Accuracy::FRAME)
             {
-                /* Instead of fetching from the first line, fetch starting from the last line and advance
-                 * backward. */
+                _drawLine();
+            }
+            _transition(Mode::HorizontalBlank);
+            break;
+        case Mode::HorizontalBlank:
+            _dots = 0;
 
-                rowOffset = ((objHeight * 2) - 2) - 2 * ((_registers.LY + 16 - objFetched->y) % objHeight);
+            _registers.LY += 1;
+
+            if (_registers.LY == _registers.LYC)
+            {
+                if (_registers.STAT & Status::LYC)
+                {
+                    _bus.write(MemoryMap::IORegisters::IF,
+                               _bus.read(MemoryMap::IORegisters::IF) | (1 << Interrupts::LCD));
+                }
+
+                _registers.STAT |= Status::LYCCompare;
             }
             else
             {
-                rowOffset = 2 * ((_registers.LY + 16 - objFetched->y) % objHeight);
+                _registers.STAT &= ~Status::LYCCompare;
             }
 
-            if (objFetched->xFlip)
+            if (_registers.LY == 144)
             {
-                /* Same logic as yFlip, but instead of fetching from the leftmost pixel, start from the
-                 * rightmost, and advance backward. */
-
-                objColOffset = (x + 8 - objFetched->x) % Graphics::TILE_SIZE;
+                _transition(Mode::VerticalBlank);
             }
             else
             {
-                objColOffset = 7 - (x + 8 - objFetched->x) % Graphics::TILE_SIZE;
+                _transition(Mode::OAMScan);
             }
+            break;
+        case Mode::VerticalBlank:
+            _dots = 0;
+            _registers.LY += 1;
 
-            tileDataAddress = tileIndex * 16 + rowOffset;
-            objTileDataLow  = _videoRam[tileDataAddress];
-            objTileDataHigh = _videoRam[tileDataAddress + 1];
+            if (_registers.LY == 154)
+            {
+                _transition(Mode::OAMScan);
+            }
+            break;
+        case Mode::Disabled:
+            break;
+    }
+}
 
-            objPixel = (((objTileDataHigh >> objColOffset) & 1) << 1) | ((objTileDataLow >> objColOffset) & 1);
+template <PPU::Accuracy ACCURACY>
+void BasicPPU<ACCURACY>::setPostBootRomRegisters()
+{
+    _registers.LCDC = 0x91;
+    _registers.STAT = 0x85;
+}
 
-            /* Stop at the first (highest priority) object found for this pixel. */
+template <PPU::Accuracy ACCURACY>
+PPU::Accuracy BasicPPU<ACCURACY>::getAccuracy() const noexcept
+{
+    return ACCURACY;
+}
 
-            break;
-        }
-    }
+template <PPU::Accuracy ACCURACY>
+IAddressable::AddressableRange BasicPPU<ACCURACY>::getAddressableRange() const noexcept
+{
+    return {MemoryMap::VIDEO_RAM,         MemoryMap::OAM,
+            MemoryMap::IORegisters::SCX,  MemoryMap::IORegisters::SCY,
+            MemoryMap::IORegisters::WX,   MemoryMap::IORegisters::WY,
+            MemoryMap::IORegisters::BGP,  MemoryMap::IORegisters::LY,
+            MemoryMap::IORegisters::LYC,  MemoryMap::IORegisters::STAT,
+            MemoryMap::IORegisters::LCDC, MemoryMap::IORegisters::OBP0,
+            MemoryMap::IORegisters::OBP1};
+}
 
-    return {objFetched, objPixel};
+template <PPU::Accuracy ACCURACY>
+void BasicPPU<ACCURACY>::setInstructionSet(const Graphics::LineKernels::InstructionSet instructionSet)
+{
+    _lineKernels = &Graphics::LineKernels::get(instructionSet);
 }
 
-PPU::BgPixel PPU::_bgFetch(uint8_t x) const
+template <PPU::Accuracy ACCURACY>
+void BasicPPU<ACCURACY>::_drawLine()
 {
-    uint8_t bgPixel{};
-    bool    isWnd{};
+    _tileCache.update(std::span{_videoRam}.template first<Graphics::TileCache::TILE_DATA_SIZE>(), *_lineKernels);
 
-    uint8_t tileNumber{};
-    uint8_t bgTileDataLow{};
-    uint8_t bgTileDataHigh{};
-    uint8_t bgColOffset{};
+    const auto                                background{_fetchBackgroundLine()};
+    std::array<uint8_t, Graphics::LINE_WIDTH> objects{};
 
-    if (_registers.LCDC & LCDControlFlags::WindowEnable && _registers.WX != 0 && _registers.WY != 0 &&
-        _registers.LY >= _registers.WY && x + 7 >= _registers.WX)
+    if (_registers.LCDC & LCDControlFlags::ObjEnable)
     {
-        isWnd = true;
+        objects = _fetchObjectLine();
+    }
 
-        {
-            /* Get the tile number off the background tile map. */
+    _lineKernels->mixLine(background.pixels.data(), objects.data(),
+                          {.BGP = _registers.BGP, .OBP0 = _registers.OBP0, .OBP1 = _registers.OBP1},
+                          _renderer.getLine(_registers.LY).data());
 
-            uint16_t windowTileMapAreaOffset{};
-            uint8_t  colTileMap{};
-            uint8_t  rowTileMap{};
-            uint8_t  rowOffset{};
-            uint8_t  colOffset{};
+    if (background.windowStart < background.pixels.size())
+    {
+        _windowLineCounter += 1;
+    }
+}
 
-            if (_registers.LCDC & LCDControlFlags::WindowTileMapSelect)
-            {
-                windowTileMapAreaOffset = 0x1C00;
-            }
-            else
-            {
-                windowTileMapAreaOffset = 0x1800;
-            }
+template <PPU::Accuracy ACCURACY>
+std::array<uint8_t, Graphics::LINE_WIDTH> BasicPPU<ACCURACY>::_fetchObjectLine() const
+{
+    const auto objHeight{static_cast<uint8_t>(_registers.LCDC & LCDControlFlags::ObjSize ? 16 : 8)};
+    std::array<uint8_t, Graphics::LINE_WIDTH> line{};
 
-            colOffset  = x - (_registers.WX - 7);
-            rowOffset  = _windowLineCounter;
-            colTileMap = colOffset / Graphics::TILE_SIZE;
-            rowTileMap = rowOffset / Graphics::TILE_SIZE;
+    /*
+     * The objects are sorted by priority: a pixel belongs to the first object covering it, even where that object is
+     * transparent.
+     */
+    for (const auto oamEntryToDraw : _oamEntriesToDraw)
+    {
+        uint8_t tileIndex{oamEntryToDraw->tileIndex};
+        uint8_t objRow{static_cast<uint8_t>((_registers.LY + 16 - oamEntryToDraw->y) % objHeight)};
 
-            tileNumber = _videoRam[windowTileMapAreaOffset + colTileMap + Graphics::TILE_MAP_SIZE * rowTileMap];
+        if (_registers.LCDC & LCDControlFlags::ObjSize)
+        {
+            tileIndex &= 0xFE;
         }
 
+        if (oamEntryToDraw->yFlip)
         {
-            /* Get tile data from video ram using the tile number. */
-
-            uint16_t tileDataAddress{};
-            size_t   rowOffset{};
-
-            if (_registers.LCDC & LCDControlFlags::BGAndWindowTileDataArea)
-            {
-                tileDataAddress = tileNumber * Graphics::BYTES_PER_LINE;
-            }
-            else
-            {
-                tileDataAddress = 0x1000 + static_cast<int8_t>(tileNumber) * Graphics::BYTES_PER_LINE;
-            }
-
-            rowOffset       = 2 * (_windowLineCounter % Graphics::TILE_SIZE);
-            tileDataAddress = tileDataAddress + rowOffset;
-
-            bgTileDataLow  = _videoRam[tileDataAddress];
-            bgTileDataHigh = _videoRam[tileDataAddress + 1];
+            /* Instead of fetching from the first line, fetch starting from the last line and advance backward. */
+            objRow = objHeight - 1 - objRow;
         }
 
-        bgColOffset = 7 - ((x - (_registers.WX - 7)) % Graphics::TILE_SIZE);
+        /* The cache holds the X-flipped rows as well. An 8×16 object spans two consecutive tiles. */
+        const auto tileRow{_tileCache.getRow(tileIndex + objRow / Graphics::TILE_SIZE, objRow % Graphics::TILE_SIZE,
+                                             oamEntryToDraw->xFlip)};
+        const auto flags{static_cast<uint8_t>(Graphics::ObjectPixel::Present |
+                                              (oamEntryToDraw->dmgPalette ? Graphics::ObjectPixel::Palette : 0) |
+                                              (oamEntryToDraw->priority ? Graphics::ObjectPixel::Priority : 0))};
 
-        bgPixel = (((bgTileDataHigh >> bgColOffset) & 1) << 1) | ((bgTileDataLow >> bgColOffset) & 1);
-    }
-    else
-    {
+        /* The object covers the 8 pixels left of its X position, some of which may be off-screen. */
+        for (std::size_t column{0}; column < Graphics::TILE_SIZE; ++column)
         {
-            /* Get the tile number off the background tile map. */
-
-            uint16_t bgTileMapAreaOffset{};
-            uint8_t  colTileMap{};
-            uint8_t  rowTileMap{};
-            uint8_t  rowOffset{};
-            uint8_t  colOffset{};
+            const auto x{oamEntryToDraw->x + column - Graphics::TILE_SIZE};
 
-            if (_registers.LCDC & LCDControlFlags::BGTileMapSelect)
+            if (x < line.size() && !(line[x] & Graphics::ObjectPixel::Present))
             {
-                bgTileMapAreaOffset = 0x1C00;
+                line[x] = static_cast<uint8_t>(flags | tileRow[column]);
             }
-            else
-            {
-                bgTileMapAreaOffset = 0x1800;
-            }
-
-            colOffset  = _registers.SCX + x;
-            rowOffset  = _registers.SCY + _registers.LY;
-            colTileMap = colOffset / Graphics::TILE_SIZE;
-            rowTileMap = rowOffset / Graphics::TILE_SIZE;
-
-            tileNumber = _videoRam[bgTileMapAreaOffset + colTileMap + Graphics::TILE_MAP_SIZE * rowTileMap];
         }
+    }
 
-        {
-            /* Get tile data from video ram using the tile number. */
-
-            uint16_t tileDataAddress{};
-            size_t   rowOffset{};
-
-            if (_registers.LCDC & LCDControlFlags::BGAndWindowTileDataArea)
-            {
-                tileDataAddress = tileNumber * Graphics::BYTES_PER_LINE;
-            }
-            else
-            {
-                tileDataAddress = 0x1000 + static_cast<int8_t>(tileNumber) * Graphics::BYTES_PER_LINE;
-            }
-
-            rowOffset       = 2 * ((_registers.SCY + _registers.LY) % Graphics::TILE_SIZE);
-            tileDataAddress = tileDataAddress + rowOffset;
+    return line;
+}
 
-            bgTileDataLow  = _videoRam[tileDataAddress];
-            bgTileDataHigh = _videoRam[tileDataAddress + 1];
-        }
+template <PPU::Accuracy ACCURACY>
+typename BasicPPU<ACCURACY>::BackgroundLine BasicPPU<ACCURACY>::_fetchBackgroundLine() const
+{
+    BackgroundLine line{};
 
-        bgColOffset = 7 - ((x + _pixelsToDiscard) % Graphics::TILE_SIZE);
+    if (!(_registers.LCDC & LCDControlFlags::BGWindowEnableOrPriority))
+    {
+        return line;
+    }
 
-        bgPixel = (((bgTileDataHigh >> bgColOffset) & 1) << 1) | ((bgTileDataLow >> bgColOffset) & 1);
+    if (_registers.LCDC & LCDControlFlags::WindowEnable && _registers.WX != 0 && _registers.WY != 0 &&
+        _registers.LY >= _registers.WY)
+    {
+        line.windowStart = std::clamp<std::size_t>(std::max(_registers.WX, uint8_t{7}) - 7, 0, line.pixels.size());
     }
 
-    return {isWnd, bgPixel};
-}
+    /* Up to 21 tiles cover a line, when it does not start on a tile boundary. */
+    std::array<uint8_t, 21 * Graphics::TILE_SIZE> tilePixels{};
 
-uint8_t PPU::_pixelMixing(const ObjPixel& objPixel, const BgPixel& bgPixel) const
-{
-    const uint8_t* finalPixel{};
-    uint8_t        finalPalette{};
-    uint8_t        palettedPixel{};
+    if (line.windowStart > 0)
+    {
+        const auto bgTileMapAreaOffset{
+            static_cast<uint16_t>(_registers.LCDC & LCDControlFlags::BGTileMapSelect ? 0x1C00 : 0x1800)};
+        const auto rowOffset{static_cast<uint8_t>(_registers.SCY + _registers.LY)};
+        const auto fineScroll{static_cast<uint8_t>(_registers.SCX % Graphics::TILE_SIZE)};
+        const auto tileCount{(fineScroll + line.windowStart - 1) / Graphics::TILE_SIZE + 1};
 
-    /* Which pixel should we display ? */
+        _fetchTileRows(bgTileMapAreaOffset, _registers.SCX / Graphics::TILE_SIZE, rowOffset,
+                       std::span{tilePixels}.first(tileCount * Graphics::TILE_SIZE));
 
-    if (objPixel.first != _oamEntries.cend())
-    {
-        if (objPixel.first->priority)
+        /* The tiles follow SCX as of now, but the fine scroll was latched when drawing started. */
+        if (_pixelsToDiscard == fineScroll)
         {
-            /* Background has priority over object. */
-            if (bgPixel.second >= 0b01 && bgPixel.second <= 0b11)
-            {
-                finalPixel = &bgPixel.second;
-            }
-            /* But not when the background pixel is 0 (transparent). */
-            else
-            {
-                finalPixel = &objPixel.second;
-            }
+            std::copy_n(tilePixels.begin() + fineScroll, line.windowStart, line.pixels.begin());
         }
         else
         {
-            if (objPixel.second == 0b00)
+            for (std::size_t x{0}; x < line.windowStart; ++x)
             {
-                finalPixel = &bgPixel.second;
-            }
-            else
-            {
-                finalPixel = &objPixel.second;
+                line.pixels[x] = tilePixels[(fineScroll + x) / Graphics::TILE_SIZE * Graphics::TILE_SIZE +
+                                            (x + _pixelsToDiscard) % Graphics::TILE_SIZE];
             }
         }
     }
-    else
+
+    if (line.windowStart < line.pixels.size())
     {
-        finalPixel = &bgPixel.second;
-    }
+        const auto windowTileMapAreaOffset{
+            static_cast<uint16_t>(_registers.LCDC & LCDControlFlags::WindowTileMapSelect ? 0x1C00 : 0x1800)};
+        /* When WX is below 7, the window starts on the screen edge, its leftmost pixels cut off. */
+        const auto firstColumn{line.windowStart + 7 - _registers.WX};
+        const auto pixelCount{line.pixels.size() - line.windowStart};
+        const auto tileCount{(firstColumn + pixelCount - 1) / Graphics::TILE_SIZE + 1};
 
-    /* Which palette should we apply ? */
+        _fetchTileRows(windowTileMapAreaOffset, 0, _windowLineCounter,
+                       std::span{tilePixels}.first(tileCount * Graphics::TILE_SIZE));
 
-    if (finalPixel == &bgPixel.second)
-    {
-        finalPalette = _registers.BGP;
-    }
-    else
-    {
-        if (objPixel.first->dmgPalette)
+        for (std::size_t x{0}; x < pixelCount; ++x)
         {
-            finalPalette = _registers.OBP1;
-        }
-        else
-        {
-            finalPalette = _registers.OBP0;
+            line.pixels[line.windowStart + x] =
+                static_cast<uint8_t>(tilePixels[firstColumn + x] | Graphics::PixelType::Window << 2);
         }
     }
 
-    palettedPixel = finalPalette >> (2 * *finalPixel) & 0b11;
+    return line;
+}
 
-    /* Apply additional information for debugging. */
+template <PPU::Accuracy ACCURACY>
+void BasicPPU<ACCURACY>::_fetchTileRows(const uint16_t tileMapAddress, const uint8_t column, const uint8_t row,
+                                        const std::span<uint8_t> pixels) const
+{
+    const auto tileCount{pixels.size() / Graphics::TILE_SIZE};
 
-    if (finalPixel == &bgPixel.second)
+    for (std::size_t tile{0}; tile < tileCount; ++tile)
     {
-        if (bgPixel.first)
+        const auto  tileNumber{_videoRam[tileMapAddress + (column + tile) % Graphics::TILE_MAP_SIZE +
+                                         Graphics::TILE_MAP_SIZE * (row / Graphics::TILE_SIZE)]};
+        std::size_t tileIndex{};
+
+        if (_registers.LCDC & LCDControlFlags::BGAndWindowTileDataArea)
         {
-            palettedPixel |= Graphics::PixelType::Window << 2;
+            tileIndex = tileNumber;
+        }
+        else
+        {
+            /* The tiles from 0x8800 on, with the tile number signed and relative to 0x9000. */
+            tileIndex = 256 + static_cast<int8_t>(tileNumber);
         }
 
-        /* Background is a no-op (0). */
-    }
-    else
-    {
-        palettedPixel |= Graphics::PixelType::Object << 2;
+        std::ranges::copy(_tileCache.getRow(tileIndex, row % Graphics::TILE_SIZE),
+                          pixels.begin() + Graphics::TILE_SIZE * tile);
     }
-
-    return palettedPixel;
 }
 
-void PPU::_transition(const Mode transitionTo)
+template <PPU::Accuracy ACCURACY>
+void BasicPPU<ACCURACY>::_transition(const Mode transitionTo)
 {
     auto modeValue{std::to_underlying(_mode)};
 
@@ -613,7 +629,8 @@ void PPU::_transition(const Mode transitionTo)
     _mode = transitionTo;
 }
 
-void PPU::_triggerStatInterrupt(const bool value)
+template <PPU::Accuracy ACCURACY>
+void BasicPPU<ACCURACY>::_triggerStatInterrupt(const bool value)
 {
     if (value && !_irq)
     {
@@ -625,3 +642,7 @@ void PPU::_triggerStatInterrupt(const bool value)
         _irq = false;
     }
 }
+
+template class BasicPPU<PPU::Accuracy::CYCLE>;
+template class BasicPPU<PPU::Accuracy::SCANLINE>;
+template class BasicPPU<PPU::Accuracy::FRAME>;
@@ -0,0 +1,194 @@
+#include "hardware/RealTimeClock.hxx"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    /**
+     * @brief Bits implemented by each register, SECONDS first.
+     */
+    constexpr std::array<uint8_t, 5> REGISTER_MASKS{0x3F, 0x3F, 0x1F, 0xFF, 0xC1};
+
+    constexpr std::size_t REGISTERS_OFFSET{0};
+    constexpr std::size_t LATCHED_OFFSET{20};
+    constexpr std::size_t TIMESTAMP_OFFSET{40};
+
+    uint64_t readLittleEndian(const std::span<const uint8_t> bytes)
+    {
+        uint64_t value{0};
+
+        for (auto byte{bytes.rbegin()}; byte != bytes.rend(); ++byte)
+        {
+            value = value << 8 | *byte;
+        }
+
+        return value;
+    }
+
+    void writeLittleEndian(const std::span<uint8_t> bytes, uint64_t value)
+    {
+        for (auto& byte : bytes)
+        {
+            byte = static_cast<uint8_t>(value);
+            value >>= 8;
+        }
+    }
+
+    uint64_t getUnixTime()
+    {
+        const auto now{std::chrono::system_clock::now().time_since_epoch()};
+
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(now).count());
+    }
+}  // namespace
+
+RealTimeClock::RealTimeClock(const Scheduler& scheduler) : _scheduler(scheduler) {}
+
+void RealTimeClock::reset()
+{
+    _synchronizedAt = _scheduler.getTimestamp();
+    _seconds        = 0;
+    _cycles         = 0;
+    _isHalted       = false;
+    _isDayCarry     = false;
+    _latched        = {};
+    _latch          = 0xFF;
+}
+
+bool RealTimeClock::isRegister(const uint8_t select) noexcept
+{
+    return select >= static_cast<uint8_t>(Register::SECONDS) && select <= static_cast<uint8_t>(Register::DAYS_HIGH);
+}
+
+uint8_t RealTimeClock::read(const Register reg) const noexcept
+{
+    return _latched[static_cast<uint8_t>(reg) - static_cast<uint8_t>(Register::SECONDS)];
+}
+
+void RealTimeClock::write(const Register reg, const uint8_t value)
+{
+    const auto index{static_cast<std::size_t>(static_cast<uint8_t>(reg) - static_cast<uint8_t>(Register::SECONDS))};
+
+    synchronize();
+
+    auto registers{getRegisters()};
+
+    registers[index] = value & REGISTER_MASKS[index];
+    setRegisters(registers);
+
+    /* Writing the seconds resets the divider counting them. */
+    if (reg == Register::SECONDS)
+    {
+        _cycles = 0;
+    }
+}
+
+void RealTimeClock::latch(const uint8_t value)
+{
+    if (_latch == 0x00 && value == 0x01)
+    {
+        synchronize();
+        _latched = getRegisters();
+    }
+
+    _latch = value;
+}
+
+void RealTimeClock::save(const std::span<uint8_t, SAVE_SIZE> state)
+{
+    synchronize();
+
+    const auto registers{getRegisters()};
+
+    for (std::size_t index{0}; index < registers.size(); ++index)
+    {
+        writeLittleEndian(state.subspan(REGISTERS_OFFSET + index * 4, 4), registers[index]);
+        writeLittleEndian(state.subspan(LATCHED_OFFSET + index * 4, 4), _latched[index]);
+    }
+
+    writeLittleEndian(state.subspan(TIMESTAMP_OFFSET, 8), getUnixTime());
+}
+
+void RealTimeClock::restore(const std::span<const uint8_t, SAVE_SIZE> state, const Mode mode)
+{
+    reset();
+
+    /* Saves are padded with 0xFF when the clock was not saved along with the RAM. */
+    if (std::ranges::all_of(state, [](const auto byte) { return byte == 0xFF; }))
+    {
+        return;
+    }
+
+    Registers registers{};
+
+    for (std::size_t index{0}; index < registers.size(); ++index)
+    {
+        const auto value{readLittleEndian(state.subspan(REGISTERS_OFFSET + index * 4, 4))};
+        const auto latched{readLittleEndian(state.subspan(LATCHED_OFFSET + index * 4, 4))};
+
+        registers[index] = static_cast<uint8_t>(value & REGISTER_MASKS[index]);
+        _latched[index]  = static_cast<uint8_t>(latched & REGISTER_MASKS[index]);
+    }
+
+    setRegisters(registers);
+
+    const auto savedAt{readLittleEndian(state.subspan(TIMESTAMP_OFFSET, 8))};
+
+    if (const auto now{getUnixTime()}; mode == Mode::REAL_TIME && !_isHalted && now > savedAt)
+    {
+        elapse(now - savedAt);
+    }
+}
+
+void RealTimeClock::synchronize()
+{
+    const auto timestamp{_scheduler.getTimestamp()};
+
+    if (!_isHalted)
+    {
+        const auto cycles{_cycles + (timestamp - _synchronizedAt)};
+
+        _cycles = cycles % CYCLES_PER_SECOND;
+        elapse(cycles / CYCLES_PER_SECOND);
+    }
+
+    _synchronizedAt = timestamp;
+}
+
+void RealTimeClock::elapse(const uint64_t seconds) noexcept
+{
+    constexpr auto PERIOD{DAY_COUNT * SECONDS_PER_DAY};
+
+    /* The day counter overflows into a carry flag, which stays set until written. */
+    if (seconds >= PERIOD - _seconds)
+    {
+        _isDayCarry = true;
+    }
+
+    _seconds = (_seconds + seconds % PERIOD) % PERIOD;
+}
+
+RealTimeClock::Registers RealTimeClock::getRegisters() const noexcept
+{
+    const auto days{_seconds / SECONDS_PER_DAY};
+
+    return {
+        static_cast<uint8_t>(_seconds % 60),
+        static_cast<uint8_t>(_seconds / 60 % 60),
+        static_cast<uint8_t>(_seconds / (60 * 60) % 24),
+        static_cast<uint8_t>(days),
+        static_cast<uint8_t>((days >> 8 & DAY_HIGH_MASK) | (_isHalted ? HALT_MASK : 0) |
+                             (_isDayCarry ? DAY_CARRY_MASK : 0)),
+    };
+}
+
+void RealTimeClock::setRegisters(const Registers& registers) noexcept
+{
+    const auto days{static_cast<uint64_t>(registers[4] & DAY_HIGH_MASK) << 8 | registers[3]};
+    const auto seconds{days * SECONDS_PER_DAY + registers[2] * 60 * 60 + registers[1] * 60 + registers[0]};
+
+    _seconds    = seconds % (DAY_COUNT * SECONDS_PER_DAY);
+    _isHalted   = (registers[4] & HALT_MASK) != 0;
+    _isDayCarry = (registers[4] & DAY_CARRY_MASK) != 0;
+}
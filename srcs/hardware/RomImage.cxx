@@ -0,0 +1,162 @@
+#include "hardware/RomImage.hxx"
+
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GBEMU_ROM_MAPPING_SUPPORTED
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr std::size_t MIN_SIZE{2 * RomImage::BANK_SIZE};
+
+    std::mutex                                                      cacheMutex;
+    std::unordered_map<std::string, std::weak_ptr<const RomImage>> cache;
+
+    /**
+     * @brief Tells apart the versions of a file, so that a ROM rebuilt in place is mapped again.
+     */
+    std::string getCacheKey(const std::filesystem::path& path)
+    {
+        const auto canonical{std::filesystem::canonical(path)};
+
+        return std::format("{}:{}:{}", canonical.string(), std::filesystem::file_size(canonical),
+                           std::filesystem::last_write_time(canonical).time_since_epoch().count());
+    }
+}  // namespace
+
+std::shared_ptr<const RomImage> RomImage::open(const std::filesystem::path& path)
+{
+    if (!std::filesystem::is_regular_file(path))
+    {
+        throw std::runtime_error(std::format("File {} does not exist or is not a regular file.", path.string()));
+    }
+
+    const auto            key{getCacheKey(path)};
+    const std::lock_guard lock{cacheMutex};
+
+    if (auto image{cache[key].lock()}; image != nullptr)
+    {
+        return image;
+    }
+
+    std::erase_if(cache, [](const auto& entry) { return entry.second.expired(); });
+
+    std::shared_ptr<const RomImage> image{new RomImage{path}};
+
+    cache[key] = image;
+    return image;
+}
+
+RomImage::RomImage(const std::filesystem::path& path)
+{
+    const auto size{std::filesystem::file_size(path)};
+
+    if (size < MIN_SIZE)
+    {
+        throw std::runtime_error(std::format("Cartridge size ({:#010x}) is too small.", size));
+    }
+
+#ifdef GBEMU_ROM_MAPPING_SUPPORTED
+    /* Bytes past the end of the file cannot be mapped: pad a truncated dump in a copy. */
+    if (size % BANK_SIZE == 0)
+    {
+        map(path, size);
+    }
+    else
+#endif
+    {
+        copy(path, size);
+    }
+
+    uint8_t checksum{0};
+
+    for (std::size_t address{0x0134}; address <= 0x014C; ++address)
+    {
+        checksum = static_cast<uint8_t>(checksum - _data[address] - 1);
+    }
+
+    if (checksum != _data[0x014D])
+    {
+        throw std::runtime_error(
+            std::format("Header checksum ({:#04x}) does not match the header ({:#04x}).", _data[0x014D], checksum));
+    }
+
+    _header = {
+        .title       = {reinterpret_cast<const char*>(&_data[0x0134]), 16},
+        .newLicensee = {reinterpret_cast<const char*>(&_data[0x0144]), 2},
+        .oldLicensee = _data[0x014B],
+        .type        = _data[0x0147],
+        .romSize     = _data[0x0148],
+        .ramSize     = _data[0x0149],
+    };
+}
+
+RomImage::Mapping::~Mapping()
+{
+#ifdef GBEMU_ROM_MAPPING_SUPPORTED
+    if (address != nullptr)
+    {
+        munmap(address, size);
+    }
+#endif
+}
+
+std::span<const uint8_t> RomImage::getData() const noexcept
+{
+    return _data;
+}
+
+const RomImage::Header& RomImage::getHeader() const noexcept
+{
+    return _header;
+}
+
+void RomImage::map(const std::filesystem::path& path, const std::size_t size)
+{
+#ifdef GBEMU_ROM_MAPPING_SUPPORTED
+    const auto file{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+
+    if (file < 0)
+    {
+        throw std::runtime_error(std::format("Cannot open {}.", path.string()));
+    }
+
+    void* mapping{mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0)};
+
+    /* The mapping holds its own reference to the file. */
+    ::close(file);
+
+    if (mapping == MAP_FAILED)
+    {
+        throw std::runtime_error(std::format("Cannot map {}.", path.string()));
+    }
+
+    _mapping.address = mapping;
+    _mapping.size    = size;
+    _data            = {static_cast<const uint8_t*>(mapping), size};
+#else
+    (void) path;
+    (void) size;
+#endif
+}
+
+void RomImage::copy(const std::filesystem::path& path, const std::size_t size)
+{
+    std::ifstream input{path, std::ios::binary};
+
+    input.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+
+    _copy.resize((size + BANK_SIZE - 1) / BANK_SIZE * BANK_SIZE, 0xFF);
+    input.read(reinterpret_cast<char*>(_copy.data()), static_cast<std::streamsize>(size));
+
+    _data = _copy;
+}
@@ -0,0 +1,237 @@
+#include "hardware/SaveFile.hxx"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GBEMU_SAVE_MAPPING_SUPPORTED
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+SaveFile::SaveFile(std::filesystem::path path, const std::size_t size, const Mode mode)
+    : _path(std::move(path)), _mode(mode)
+{
+#ifndef GBEMU_SAVE_MAPPING_SUPPORTED
+    _mode = Mode::COPY;
+#endif
+
+    _ram.assign(size, 0xFF);
+
+    if (_mode == Mode::MAPPED)
+    {
+        map();
+    }
+    else
+    {
+        load();
+        _pending.resize(size);
+    }
+
+    _thread = std::jthread{[this](const std::stop_token& stopToken) { run(stopToken); }};
+}
+
+SaveFile::~SaveFile()
+{
+    _thread.request_stop();
+    _thread.join();
+
+#ifdef GBEMU_SAVE_MAPPING_SUPPORTED
+    if (_mode == Mode::MAPPED)
+    {
+        msync(_mapping.data(), _mapping.size(), MS_SYNC);
+        munmap(_mapping.data(), _mapping.size());
+        return;
+    }
+#endif
+
+    try
+    {
+        if (_isDirty || _hasFailed.load(std::memory_order_acquire))
+        {
+            write(_ram);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        /* Nobody is left to take the error. */
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+std::span<uint8_t> SaveFile::getRam() noexcept
+{
+    return _mode == Mode::MAPPED ? _mapping : std::span<uint8_t>{_ram};
+}
+
+void SaveFile::commit()
+{
+    if (_isPending.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    /* The RAM still holds the changes which could not be written: they go along with the new ones. */
+    if (_hasFailed.exchange(false, std::memory_order_acquire))
+    {
+        _isDirty = true;
+    }
+
+    if (!_isDirty)
+    {
+        return;
+    }
+
+    if (_mode == Mode::COPY)
+    {
+        std::ranges::copy(_ram, _pending.begin());
+    }
+
+    _isDirty = false;
+
+    {
+        /* Only held by the background thread while it checks for pending changes, never while writing them. */
+        const std::lock_guard lock{_mutex};
+
+        _isPending.store(true, std::memory_order_release);
+    }
+
+    _wakeUp.notify_one();
+}
+
+std::optional<std::string> SaveFile::takeError()
+{
+    const std::lock_guard lock{_mutex};
+
+    return std::exchange(_error, std::nullopt);
+}
+
+void SaveFile::run(const std::stop_token& stopToken)
+{
+    std::unique_lock lock{_mutex};
+
+    while (_wakeUp.wait(lock, stopToken, [this] { return _isPending.load(std::memory_order_acquire); }))
+    {
+        lock.unlock();
+
+        try
+        {
+#ifdef GBEMU_SAVE_MAPPING_SUPPORTED
+            if (_mode == Mode::MAPPED)
+            {
+                msync(_mapping.data(), _mapping.size(), MS_ASYNC);
+            }
+            else
+#endif
+            {
+                write(_pending);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            /* The next commit tries again. */
+            const std::lock_guard errorLock{_mutex};
+
+            _error = e.what();
+            _hasFailed.store(true, std::memory_order_release);
+        }
+
+        _isPending.store(false, std::memory_order_release);
+        lock.lock();
+    }
+}
+
+void SaveFile::load()
+{
+    if (!std::filesystem::exists(_path))
+    {
+        return;
+    }
+
+    std::ifstream input{_path, std::ios::binary};
+
+    input.exceptions(std::ifstream::badbit);
+    input.read(reinterpret_cast<char*>(_ram.data()), static_cast<std::streamsize>(_ram.size()));
+}
+
+void SaveFile::map()
+{
+#ifdef GBEMU_SAVE_MAPPING_SUPPORTED
+    const auto file{::open(_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644)};
+
+    if (file < 0)
+    {
+        throw std::runtime_error(std::format("Cannot open save file {}.", _path.string()));
+    }
+
+    struct stat status{};
+    void*       mapping{MAP_FAILED};
+
+    /* Grow a shorter save up to the size of the RAM, which the mapping covers. */
+    if (fstat(file, &status) == 0 && (static_cast<std::size_t>(status.st_size) >= _ram.size() ||
+                                      ftruncate(file, static_cast<off_t>(_ram.size())) == 0))
+    {
+        mapping = mmap(nullptr, _ram.size(), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    }
+
+    /* The mapping holds its own reference to the file. */
+    ::close(file);
+
+    if (mapping == MAP_FAILED)
+    {
+        throw std::runtime_error(std::format("Cannot map save file {}.", _path.string()));
+    }
+
+    const auto existingSize{std::min(static_cast<std::size_t>(status.st_size), _ram.size())};
+
+    _mapping = {static_cast<uint8_t*>(mapping), _ram.size()};
+    std::fill(_mapping.begin() + static_cast<std::ptrdiff_t>(existingSize), _mapping.end(), 0xFF);
+    _ram.clear();
+#endif
+}
+
+void SaveFile::write(const std::span<const uint8_t> ram) const
+{
+    auto temporaryPath{_path};
+
+    temporaryPath += ".tmp";
+
+#ifdef GBEMU_SAVE_MAPPING_SUPPORTED
+    /* The temporary file must reach the disk before the rename does. */
+    const auto file{::open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)};
+    auto       isWritten{file >= 0};
+
+    for (std::size_t offset{0}; isWritten && offset < ram.size();)
+    {
+        const auto written{::write(file, ram.data() + offset, ram.size() - offset)};
+
+        isWritten = written > 0;
+        offset += isWritten ? static_cast<std::size_t>(written) : 0;
+    }
+
+    isWritten = isWritten && fsync(file) == 0;
+
+    if (file >= 0)
+    {
+        ::close(file);
+    }
+    if (!isWritten)
+    {
+        throw std::runtime_error(std::format("Cannot write save file {}.", temporaryPath.string()));
+    }
+#else
+    std::ofstream output{temporaryPath, std::ios::binary | std::ios::trunc};
+
+    output.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+    output.write(reinterpret_cast<const char*>(ram.data()), static_cast<std::streamsize>(ram.size()));
+    output.close();
+#endif
+
+    std::filesystem::rename(temporaryPath, _path);
+}
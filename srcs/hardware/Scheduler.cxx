@@ -0,0 +1,89 @@
+#include "hardware/Scheduler.hxx"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+Scheduler::Scheduler()
+{
+    _deadlines.fill(NEVER);
+}
+
+void Scheduler::setHandler(const Event event, IHandler& handler)
+{
+    _handlers[static_cast<std::size_t>(event)] = &handler;
+}
+
+void Scheduler::schedule(const Event event, const Timestamp timestamp)
+{
+    if (timestamp <= _timestamp)
+    {
+        throw std::logic_error(std::format("Event {:d} scheduled in the past", static_cast<std::size_t>(event)));
+    }
+
+    auto& deadline{_deadlines[static_cast<std::size_t>(event)]};
+
+    /* Moving the earliest event later may leave another one the earliest. */
+    if (deadline == _nextDeadline && timestamp > deadline)
+    {
+        deadline = timestamp;
+        updateNextDeadline();
+        return;
+    }
+
+    deadline      = timestamp;
+    _nextDeadline = std::min(_nextDeadline, timestamp);
+}
+
+void Scheduler::cancel(const Event event)
+{
+    _deadlines[static_cast<std::size_t>(event)] = NEVER;
+    updateNextDeadline();
+}
+
+bool Scheduler::isScheduled(const Event event) const noexcept
+{
+    return _deadlines[static_cast<std::size_t>(event)] != NEVER;
+}
+
+Scheduler::Timestamp Scheduler::getDeadline(const Event event) const noexcept
+{
+    return _deadlines[static_cast<std::size_t>(event)];
+}
+
+void Scheduler::skip(const Timestamp machineCycles)
+{
+    if (machineCycles >= _nextDeadline - _timestamp)
+    {
+        throw std::logic_error(std::format("Skipping {:d} machine cycles would miss an event", machineCycles));
+    }
+
+    _timestamp += machineCycles;
+}
+
+void Scheduler::dispatch(const Timestamp timestamp)
+{
+    /* A handler may schedule or cancel any event, so the deadlines are checked as they are reached. */
+    for (std::size_t event{0}; event < EVENT_COUNT; ++event)
+    {
+        if (_deadlines[event] > timestamp)
+        {
+            continue;
+        }
+
+        if (_handlers[event] == nullptr)
+        {
+            throw std::logic_error(std::format("No handler for event {:d}", event));
+        }
+
+        _deadlines[event] = NEVER;
+        _handlers[event]->onEvent(static_cast<Event>(event), timestamp);
+    }
+
+    updateNextDeadline();
+}
+
+void Scheduler::updateNextDeadline() noexcept
+{
+    _nextDeadline = std::ranges::min(_deadlines);
+}
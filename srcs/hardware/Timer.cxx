@@ -4,6 +4,7 @@
 
 #include "hardware/Timer.hxx"
 
+#include <array>
 #include <chrono>
 #include <format>
 #include <stdexcept>
@@ -11,12 +12,25 @@
 #include "Common.hxx"
 #include "hardware/Bus.hxx"
 
-Timer::Timer(IAddressable& bus) : bus(bus) {}
+namespace
+{
+    /**
+     * @brief System counter bit selected by the "Clock select" bits of TAC.
+     */
+    constexpr std::array<uint8_t, 4> SELECTED_BITS{7, 1, 3, 5};
+}  // namespace
+
+Timer::Timer(IAddressable& bus, Scheduler& scheduler) : bus(bus), scheduler(scheduler)
+{
+    scheduler.setHandler(Scheduler::Event::TIMER, *this);
+}
 
 Timer::~Timer() = default;
 
 void Timer::write(uint16_t address, const uint8_t value)
 {
+    synchronize(scheduler.getTimestamp());
+
     switch (address)
     {
         case MemoryMap::IORegisters::DIV:
@@ -103,9 +117,19 @@ void Timer::write(uint16_t address, const uint8_t value)
         default:
             throw std::logic_error(std::format("Invalid timer write at 0x{:04X}", address));
     };
+
+    schedule();
 }
 
 uint8_t Timer::read(const uint16_t address) const
+{
+    /* Reads are const to the bus, but have to observe the timer as of now. */
+    const_cast<Timer&>(*this).synchronize(scheduler.getTimestamp());
+
+    return peek(address);
+}
+
+uint8_t Timer::peek(const uint16_t address) const
 {
     switch (address)
     {
@@ -127,27 +151,111 @@ IAddressable::AddressableRange Timer::getAddressableRange() const noexcept
             MemoryMap::IORegisters::TAC};
 }
 
-void Timer::tick(const size_t machineCycle)
+void Timer::onEvent(Scheduler::Event event, const Scheduler::Timestamp timestamp)
+{
+    (void) event;
+
+    synchronize(timestamp);
+    schedule();
+}
+
+void Timer::synchronize(const Scheduler::Timestamp timestamp)
 {
-    for (size_t i{0}; i < machineCycle; ++i)
+    if (timestamp <= synchronizedAt)
     {
-        switch (state)
+        return;
+    }
+
+    auto machineCycles{static_cast<size_t>(timestamp - synchronizedAt)};
+
+    synchronizedAt = timestamp;
+
+    while (machineCycles > 0)
+    {
+        /* The overflow sequence, and the cycle after a TAC write (which does not update the last bit), are stepped. */
+        if (state != State::NORMAL || lastBit != getSelectedBit())
         {
-            case State::NORMAL:
-                break;
-            case State::SCHEDULE_INTERRUPT_AND_TMA_RELOAD:
-                state = State::RELOADING_TIMA_TO_TMA;
-                TIMA  = TMA;
-                bus.write(MemoryMap::IORegisters::IF, bus.read(MemoryMap::IORegisters::IF) | Interrupts::Timer);
-                break;
-            case State::RELOADING_TIMA_TO_TMA:
-                state = State::NORMAL;
+            step();
+            machineCycles -= 1;
+            continue;
         }
 
-        setSystemCounter(system_counter + 1);
+        if ((TAC & 0b100) == 0)
+        {
+            system_counter = static_cast<uint16_t>(system_counter + machineCycles);
+            return;
+        }
+
+        /* Otherwise, TIMA only changes on the falling edges of the selected bit, which can be counted. */
+        const auto toOverflow{getMachineCyclesToEdge(0x100 - TIMA)};
+
+        if (machineCycles < toOverflow)
+        {
+            const auto shift{SELECTED_BITS[TAC & 0b11] + 1};
+
+            TIMA += static_cast<uint8_t>(((system_counter + machineCycles) >> shift) - (system_counter >> shift));
+            system_counter = static_cast<uint16_t>(system_counter + machineCycles);
+            lastBit        = getSelectedBit();
+            return;
+        }
+
+        /* Stop right before the overflowing edge, and step through it. */
+        TIMA           = 0xFF;
+        system_counter = static_cast<uint16_t>(system_counter + toOverflow - 1);
+        lastBit        = getSelectedBit();
+        step();
+        machineCycles -= toOverflow;
     }
 }
 
+void Timer::step()
+{
+    switch (state)
+    {
+        case State::NORMAL:
+            break;
+        case State::SCHEDULE_INTERRUPT_AND_TMA_RELOAD:
+            state = State::RELOADING_TIMA_TO_TMA;
+            TIMA  = TMA;
+            bus.write(MemoryMap::IORegisters::IF, bus.read(MemoryMap::IORegisters::IF) | Interrupts::Timer);
+            break;
+        case State::RELOADING_TIMA_TO_TMA:
+            state = State::NORMAL;
+    }
+
+    setSystemCounter(system_counter + 1);
+}
+
+void Timer::schedule()
+{
+    if (state != State::NORMAL || lastBit != getSelectedBit())
+    {
+        scheduler.schedule(Scheduler::Event::TIMER, synchronizedAt + 1);
+    }
+    else if ((TAC & 0b100) == 0)
+    {
+        scheduler.cancel(Scheduler::Event::TIMER);
+    }
+    else
+    {
+        /* The interrupt is requested on the cycle following the overflow. */
+        scheduler.schedule(Scheduler::Event::TIMER, synchronizedAt + getMachineCyclesToEdge(0x100 - TIMA) + 1);
+    }
+}
+
+size_t Timer::getMachineCyclesToEdge(const size_t edge) const noexcept
+{
+    /* The selected bit falls whenever the system counter reaches a multiple of twice its weight. */
+    const auto shift{SELECTED_BITS[TAC & 0b11] + 1};
+
+    return (((static_cast<size_t>(system_counter) >> shift) + edge) << shift) - system_counter;
+}
+
+bool Timer::getSelectedBit() const noexcept
+{
+    return (TAC & 0b100) != 0 && (system_counter >> SELECTED_BITS[TAC & 0b11] & 1) != 0;
+}
+
 void Timer::setSystemCounter(const uint16_t value)
 {
     uint8_t bitSet{false};
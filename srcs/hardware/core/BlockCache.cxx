@@ -0,0 +1,281 @@
+#include <Utils.hxx>
+
+#include "hardware/core/SM83.hxx"
+
+namespace
+{
+    constexpr MemoryMap::AddressRange ROM_BANK_0{0x0000, 0x3FFF};
+    constexpr MemoryMap::AddressRange ROM_BANK_N{0x4000, 0x7FFF};
+
+    /**
+     * @brief Machine cycles of the base instruction set, with conditional branches not taken. Illegal opcodes and the
+     * 0xCB prefix are zero.
+     */
+    constexpr std::array<uint8_t, 0x100> machineCycles{{
+        1, 3, 2, 2, 1, 1, 2, 1, 5, 2, 2, 2, 1, 1, 2, 1,  // 0x00
+        1, 3, 2, 2, 1, 1, 2, 1, 3, 2, 2, 2, 1, 1, 2, 1,  // 0x10
+        2, 3, 2, 2, 1, 1, 2, 1, 2, 2, 2, 2, 1, 1, 2, 1,  // 0x20
+        2, 3, 2, 2, 3, 3, 3, 1, 2, 2, 2, 2, 1, 1, 2, 1,  // 0x30
+        1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,  // 0x40
+        1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,  // 0x50
+        1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,  // 0x60
+        2, 2, 2, 2, 2, 2, 1, 2, 1, 1, 1, 1, 1, 1, 2, 1,  // 0x70
+        1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,  // 0x80
+        1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,  // 0x90
+        1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,  // 0xA0
+        1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,  // 0xB0
+        2, 3, 3, 4, 3, 4, 2, 4, 2, 4, 3, 0, 3, 6, 2, 4,  // 0xC0
+        2, 3, 3, 0, 3, 4, 2, 4, 2, 4, 3, 0, 3, 0, 2, 4,  // 0xD0
+        3, 3, 2, 0, 0, 4, 2, 4, 4, 1, 4, 0, 0, 0, 2, 4,  // 0xE0
+        3, 3, 2, 1, 0, 4, 2, 4, 3, 2, 4, 1, 0, 0, 2, 4,  // 0xF0
+    }};
+
+    [[nodiscard]] constexpr bool isIllegal(const uint8_t opcode) noexcept
+    {
+        return machineCycles[opcode] == 0 && opcode != 0xCB;
+    }
+
+    /**
+     * @brief Whether the instruction may transfer control somewhere else than the next instruction, or stop the CPU.
+     */
+    [[nodiscard]] constexpr bool endsBlock(const uint8_t opcode) noexcept
+    {
+        switch (opcode)
+        {
+            case 0x10:  // STOP
+            case 0x18:  // JR e8
+            case 0x20:
+            case 0x28:
+            case 0x30:
+            case 0x38:  // JR cc, e8
+            case 0x76:  // HALT
+            case 0xC3:  // JP a16
+            case 0xC2:
+            case 0xCA:
+            case 0xD2:
+            case 0xDA:  // JP cc, a16
+            case 0xCD:  // CALL a16
+            case 0xC4:
+            case 0xCC:
+            case 0xD4:
+            case 0xDC:  // CALL cc, a16
+            case 0xC9:  // RET
+            case 0xD9:  // RETI
+            case 0xC0:
+            case 0xC8:
+            case 0xD0:
+            case 0xD8:  // RET cc
+            case 0xE9:  // JP HL
+                return true;
+            default:
+                /* RST */
+                return (opcode & 0xC7) == 0xC7;
+        }
+    }
+
+    [[nodiscard]] std::optional<MemoryMap::AddressRange> getCacheableRegion(const uint16_t address) noexcept
+    {
+        for (const auto& region : {ROM_BANK_0, ROM_BANK_N, MemoryMap::WORK_RAM, MemoryMap::HIGH_RAM})
+        {
+            if (Utils::addressIn(address, region))
+            {
+                return region;
+            }
+        }
+
+        return std::nullopt;
+    }
+}  // namespace
+
+const SM83::BlockCache::Block* SM83::BlockCache::get(const uint16_t address, const uint16_t bank,
+                                                     const IAddressable& memory)
+{
+    if (const auto* entry{_entries[address]}; entry != nullptr && entry->bank == bank) [[likely]]
+    {
+        return entry;
+    }
+
+    const auto key{static_cast<uint32_t>(bank) << 16 | address};
+
+    if (const auto it{_blocks.find(key)}; it != _blocks.end())
+    {
+        return _entries[address] = &it->second;
+    }
+
+    auto block{decode(address, memory)};
+
+    if (block.instructions.empty())
+    {
+        return nullptr;
+    }
+
+    block.bank = bank;
+    reference(block, 1);
+    _pageKeys[address >> 8].push_back(key);
+
+    return _entries[address] = &_blocks.emplace(key, std::move(block)).first->second;
+}
+
+void SM83::BlockCache::invalidate(const uint16_t address)
+{
+    const std::size_t firstPage{address >= MAX_BLOCK_SIZE ? (address - MAX_BLOCK_SIZE + 1) >> 8 : 0};
+    const std::size_t lastPage{static_cast<std::size_t>(address >> 8)};
+
+    for (auto page{firstPage}; page <= lastPage; ++page)
+    {
+        std::erase_if(_pageKeys[page],
+                      [this, address](const uint32_t key)
+                      {
+                          const auto  it{_blocks.find(key)};
+                          const auto& block{it->second};
+                          const auto& last{block.instructions.back()};
+
+                          if (address < block.instructions.front().address || address >= last.address + last.length)
+                          {
+                              return false;
+                          }
+
+                          if (_entries[block.instructions.front().address] == &block)
+                          {
+                              _entries[block.instructions.front().address] = nullptr;
+                          }
+
+                          reference(block, -1);
+                          _blocks.erase(it);
+                          return true;
+                      });
+    }
+}
+
+void SM83::BlockCache::flush()
+{
+    _blocks.clear();
+    for (auto& keys : _pageKeys)
+    {
+        keys.clear();
+    }
+    _entries.fill(nullptr);
+    _codeReferences.fill(0);
+}
+
+bool SM83::BlockCache::isCacheable(const uint16_t address) noexcept
+{
+    return getCacheableRegion(address).has_value();
+}
+
+uint8_t SM83::BlockCache::getInstructionLength(const uint8_t opcode) noexcept
+{
+    if (isIllegal(opcode))
+    {
+        return 0;
+    }
+
+    switch (opcode)
+    {
+        case 0x01:  // LD rr, n16
+        case 0x11:
+        case 0x21:
+        case 0x31:
+        case 0x08:  // LD (a16), SP
+        case 0xC2:  // JP cc, a16
+        case 0xC3:  // JP a16
+        case 0xCA:
+        case 0xD2:
+        case 0xDA:
+        case 0xC4:  // CALL cc, a16
+        case 0xCC:
+        case 0xD4:
+        case 0xDC:
+        case 0xCD:  // CALL a16
+        case 0xEA:  // LD (a16), A
+        case 0xFA:  // LD A, (a16)
+            return 3;
+        case 0x18:  // JR e8
+        case 0x20:  // JR cc, e8
+        case 0x28:
+        case 0x30:
+        case 0x38:
+        case 0xCB:  // Prefix
+        case 0xE0:  // LDH (a8), A
+        case 0xF0:  // LDH A, (a8)
+        case 0xE8:  // ADD SP, e8
+        case 0xF8:  // LD HL, SP + e8
+            return 2;
+        default:
+            /* LD r, n8 and the ALU operations on n8. */
+            return (opcode & 0xC7) == 0x06 || (opcode & 0xC7) == 0xC6 ? 2 : 1;
+    }
+}
+
+uint8_t SM83::BlockCache::getMachineCycles(const uint8_t opcode, const uint8_t extendedOpcode) noexcept
+{
+    if (opcode != 0xCB)
+    {
+        return machineCycles[opcode];
+    }
+
+    if ((extendedOpcode & 0x07) != 0x06)
+    {
+        return 2;
+    }
+
+    /* BIT b, (HL) does not write back. */
+    return (extendedOpcode & 0xC0) == 0x40 ? 3 : 4;
+}
+
+SM83::BlockCache::Block SM83::BlockCache::decode(const uint16_t address, const IAddressable& memory)
+{
+    Block block{};
+
+    const auto region{getCacheableRegion(address)};
+
+    if (!region)
+    {
+        return block;
+    }
+
+    auto pc{address};
+
+    while (block.instructions.size() < MAX_INSTRUCTIONS_PER_BLOCK)
+    {
+        const auto opcode{memory.read(pc)};
+        const auto length{getInstructionLength(opcode)};
+
+        /* Illegal instructions, and instructions running out of the region, are left to the interpreter. */
+        if (length == 0 || pc + length - 1 > region->second)
+        {
+            break;
+        }
+
+        Instruction instruction{.address = pc, .length = length};
+
+        for (uint8_t i{0}; i < length; ++i)
+        {
+            instruction.bytes[i] = memory.read(pc + i);
+        }
+
+        instruction.machineCycles = getMachineCycles(opcode, instruction.bytes[1]);
+        block.machineCycles += instruction.machineCycles;
+        block.instructions.push_back(instruction);
+
+        pc += length;
+
+        if (endsBlock(opcode))
+        {
+            break;
+        }
+    }
+
+    return block;
+}
+
+void SM83::BlockCache::reference(const Block& block, const int delta)
+{
+    for (const auto& instruction : block.instructions)
+    {
+        for (uint8_t i{0}; i < instruction.length; ++i)
+        {
+            _codeReferences[static_cast<uint16_t>(instruction.address + i)] += delta;
+        }
+    }
+}
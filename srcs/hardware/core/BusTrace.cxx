@@ -0,0 +1,139 @@
+#include "hardware/core/BusTrace.hxx"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <format>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace BusTrace
+{
+    RingBuffer::RingBuffer(const std::size_t capacity)
+        : _records(std::bit_ceil(capacity)), _mask(std::bit_ceil(capacity) - 1)
+    {
+    }
+
+    bool RingBuffer::push(const Record& record) noexcept
+    {
+        const auto head{_head.load(std::memory_order_relaxed)};
+
+        if (head - _tail.load(std::memory_order_acquire) == _records.size()) [[unlikely]]
+        {
+            _dropped += 1;
+            return false;
+        }
+
+        _records[head & _mask] = record;
+        _head.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    std::size_t RingBuffer::pop(const std::span<Record> records) noexcept
+    {
+        const auto tail{_tail.load(std::memory_order_relaxed)};
+        const auto count{std::min(records.size(), _head.load(std::memory_order_acquire) - tail)};
+
+        for (std::size_t index{0}; index < count; ++index)
+        {
+            records[index] = _records[(tail + index) & _mask];
+        }
+
+        _tail.store(tail + count, std::memory_order_release);
+
+        return count;
+    }
+
+    std::size_t RingBuffer::getDropped() const noexcept
+    {
+        return _dropped;
+    }
+
+    Writer::Writer(RingBuffer& ringBuffer, const std::string& path)
+        : _ringBuffer(ringBuffer), _file(path, std::ios::binary | std::ios::trunc)
+    {
+        if (!_file)
+        {
+            throw std::runtime_error(std::format("Cannot open trace file {}", path));
+        }
+
+        const FileHeader header{};
+
+        _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        _thread = std::jthread{[this](const std::stop_token& stopToken) { run(stopToken); }};
+    }
+
+    void Writer::stop()
+    {
+        if (_thread.joinable())
+        {
+            _thread.request_stop();
+            _thread.join();
+        }
+    }
+
+    bool Writer::hasFailed() const noexcept
+    {
+        return _hasFailed.load(std::memory_order_acquire);
+    }
+
+    void Writer::run(const std::stop_token& stopToken)
+    {
+        std::vector<Record> records(4096);
+
+        while (true)
+        {
+            /* Checked before popping, so that whatever was pushed before the stop request gets written. */
+            const auto isStopping{stopToken.stop_requested()};
+            const auto count{_ringBuffer.pop(records)};
+
+            _file.write(reinterpret_cast<const char*>(records.data()),
+                        static_cast<std::streamsize>(count * sizeof(Record)));
+
+            /* The ring buffer is drained on failure too: the records are lost, but not counted as dropped. */
+            if (!_file) [[unlikely]]
+            {
+                _hasFailed.store(true, std::memory_order_release);
+            }
+
+            if (count == 0)
+            {
+                if (isStopping)
+                {
+                    break;
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+        }
+
+        if (!_file.flush())
+        {
+            _hasFailed.store(true, std::memory_order_release);
+        }
+    }
+
+    void decode(std::istream& input, std::ostream& output)
+    {
+        FileHeader header{};
+
+        if (!input.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != FileHeader::MAGIC)
+        {
+            throw std::runtime_error("Not a trace file");
+        }
+        if (header.version != FileHeader::VERSION || header.recordSize != sizeof(Record))
+        {
+            throw std::runtime_error(std::format("Unsupported trace file version {:d}", header.version));
+        }
+
+        Record record{};
+
+        while (input.read(reinterpret_cast<char*>(&record), sizeof(record)))
+        {
+            output << std::format("{:>12d} {:04X} {:c} {:04X} {:02X}\n", record.timestamp, record.pc,
+                                  static_cast<char>(record.kind), record.address, record.value);
+        }
+    }
+}  // namespace BusTrace
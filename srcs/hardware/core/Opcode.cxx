@@ -3,1608 +3,594 @@
 //
 
 #include <format>
+#include <utility>
 
 #include "Utils.hxx"
 #include "hardware/core/SM83.hxx"
 
+/**
+ * @note Opcodes are decoded at compile time following the x/y/z/p/q split of the opcode bits:
+ * https://gb-archive.github.io/salvage/decoding_gbz80_opcodes/Decoding%20Gamboy%20Z80%20opcodes.html
+ *
+ *   Bit:  7 6 | 5 4 3 | 2 1 0
+ *          x  |   y   |   z
+ *             | p   q |
+ *
+ * Each opcode gets its own handler, instantiated from the templates below and gathered in a 256 entries table, so
+ * that the operands (registers, conditions, ALU operation...) are never re-derived at run time.
+ */
+
+const SM83::InstructionTable SM83::instructionTable{
+    []<std::size_t... Opcodes>(std::index_sequence<Opcodes...>)
+    {
+        return InstructionTable{&SM83::executeInstruction<static_cast<uint8_t>(Opcodes)>...};
+    }(std::make_index_sequence<0x100>{})};
+
+const SM83::InstructionTable SM83::extendedInstructionTable{
+    []<std::size_t... Opcodes>(std::index_sequence<Opcodes...>)
+    {
+        return InstructionTable{&SM83::executeExtendedInstruction<static_cast<uint8_t>(Opcodes)>...};
+    }(std::make_index_sequence<0x100>{})};
+
 /**
  * Executes decode, and execute cycle for a SM83 instruction.
  *
- * This method performs the fetching of the instruction from memory, decoding
- * the instruction to determine its intended operation, and executing the
- * corresponding action. Depending on the provided instruction set mode, it
- * may execute standard or extended operations.
+ * The instruction stored in the IR register is dispatched to its handler through the instruction tables.
  *
  * @param extended_set Determines whether to use the extended instruction set.
  *                     Pass `true` to activate instructions from the extended set (0xCB prefixed),
  *                     otherwise pass `false` to execute standard instructions.
  */
-void SM83::decodeExecuteInstruction(const bool extended_set)  // NOLINT
+void SM83::decodeExecuteInstruction(const bool extended_set)
 {
     if (!extended_set)
     {
-        switch (IR)
+        (this->*instructionTable[_registers.IR])();
+    }
+    else
+    {
+        (this->*extendedInstructionTable[_registers.IR])();
+    }
+}
+
+template <SM83::Operand8 Operand>
+uint8_t SM83::readOperand()
+{
+    if constexpr (Operand == Operand8::B)
+    {
+        return _registers.B;
+    }
+    else if constexpr (Operand == Operand8::C)
+    {
+        return _registers.C;
+    }
+    else if constexpr (Operand == Operand8::D)
+    {
+        return _registers.D;
+    }
+    else if constexpr (Operand == Operand8::E)
+    {
+        return _registers.E;
+    }
+    else if constexpr (Operand == Operand8::H)
+    {
+        return _registers.H;
+    }
+    else if constexpr (Operand == Operand8::L)
+    {
+        return _registers.L;
+    }
+    else if constexpr (Operand == Operand8::IndirectHL)
+    {
+        return fetchMemory(_registers.HL);
+    }
+    else
+    {
+        return _registers.A;
+    }
+}
+
+template <SM83::Operand8 Operand>
+void SM83::writeOperand(const uint8_t value)
+{
+    if constexpr (Operand == Operand8::B)
+    {
+        _registers.B = value;
+    }
+    else if constexpr (Operand == Operand8::C)
+    {
+        _registers.C = value;
+    }
+    else if constexpr (Operand == Operand8::D)
+    {
+        _registers.D = value;
+    }
+    else if constexpr (Operand == Operand8::E)
+    {
+        _registers.E = value;
+    }
+    else if constexpr (Operand == Operand8::H)
+    {
+        _registers.H = value;
+    }
+    else if constexpr (Operand == Operand8::L)
+    {
+        _registers.L = value;
+    }
+    else if constexpr (Operand == Operand8::IndirectHL)
+    {
+        writeMemory(_registers.HL, value);
+    }
+    else
+    {
+        _registers.A = value;
+    }
+}
+
+template <SM83::Operand16 Operand>
+uint16_t SM83::readOperand() const
+{
+    if constexpr (Operand == Operand16::BC)
+    {
+        return _registers.BC;
+    }
+    else if constexpr (Operand == Operand16::DE)
+    {
+        return _registers.DE;
+    }
+    else if constexpr (Operand == Operand16::HL)
+    {
+        return _registers.HL;
+    }
+    else if constexpr (Operand == Operand16::SP)
+    {
+        return _registers.SP;
+    }
+    else
+    {
+        return AF();
+    }
+}
+
+template <SM83::Operand16 Operand>
+void SM83::writeOperand(const uint16_t value)
+{
+    if constexpr (Operand == Operand16::BC)
+    {
+        _registers.BC = value;
+    }
+    else if constexpr (Operand == Operand16::DE)
+    {
+        _registers.DE = value;
+    }
+    else if constexpr (Operand == Operand16::HL)
+    {
+        _registers.HL = value;
+    }
+    else if constexpr (Operand == Operand16::SP)
+    {
+        _registers.SP = value;
+    }
+    else
+    {
+        AF(value);
+    }
+}
+
+template <uint8_t Operation>
+void SM83::alu(const uint8_t value)
+{
+    if constexpr (Operation == 0)
+    {
+        _registers.A = add(_registers.A, value);
+    }
+    else if constexpr (Operation == 1)
+    {
+        _registers.A = add(_registers.A, value, true);
+    }
+    else if constexpr (Operation == 2)
+    {
+        _registers.A = sub(_registers.A, value);
+    }
+    else if constexpr (Operation == 3)
+    {
+        _registers.A = sub(_registers.A, value, true);
+    }
+    else if constexpr (Operation == 4)
+    {
+        _registers.A = bitwiseAnd(_registers.A, value);
+    }
+    else if constexpr (Operation == 5)
+    {
+        _registers.A = bitwise_xor(_registers.A, value);
+    }
+    else if constexpr (Operation == 6)
+    {
+        _registers.A = bitwiseOr(_registers.A, value);
+    }
+    else
+    {
+        (void) sub(_registers.A, value);
+    }
+}
+
+template <uint8_t Opcode>
+void SM83::executeInstruction()  // NOLINT
+{
+    constexpr uint8_t x{Opcode >> 6};
+    constexpr uint8_t y{(Opcode >> 3) & 0x07};
+    constexpr uint8_t z{Opcode & 0x07};
+    constexpr uint8_t p{y >> 1};
+    constexpr uint8_t q{y & 0x01};
+
+    constexpr auto r8Y{static_cast<Operand8>(y)};
+    constexpr auto r8Z{static_cast<Operand8>(z)};
+    constexpr auto r16P{static_cast<Operand16>(p)};
+    constexpr auto r16PStack{p == 3 ? Operand16::AF : static_cast<Operand16>(p)};
+    constexpr auto conditionalY{static_cast<Conditionals>(y & 0x03)};
+
+    if constexpr (x == 0)
+    {
+        if constexpr (z == 0)
         {
-            case 0x00:
-                break;
-            case 0x01:
-                C = fetchOperand();
-                B = fetchOperand();
-                break;
-            case 0x02:
-                writeMemory(BC(), A);
-                break;
-            case 0x03:
-                onMachineCycle();
-                BC(BC() + 1);
-                break;
-            case 0x04:
-                B = inc(B);
-                break;
-            case 0x05:
-                B = dec(B);
-                break;
-            case 0x06:
-                B = fetchOperand();
-                break;
-            case 0x07:
-                A = rotate_left(A, true);
-                setFlag(Flags::Zero, false);
-                break;
-            case 0x08:
+            if constexpr (y == 0)
+            {
+                /* NOP */
+            }
+            else if constexpr (y == 1)
             {
                 const auto lsb{fetchOperand()};
                 const auto msb{fetchOperand()};
                 const auto address{Utils::to_word(msb, lsb)};
 
-                writeMemory(address, Utils::wordLsb(SP));
-                writeMemory(address + 1, Utils::wordMsb(SP));
+                writeMemory(address, Utils::wordLsb(_registers.SP));
+                writeMemory(address + 1, Utils::wordMsb(_registers.SP));
             }
-            break;
-            case 0x09:
-                onMachineCycle();
-                HL(add(HL(), BC()));
-                break;
-            case 0x0A:
-                A = fetchMemory(BC());
-                break;
-            case 0x0B:
-                onMachineCycle();
-                BC(BC() - 1);
-                break;
-            case 0x0C:
-                C = inc(C);
-                break;
-            case 0x0D:
-                C = dec(C);
-                break;
-            case 0x0E:
-                C = fetchOperand();
-                break;
-            case 0x0F:
-                A = rotate_right(A, true);
-                setFlag(Flags::Zero, false);
-                break;
-            case 0x10:
+            else if constexpr (y == 2)
+            {
                 state = State::STOPPED;
-                break;
-            case 0x11:
-                E = fetchOperand();
-                D = fetchOperand();
-                break;
-            case 0x12:
-                writeMemory(DE(), A);
-                break;
-            case 0x13:
-                onMachineCycle();
-                DE(DE() + 1);
-                break;
-            case 0x14:
-                D = inc(D);
-                break;
-            case 0x15:
-                D = dec(D);
-                break;
-            case 0x16:
-                D = fetchOperand();
-                break;
-            case 0x17:
-                A = rotate_left(A, false);
-                setFlag(Flags::Zero, false);
-                break;
-            case 0x18:
+            }
+            else if constexpr (y == 3)
+            {
                 jr();
-                break;
-            case 0x19:
-                onMachineCycle();
-                HL(add(HL(), DE()));
-                break;
-            case 0x1A:
-                A = fetchMemory(DE());
-                break;
-            case 0x1B:
+            }
+            else
+            {
+                jr_cc(conditionalY);
+            }
+        }
+        else if constexpr (z == 1)
+        {
+            if constexpr (q == 0)
+            {
+                const auto lsb{fetchOperand()};
+                const auto msb{fetchOperand()};
+
+                writeOperand<r16P>(Utils::to_word(msb, lsb));
+            }
+            else
+            {
                 onMachineCycle();
-                DE(DE() - 1);
-                break;
-            case 0x1C:
-                E = inc(E);
-                break;
-            case 0x1D:
-                E = dec(E);
-                break;
-            case 0x1E:
-                E = fetchOperand();
-                break;
-            case 0x1F:
-                A = rotate_right(A, false);
+                _registers.HL = add(_registers.HL, readOperand<r16P>());
+            }
+        }
+        else if constexpr (z == 2)
+        {
+            /* LD (BC),A / LD (DE),A / LD (HL+),A / LD (HL-),A and their loading counterparts. */
+            constexpr auto address{p == 0 ? Operand16::BC : p == 1 ? Operand16::DE : Operand16::HL};
+
+            if constexpr (q == 0)
+            {
+                writeMemory(readOperand<address>(), _registers.A);
+            }
+            else
+            {
+                _registers.A = fetchMemory(readOperand<address>());
+            }
+
+            if constexpr (p == 2)
+            {
+                _registers.HL += 1;
+            }
+            else if constexpr (p == 3)
+            {
+                _registers.HL -= 1;
+            }
+        }
+        else if constexpr (z == 3)
+        {
+            onMachineCycle();
+            if constexpr (q == 0)
+            {
+                writeOperand<r16P>(readOperand<r16P>() + 1);
+            }
+            else
+            {
+                writeOperand<r16P>(readOperand<r16P>() - 1);
+            }
+        }
+        else if constexpr (z == 4)
+        {
+            writeOperand<r8Y>(inc(readOperand<r8Y>()));
+        }
+        else if constexpr (z == 5)
+        {
+            writeOperand<r8Y>(dec(readOperand<r8Y>()));
+        }
+        else if constexpr (z == 6)
+        {
+            writeOperand<r8Y>(fetchOperand());
+        }
+        else
+        {
+            if constexpr (y == 0)
+            {
+                _registers.A = rotate_left(_registers.A, true);
                 setFlag(Flags::Zero, false);
-                break;
-            case 0x20:
-                jr_cc(Conditionals::NZ);
-                break;
-            case 0x21:
-                L = fetchOperand();
-                H = fetchOperand();
-                break;
-            case 0x22:
-                writeMemory(HL(), A);
-                HL(HL() + 1);
-                break;
-            case 0x23:
-                onMachineCycle();
-                HL(HL() + 1);
-                break;
-            case 0x24:
-                H = inc(H);
-                break;
-            case 0x25:
-                H = dec(H);
-                break;
-            case 0x26:
-                H = fetchOperand();
-                break;
-            case 0x27:
+            }
+            else if constexpr (y == 1)
+            {
+                _registers.A = rotate_right(_registers.A, true);
+                setFlag(Flags::Zero, false);
+            }
+            else if constexpr (y == 2)
+            {
+                _registers.A = rotate_left(_registers.A, false);
+                setFlag(Flags::Zero, false);
+            }
+            else if constexpr (y == 3)
+            {
+                _registers.A = rotate_right(_registers.A, false);
+                setFlag(Flags::Zero, false);
+            }
+            else if constexpr (y == 4)
+            {
                 daa();
-                break;
-            case 0x28:
-                jr_cc(Conditionals::Z);
-                break;
-            case 0x29:
-                onMachineCycle();
-                HL(add(HL(), HL()));
-                break;
-            case 0x2A:
-                A = fetchMemory(HL());
-                HL(HL() + 1);
-                break;
-            case 0x2B:
-                onMachineCycle();
-                HL(HL() - 1);
-                break;
-            case 0x2C:
-                L = inc(L);
-                break;
-            case 0x2D:
-                L = dec(L);
-                break;
-            case 0x2E:
-                L = fetchOperand();
-                break;
-            case 0x2F:
-                A = ~A;
+            }
+            else if constexpr (y == 5)
+            {
+                _registers.A = ~_registers.A;
                 setFlag(Flags::Subtract, true);
                 setFlag(Flags::HalfCarry, true);
-                break;
-            case 0x30:
-                jr_cc(Conditionals::NC);
-                break;
-            case 0x31:
-                SP = fetchOperand();
-                SP |= fetchOperand() << 8;
-                break;
-            case 0x32:
-                writeMemory(HL(), A);
-                HL(HL() - 1);
-                break;
-            case 0x33:
-                onMachineCycle();
-                SP += 1;
-                break;
-            case 0x34:
-                writeMemory(HL(), inc(fetchMemory(HL())));
-                break;
-            case 0x35:
-                writeMemory(HL(), dec(fetchMemory(HL())));
-                break;
-            case 0x36:
-                writeMemory(HL(), fetchOperand());
-                break;
-            case 0x37:
+            }
+            else if constexpr (y == 6)
+            {
                 setFlag(Flags::Subtract, false);
                 setFlag(Flags::HalfCarry, false);
                 setFlag(Flags::Carry, true);
-                break;
-            case 0x38:
-                jr_cc(Conditionals::C);
-                break;
-            case 0x39:
-                onMachineCycle();
-                HL(add(HL(), SP));
-                break;
-            case 0x3A:
-                A = fetchMemory(HL());
-                HL(HL() - 1);
-                break;
-            case 0x3B:
-                onMachineCycle();
-                SP -= 1;
-                break;
-            case 0x3C:
-                A = inc(A);
-                break;
-            case 0x3D:
-                A = dec(A);
-                break;
-            case 0x3E:
-                A = fetchOperand();
-                break;
-            case 0x3F:
+            }
+            else
+            {
                 setFlag(Flags::Subtract, false);
                 setFlag(Flags::HalfCarry, false);
                 setFlag(Flags::Carry, !getFlag(Flags::Carry));
-                break;
-            case 0x40:
-                break;
-            case 0x41:
-                B = C;
-                break;
-            case 0x42:
-                B = D;
-                break;
-            case 0x43:
-                B = E;
-                break;
-            case 0x44:
-                B = H;
-                break;
-            case 0x45:
-                B = L;
-                break;
-            case 0x46:
-                B = fetchMemory(HL());
-                break;
-            case 0x47:
-                B = A;
-                break;
-            case 0x48:
-                C = B;
-                break;
-            case 0x49:
-                break;
-            case 0x4A:
-                C = D;
-                break;
-            case 0x4B:
-                C = E;
-                break;
-            case 0x4C:
-                C = H;
-                break;
-            case 0x4D:
-                C = L;
-                break;
-            case 0x4E:
-                C = fetchMemory(HL());
-                break;
-            case 0x4F:
-                C = A;
-                break;
-            case 0x50:
-                D = B;
-                break;
-            case 0x51:
-                D = C;
-                break;
-            case 0x52:
-                break;
-            case 0x53:
-                D = E;
-                break;
-            case 0x54:
-                D = H;
-                break;
-            case 0x55:
-                D = L;
-                break;
-            case 0x56:
-                D = fetchMemory(HL());
-                break;
-            case 0x57:
-                D = A;
-                break;
-            case 0x58:
-                E = B;
-                break;
-            case 0x59:
-                E = C;
-                break;
-            case 0x5A:
-                E = D;
-                break;
-            case 0x5B:
-                break;
-            case 0x5C:
-                E = H;
-                break;
-            case 0x5D:
-                E = L;
-                break;
-            case 0x5E:
-                E = fetchMemory(HL());
-                break;
-            case 0x5F:
-                E = A;
-                break;
-            case 0x60:
-                H = B;
-                break;
-            case 0x61:
-                H = C;
-                break;
-            case 0x62:
-                H = D;
-                break;
-            case 0x63:
-                H = E;
-                break;
-            case 0x64:
-                break;
-            case 0x65:
-                H = L;
-                break;
-            case 0x66:
-                H = fetchMemory(HL());
-                break;
-            case 0x67:
-                H = A;
-                break;
-            case 0x68:
-                L = B;
-                break;
-            case 0x69:
-                L = C;
-                break;
-            case 0x6A:
-                L = D;
-                break;
-            case 0x6B:
-                L = E;
-                break;
-            case 0x6C:
-                L = H;
-                break;
-            case 0x6D:
-                break;
-            case 0x6E:
-                L = fetchMemory(HL());
-                break;
-            case 0x6F:
-                L = A;
-                break;
-            case 0x70:
-                writeMemory(HL(), B);
-                break;
-            case 0x71:
-                writeMemory(HL(), C);
-                break;
-            case 0x72:
-                writeMemory(HL(), D);
-                break;
-            case 0x73:
-                writeMemory(HL(), E);
-                break;
-            case 0x74:
-                writeMemory(HL(), H);
-                break;
-            case 0x75:
-                writeMemory(HL(), L);
-                break;
-            case 0x76:
-                if (IME)
+            }
+        }
+    }
+    else if constexpr (x == 1)
+    {
+        if constexpr (Opcode == 0x76)
+        {
+            if (_registers.IME)
+            {
+                if ((_registers.IE & _registers.IF) == 0)
+                {
+                    state = State::HALTED;
+                }
+            }
+            else
+            {
+                if ((_registers.IE & _registers.IF) != 0)
                 {
-                    if ((IE & IF) == 0)
-                    {
-                        state = State::HALTED;
-                    }
+                    state = State::HALTED_BUG;
                 }
                 else
                 {
-                    if ((IE & IF) != 0)
-                    {
-                        state = State::HALTED_BUG;
-                    }
-                    else
-                    {
-                        /* Future interrupt will not be handled but the CPU will exit HALT state */
-                        state = State::HALTED;
-                    }
+                    /* Future interrupt will not be handled but the CPU will exit HALT state */
+                    state = State::HALTED;
                 }
-                break;
-            case 0x77:
-                writeMemory(HL(), A);
-                break;
-            case 0x78:
-                A = B;
-                break;
-            case 0x79:
-                A = C;
-                break;
-            case 0x7A:
-                A = D;
-                break;
-            case 0x7B:
-                A = E;
-                break;
-            case 0x7C:
-                A = H;
-                break;
-            case 0x7D:
-                A = L;
-                break;
-            case 0x7E:
-                A = fetchMemory(HL());
-                break;
-            case 0x7F:
-                break;
-            case 0x80:
-                A = add(A, B);
-                break;
-            case 0x81:
-                A = add(A, C);
-                break;
-            case 0x82:
-                A = add(A, D);
-                break;
-            case 0x83:
-                A = add(A, E);
-                break;
-            case 0x84:
-                A = add(A, H);
-                break;
-            case 0x85:
-                A = add(A, L);
-                break;
-            case 0x86:
-                A = add(A, fetchMemory(HL()));
-                break;
-            case 0x87:
-                A = add(A, A);
-                break;
-            case 0x88:
-                A = add(A, B, true);
-                break;
-            case 0x89:
-                A = add(A, C, true);
-                break;
-            case 0x8A:
-                A = add(A, D, true);
-                break;
-            case 0x8B:
-                A = add(A, E, true);
-                break;
-            case 0x8C:
-                A = add(A, H, true);
-                break;
-            case 0x8D:
-                A = add(A, L, true);
-                break;
-            case 0x8E:
-                A = add(A, fetchMemory(HL()), true);
-                break;
-            case 0x8F:
-                A = add(A, A, true);
-                break;
-            case 0x90:
-                A = sub(A, B);
-                break;
-            case 0x91:
-                A = sub(A, C);
-                break;
-            case 0x92:
-                A = sub(A, D);
-                break;
-            case 0x93:
-                A = sub(A, E);
-                break;
-            case 0x94:
-                A = sub(A, H);
-                break;
-            case 0x95:
-                A = sub(A, L);
-                break;
-            case 0x96:
-                A = sub(A, fetchMemory(HL()));
-                break;
-            case 0x97:
-                A = sub(A, A);
-                break;
-            case 0x98:
-                A = sub(A, B, true);
-                break;
-            case 0x99:
-                A = sub(A, C, true);
-                break;
-            case 0x9A:
-                A = sub(A, D, true);
-                break;
-            case 0x9B:
-                A = sub(A, E, true);
-                break;
-            case 0x9C:
-                A = sub(A, H, true);
-                break;
-            case 0x9D:
-                A = sub(A, L, true);
-                break;
-            case 0x9E:
-                A = sub(A, fetchMemory(HL()), true);
-                break;
-            case 0x9F:
-                A = sub(A, A, true);
-                break;
-            case 0xA0:
-                A = bitwiseAnd(A, B);
-                break;
-            case 0xA1:
-                A = bitwiseAnd(A, C);
-                break;
-            case 0xA2:
-                A = bitwiseAnd(A, D);
-                break;
-            case 0xA3:
-                A = bitwiseAnd(A, E);
-                break;
-            case 0xA4:
-                A = bitwiseAnd(A, H);
-                break;
-            case 0xA5:
-                A = bitwiseAnd(A, L);
-                break;
-            case 0xA6:
-                A = bitwiseAnd(A, fetchMemory(HL()));
-                break;
-            case 0xA7:
-                A = bitwiseAnd(A, A);
-                break;
-            case 0xA8:
-                A = bitwise_xor(A, B);
-                break;
-            case 0xA9:
-                A = bitwise_xor(A, C);
-                break;
-            case 0xAA:
-                A = bitwise_xor(A, D);
-                break;
-            case 0xAB:
-                A = bitwise_xor(A, E);
-                break;
-            case 0xAC:
-                A = bitwise_xor(A, H);
-                break;
-            case 0xAD:
-                A = bitwise_xor(A, L);
-                break;
-            case 0xAE:
-                A = bitwise_xor(A, fetchMemory(HL()));
-                break;
-            case 0xAF:
-                A = bitwise_xor(A, A);
-                break;
-            case 0xB0:
-                A = bitwiseOr(A, B);
-                break;
-            case 0xB1:
-                A = bitwiseOr(A, C);
-                break;
-            case 0xB2:
-                A = bitwiseOr(A, D);
-                break;
-            case 0xB3:
-                A = bitwiseOr(A, E);
-                break;
-            case 0xB4:
-                A = bitwiseOr(A, H);
-                break;
-            case 0xB5:
-                A = bitwiseOr(A, L);
-                break;
-            case 0xB6:
-                A = bitwiseOr(A, fetchMemory(HL()));
-                break;
-            case 0xB7:
-                A = bitwiseOr(A, A);
-                break;
-            case 0xB8:
-                (void) sub(A, B);
-                break;
-            case 0xB9:
-                (void) sub(A, C);
-                break;
-            case 0xBA:
-                (void) sub(A, D);
-                break;
-            case 0xBB:
-                (void) sub(A, E);
-                break;
-            case 0xBC:
-                (void) sub(A, H);
-                break;
-            case 0xBD:
-                (void) sub(A, L);
-                break;
-            case 0xBE:
-                (void) sub(A, fetchMemory(HL()));
-                break;
-            case 0xBF:
-                (void) sub(A, A);
-                break;
-            case 0xC0:
-                ret_cc(Conditionals::NZ);
-                break;
-            case 0xC1:
-                pop(B, C);
-                break;
-            case 0xC2:
-                jp_cc(Conditionals::NZ);
-                break;
-            case 0xC3:
-                jp();
-                break;
-            case 0xC4:
-                call_cc(Conditionals::NZ);
-                break;
-            case 0xC5:
-                push(B, C);
-                break;
-            case 0xC6:
-                A = add(A, fetchOperand());
-                break;
-            case 0xC7:
-                rst(ResetVector::h00);
-                break;
-            case 0xC8:
-                ret_cc(Conditionals::Z);
-                break;
-            case 0xC9:
-                ret();
-                break;
-            case 0xCA:
-                jp_cc(Conditionals::Z);
-                break;
-            case 0xCB:
-                fetchInstruction();
-                decodeExecuteInstruction(true);
-                break;
-            case 0xCC:
-                call_cc(Conditionals::Z);
-                break;
-            case 0xCD:
-                call();
-                break;
-            case 0xCE:
-                A = add(A, fetchOperand(), true);
-                break;
-            case 0xCF:
-                rst(ResetVector::h08);
-                break;
-            case 0xD0:
-                ret_cc(Conditionals::NC);
-                break;
-            case 0xD1:
-                pop(D, E);
-                break;
-            case 0xD2:
-                jp_cc(Conditionals::NC);
-                break;
-            case 0xD4:
-                call_cc(Conditionals::NC);
-                break;
-            case 0xD5:
-                push(D, E);
-                break;
-            case 0xD6:
-                A = sub(A, fetchOperand());
-                break;
-            case 0xD7:
-                rst(ResetVector::h10);
-                break;
-            case 0xD8:
-                ret_cc(Conditionals::C);
-                break;
-            case 0xD9:
-                this->IME = true;
-                ret();
-                break;
-            case 0xDA:
-                jp_cc(Conditionals::C);
-                break;
-            case 0xDC:
-                call_cc(Conditionals::C);
-                break;
-            case 0xDE:
-                A = sub(A, fetchOperand(), true);
-                break;
-            case 0xDF:
-                rst(ResetVector::h18);
-                break;
-            case 0xE0:
-                writeMemory(0xFF00 | fetchOperand(), A);
-                break;
-            case 0xE1:
-                pop(H, L);
-                break;
-            case 0xE2:
-                writeMemory(0xFF00 | C, A);
-                break;
-            case 0xE5:
-                push(H, L);
-                break;
-            case 0xE6:
-                A = bitwiseAnd(A, fetchOperand());
-                break;
-            case 0xE7:
-                rst(ResetVector::h20);
-                break;
-            case 0xE8:
+            }
+        }
+        else if constexpr (y != z)
+        {
+            writeOperand<r8Y>(readOperand<r8Z>());
+        }
+    }
+    else if constexpr (x == 2)
+    {
+        alu<y>(readOperand<r8Z>());
+    }
+    else
+    {
+        if constexpr (z == 0)
+        {
+            if constexpr (y < 4)
+            {
+                ret_cc(conditionalY);
+            }
+            else if constexpr (y == 4)
+            {
+                writeMemory(0xFF00 | fetchOperand(), _registers.A);
+            }
+            else if constexpr (y == 5)
+            {
                 onMachineCycle();
-                SP = add(SP, fetchOperand());
+                _registers.SP = add(_registers.SP, fetchOperand());
                 onMachineCycle();
-                break;
-            case 0xE9:
-                PC = HL();
-                break;
-            case 0xEA:
+            }
+            else if constexpr (y == 6)
             {
-                const auto lsb = fetchOperand();
-                const auto msb = fetchOperand();
-                writeMemory(Utils::to_word(msb, lsb), A);
+                _registers.A = fetchMemory(0xFF00 | fetchOperand());
             }
-            break;
-            case 0xEE:
-                A = bitwise_xor(A, fetchOperand());
-                break;
-            case 0xEF:
-                rst(ResetVector::h28);
-                break;
-            case 0xF0:
-                A = fetchMemory(0xFF00 | fetchOperand());
-                break;
-            case 0xF1:
-                pop(A, F);
-                F &= 0xF0;
-                break;
-            case 0xF2:
-                A = fetchMemory(0xFF00 | C);
-                break;
-            case 0xF3:
-                this->IME        = false;
-                this->requestIme = 0;
-                break;
-            case 0xF5:
-                push(A, F);
-                break;
-            case 0xF6:
-                A = bitwiseOr(A, fetchOperand());
-                break;
-            case 0xF7:
-                rst(ResetVector::h30);
-                break;
-            case 0xF8:
+            else
+            {
                 onMachineCycle();
-                HL(add(SP, fetchOperand()));
-                break;
-            case 0xF9:
-                SP = HL();
+                _registers.HL = add(_registers.SP, fetchOperand());
+            }
+        }
+        else if constexpr (z == 1)
+        {
+            if constexpr (q == 0)
+            {
+                const auto lsb{fetchMemory(_registers.SP++)};
+                const auto msb{fetchMemory(_registers.SP++)};
+
+                writeOperand<r16PStack>(Utils::to_word(msb, lsb));
+                if constexpr (r16PStack == Operand16::AF)
+                {
+                    _registers.F &= 0xF0;
+                }
+            }
+            else if constexpr (p == 0)
+            {
+                ret();
+            }
+            else if constexpr (p == 1)
+            {
+                _registers.IME = true;
+                ret();
+            }
+            else if constexpr (p == 2)
+            {
+                _registers.PC = _registers.HL;
+            }
+            else
+            {
+                _registers.SP = _registers.HL;
                 onMachineCycle();
-                break;
-            case 0xFA:
+            }
+        }
+        else if constexpr (z == 2)
+        {
+            if constexpr (y < 4)
+            {
+                jp_cc(conditionalY);
+            }
+            else if constexpr (y == 4)
+            {
+                writeMemory(0xFF00 | _registers.C, _registers.A);
+            }
+            else if constexpr (y == 5)
             {
                 const auto lsb{fetchOperand()};
                 const auto msb{fetchOperand()};
-                A = fetchMemory(Utils::to_word(msb, lsb));
+
+                writeMemory(Utils::to_word(msb, lsb), _registers.A);
             }
-            break;
-            case 0xFB:
-                this->requestIme = 1;
-                break;
-            case 0xFE:
-                (void) sub(A, fetchOperand());
-                break;
-            case 0xFF:
-                rst(ResetVector::h38);
-                break;
-            [[unlikely]] default:
-                throw std::runtime_error(std::format("Illegal opcode at PC {:#04X}: {:#02X}", PC - 1, IR));
-        };
-    }
-    else
-    {
-        switch (IR)
+            else if constexpr (y == 6)
+            {
+                _registers.A = fetchMemory(0xFF00 | _registers.C);
+            }
+            else
+            {
+                const auto lsb{fetchOperand()};
+                const auto msb{fetchOperand()};
+
+                _registers.A = fetchMemory(Utils::to_word(msb, lsb));
+            }
+        }
+        else if constexpr (Opcode == 0xC3)
+        {
+            jp();
+        }
+        else if constexpr (Opcode == 0xCB)
+        {
+            _registers.IR = fetchCode();
+            (this->*extendedInstructionTable[_registers.IR])();
+        }
+        else if constexpr (Opcode == 0xF3)
+        {
+            _registers.IME   = false;
+            this->requestIme = 0;
+        }
+        else if constexpr (Opcode == 0xFB)
+        {
+            this->requestIme = 1;
+        }
+        else if constexpr (z == 4 && y < 4)
         {
-            case 0x00:
-                B = rotate_left(B, true);
-                break;
-            case 0x01:
-                C = rotate_left(C, true);
-                break;
-            case 0x02:
-                D = rotate_left(D, true);
-                break;
-            case 0x03:
-                E = rotate_left(E, true);
-                break;
-            case 0x04:
-                H = rotate_left(H, true);
-                break;
-            case 0x05:
-                L = rotate_left(L, true);
-                break;
-            case 0x06:
-                writeMemory(HL(), rotate_left(fetchMemory(HL()), true));
-                break;
-            case 0x07:
-                A = rotate_left(A, true);
-                break;
-            case 0x08:
-                B = rotate_right(B, true);
-                break;
-            case 0x09:
-                C = rotate_right(C, true);
-                break;
-            case 0x0A:
-                D = rotate_right(D, true);
-                break;
-            case 0x0B:
-                E = rotate_right(E, true);
-                break;
-            case 0x0C:
-                H = rotate_right(H, true);
-                break;
-            case 0x0D:
-                L = rotate_right(L, true);
-                break;
-            case 0x0E:
-                writeMemory(HL(), rotate_right(fetchMemory(HL()), true));
-                break;
-            case 0x0F:
-                A = rotate_right(A, true);
-                break;
-            case 0x10:
-                B = rotate_left(B);
-                break;
-            case 0x11:
-                C = rotate_left(C);
-                break;
-            case 0x12:
-                D = rotate_left(D);
-                break;
-            case 0x13:
-                E = rotate_left(E);
-                break;
-            case 0x14:
-                H = rotate_left(H);
-                break;
-            case 0x15:
-                L = rotate_left(L);
-                break;
-            case 0x16:
-                writeMemory(HL(), rotate_left(fetchMemory(HL())));
-                break;
-            case 0x17:
-                A = rotate_left(A);
-                break;
-            case 0x18:
-                B = rotate_right(B);
-                break;
-            case 0x19:
-                C = rotate_right(C);
-                break;
-            case 0x1A:
-                D = rotate_right(D);
-                break;
-            case 0x1B:
-                E = rotate_right(E);
-                break;
-            case 0x1C:
-                H = rotate_right(H);
-                break;
-            case 0x1D:
-                L = rotate_right(L);
-                break;
-            case 0x1E:
-                writeMemory(HL(), rotate_right(fetchMemory(HL())));
-                break;
-            case 0x1F:
-                A = rotate_right(A);
-                break;
-            case 0x20:
-                B = shift_left(B);
-                break;
-            case 0x21:
-                C = shift_left(C);
-                break;
-            case 0x22:
-                D = shift_left(D);
-                break;
-            case 0x23:
-                E = shift_left(E);
-                break;
-            case 0x24:
-                H = shift_left(H);
-                break;
-            case 0x25:
-                L = shift_left(L);
-                break;
-            case 0x26:
-                writeMemory(HL(), shift_left(fetchMemory(HL())));
-                break;
-            case 0x27:
-                A = shift_left(A);
-                break;
-            case 0x28:
-                B = shift_right(B, true);
-                break;
-            case 0x29:
-                C = shift_right(C, true);
-                break;
-            case 0x2A:
-                D = shift_right(D, true);
-                break;
-            case 0x2B:
-                E = shift_right(E, true);
-                break;
-            case 0x2C:
-                H = shift_right(H, true);
-                break;
-            case 0x2D:
-                L = shift_right(L, true);
-                break;
-            case 0x2E:
-                writeMemory(HL(), shift_right(fetchMemory(HL()), true));
-                break;
-            case 0x2F:
-                A = shift_right(A, true);
-                break;
-            case 0x30:
-                B = swap(B);
-                break;
-            case 0x31:
-                C = swap(C);
-                break;
-            case 0x32:
-                D = swap(D);
-                break;
-            case 0x33:
-                E = swap(E);
-                break;
-            case 0x34:
-                H = swap(H);
-                break;
-            case 0x35:
-                L = swap(L);
-                break;
-            case 0x36:
-                writeMemory(HL(), swap(fetchMemory(HL())));
-                break;
-            case 0x37:
-                A = swap(A);
-                break;
-            case 0x38:
-                B = shift_right(B);
-                break;
-            case 0x39:
-                C = shift_right(C);
-                break;
-            case 0x3A:
-                D = shift_right(D);
-                break;
-            case 0x3B:
-                E = shift_right(E);
-                break;
-            case 0x3C:
-                H = shift_right(H);
-                break;
-            case 0x3D:
-                L = shift_right(L);
-                break;
-            case 0x3E:
-                writeMemory(HL(), shift_right(fetchMemory(HL())));
-                break;
-            case 0x3F:
-                A = shift_right(A);
-                break;
-            case 0x40:
-                bit(B, 0);
-                break;
-            case 0x41:
-                bit(C, 0);
-                break;
-            case 0x42:
-                bit(D, 0);
-                break;
-            case 0x43:
-                bit(E, 0);
-                break;
-            case 0x44:
-                bit(H, 0);
-                break;
-            case 0x45:
-                bit(L, 0);
-                break;
-            case 0x46:
-                bit(fetchMemory(HL()), 0);
-                break;
-            case 0x47:
-                bit(A, 0);
-                break;
-            case 0x48:
-                bit(B, 1);
-                break;
-            case 0x49:
-                bit(C, 1);
-                break;
-            case 0x4A:
-                bit(D, 1);
-                break;
-            case 0x4B:
-                bit(E, 1);
-                break;
-            case 0x4C:
-                bit(H, 1);
-                break;
-            case 0x4D:
-                bit(L, 1);
-                break;
-            case 0x4E:
-                bit(fetchMemory(HL()), 1);
-                break;
-            case 0x4F:
-                bit(A, 1);
-                break;
-            case 0x50:
-                bit(B, 2);
-                break;
-            case 0x51:
-                bit(C, 2);
-                break;
-            case 0x52:
-                bit(D, 2);
-                break;
-            case 0x53:
-                bit(E, 2);
-                break;
-            case 0x54:
-                bit(H, 2);
-                break;
-            case 0x55:
-                bit(L, 2);
-                break;
-            case 0x56:
-                bit(fetchMemory(HL()), 2);
-                break;
-            case 0x57:
-                bit(A, 2);
-                break;
-            case 0x58:
-                bit(B, 3);
-                break;
-            case 0x59:
-                bit(C, 3);
-                break;
-            case 0x5A:
-                bit(D, 3);
-                break;
-            case 0x5B:
-                bit(E, 3);
-                break;
-            case 0x5C:
-                bit(H, 3);
-                break;
-            case 0x5D:
-                bit(L, 3);
-                break;
-            case 0x5E:
-                bit(fetchMemory(HL()), 3);
-                break;
-            case 0x5F:
-                bit(A, 3);
-                break;
-            case 0x60:
-                bit(B, 4);
-                break;
-            case 0x61:
-                bit(C, 4);
-                break;
-            case 0x62:
-                bit(D, 4);
-                break;
-            case 0x63:
-                bit(E, 4);
-                break;
-            case 0x64:
-                bit(H, 4);
-                break;
-            case 0x65:
-                bit(L, 4);
-                break;
-            case 0x66:
-                bit(fetchMemory(HL()), 4);
-                break;
-            case 0x67:
-                bit(A, 4);
-                break;
-            case 0x68:
-                bit(B, 5);
-                break;
-            case 0x69:
-                bit(C, 5);
-                break;
-            case 0x6A:
-                bit(D, 5);
-                break;
-            case 0x6B:
-                bit(E, 5);
-                break;
-            case 0x6C:
-                bit(H, 5);
-                break;
-            case 0x6D:
-                bit(L, 5);
-                break;
-            case 0x6E:
-                bit(fetchMemory(HL()), 5);
-                break;
-            case 0x6F:
-                bit(A, 5);
-                break;
-            case 0x70:
-                bit(B, 6);
-                break;
-            case 0x71:
-                bit(C, 6);
-                break;
-            case 0x72:
-                bit(D, 6);
-                break;
-            case 0x73:
-                bit(E, 6);
-                break;
-            case 0x74:
-                bit(H, 6);
-                break;
-            case 0x75:
-                bit(L, 6);
-                break;
-            case 0x76:
-                bit(fetchMemory(HL()), 6);
-                break;
-            case 0x77:
-                bit(A, 6);
-                break;
-            case 0x78:
-                bit(B, 7);
-                break;
-            case 0x79:
-                bit(C, 7);
-                break;
-            case 0x7A:
-                bit(D, 7);
-                break;
-            case 0x7B:
-                bit(E, 7);
-                break;
-            case 0x7C:
-                bit(H, 7);
-                break;
-            case 0x7D:
-                bit(L, 7);
-                break;
-            case 0x7E:
-                bit(fetchMemory(HL()), 7);
-                break;
-            case 0x7F:
-                bit(A, 7);
-                break;
+            call_cc(conditionalY);
+        }
+        else if constexpr (z == 5 && q == 0)
+        {
+            push(readOperand<r16PStack>());
+        }
+        else if constexpr (Opcode == 0xCD)
+        {
+            call();
+        }
+        else if constexpr (z == 6)
+        {
+            alu<y>(fetchOperand());
+        }
+        else if constexpr (z == 7)
+        {
+            rst(static_cast<ResetVector>(y * 8));
+        }
+        else
+        {
+            throw std::runtime_error(
+                std::format("Illegal opcode at PC {:#04X}: {:#02X}", _registers.PC - 1, _registers.IR));
+        }
+    }
+}
 
-            case 0x80:
-                B = res(B, 0);
-                break;
-            case 0x81:
-                C = res(C, 0);
-                break;
-            case 0x82:
-                D = res(D, 0);
-                break;
-            case 0x83:
-                E = res(E, 0);
-                break;
-            case 0x84:
-                H = res(H, 0);
-                break;
-            case 0x85:
-                L = res(L, 0);
-                break;
-            case 0x86:
-                writeMemory(HL(), res(fetchMemory(HL()), 0));
-                break;
-            case 0x87:
-                A = res(A, 0);
-                break;
-            case 0x88:
-                B = res(B, 1);
-                break;
-            case 0x89:
-                C = res(C, 1);
-                break;
-            case 0x8A:
-                D = res(D, 1);
-                break;
-            case 0x8B:
-                E = res(E, 1);
-                break;
-            case 0x8C:
-                H = res(H, 1);
-                break;
-            case 0x8D:
-                L = res(L, 1);
-                break;
-            case 0x8E:
-                writeMemory(HL(), res(fetchMemory(HL()), 1));
-                break;
-            case 0x8F:
-                A = res(A, 1);
-                break;
-            case 0x90:
-                B = res(B, 2);
-                break;
-            case 0x91:
-                C = res(C, 2);
-                break;
-            case 0x92:
-                D = res(D, 2);
-                break;
-            case 0x93:
-                E = res(E, 2);
-                break;
-            case 0x94:
-                H = res(H, 2);
-                break;
-            case 0x95:
-                L = res(L, 2);
-                break;
-            case 0x96:
-                writeMemory(HL(), res(fetchMemory(HL()), 2));
-                break;
-            case 0x97:
-                A = res(A, 2);
-                break;
-            case 0x98:
-                B = res(B, 3);
-                break;
-            case 0x99:
-                C = res(C, 3);
-                break;
-            case 0x9A:
-                D = res(D, 3);
-                break;
-            case 0x9B:
-                E = res(E, 3);
-                break;
-            case 0x9C:
-                H = res(H, 3);
-                break;
-            case 0x9D:
-                L = res(L, 3);
-                break;
-            case 0x9E:
-                writeMemory(HL(), res(fetchMemory(HL()), 3));
-                break;
-            case 0x9F:
-                A = res(A, 3);
-                break;
+template <uint8_t Opcode>
+void SM83::executeExtendedInstruction()
+{
+    constexpr uint8_t x{Opcode >> 6};
+    constexpr uint8_t y{(Opcode >> 3) & 0x07};
+    constexpr uint8_t z{Opcode & 0x07};
 
-            case 0xA0:
-                B = res(B, 4);
-                break;
-            case 0xA1:
-                C = res(C, 4);
-                break;
-            case 0xA2:
-                D = res(D, 4);
-                break;
-            case 0xA3:
-                E = res(E, 4);
-                break;
-            case 0xA4:
-                H = res(H, 4);
-                break;
-            case 0xA5:
-                L = res(L, 4);
-                break;
-            case 0xA6:
-                writeMemory(HL(), res(fetchMemory(HL()), 4));
-                break;
-            case 0xA7:
-                A = res(A, 4);
-                break;
-            case 0xA8:
-                B = res(B, 5);
-                break;
-            case 0xA9:
-                C = res(C, 5);
-                break;
-            case 0xAA:
-                D = res(D, 5);
-                break;
-            case 0xAB:
-                E = res(E, 5);
-                break;
-            case 0xAC:
-                H = res(H, 5);
-                break;
-            case 0xAD:
-                L = res(L, 5);
-                break;
-            case 0xAE:
-                writeMemory(HL(), res(fetchMemory(HL()), 5));
-                break;
-            case 0xAF:
-                A = res(A, 5);
-                break;
+    constexpr auto r8Z{static_cast<Operand8>(z)};
 
-            case 0xB0:
-                B = res(B, 6);
-                break;
-            case 0xB1:
-                C = res(C, 6);
-                break;
-            case 0xB2:
-                D = res(D, 6);
-                break;
-            case 0xB3:
-                E = res(E, 6);
-                break;
-            case 0xB4:
-                H = res(H, 6);
-                break;
-            case 0xB5:
-                L = res(L, 6);
-                break;
-            case 0xB6:
-                writeMemory(HL(), res(fetchMemory(HL()), 6));
-                break;
-            case 0xB7:
-                A = res(A, 6);
-                break;
-            case 0xB8:
-                B = res(B, 7);
-                break;
-            case 0xB9:
-                C = res(C, 7);
-                break;
-            case 0xBA:
-                D = res(D, 7);
-                break;
-            case 0xBB:
-                E = res(E, 7);
-                break;
-            case 0xBC:
-                H = res(H, 7);
-                break;
-            case 0xBD:
-                L = res(L, 7);
-                break;
-            case 0xBE:
-                writeMemory(HL(), res(fetchMemory(HL()), 7));
-                break;
-            case 0xBF:
-                A = res(A, 7);
-                break;
-            case 0xC0:
-                B = set(B, 0);
-                break;
-            case 0xC1:
-                C = set(C, 0);
-                break;
-            case 0xC2:
-                D = set(D, 0);
-                break;
-            case 0xC3:
-                E = set(E, 0);
-                break;
-            case 0xC4:
-                H = set(H, 0);
-                break;
-            case 0xC5:
-                L = set(L, 0);
-                break;
-            case 0xC6:
-                writeMemory(HL(), set(fetchMemory(HL()), 0));
-                break;
-            case 0xC7:
-                A = set(A, 0);
-                break;
-            case 0xC8:
-                B = set(B, 1);
-                break;
-            case 0xC9:
-                C = set(C, 1);
-                break;
-            case 0xCA:
-                D = set(D, 1);
-                break;
-            case 0xCB:
-                E = set(E, 1);
-                break;
-            case 0xCC:
-                H = set(H, 1);
-                break;
-            case 0xCD:
-                L = set(L, 1);
-                break;
-            case 0xCE:
-                writeMemory(HL(), set(fetchMemory(HL()), 1));
-                break;
-            case 0xCF:
-                A = set(A, 1);
-                break;
+    if constexpr (x == 0)
+    {
+        const auto op{readOperand<r8Z>()};
 
-            case 0xD0:
-                B = set(B, 2);
-                break;
-            case 0xD1:
-                C = set(C, 2);
-                break;
-            case 0xD2:
-                D = set(D, 2);
-                break;
-            case 0xD3:
-                E = set(E, 2);
-                break;
-            case 0xD4:
-                H = set(H, 2);
-                break;
-            case 0xD5:
-                L = set(L, 2);
-                break;
-            case 0xD6:
-                writeMemory(HL(), set(fetchMemory(HL()), 2));
-                break;
-            case 0xD7:
-                A = set(A, 2);
-                break;
-            case 0xD8:
-                B = set(B, 3);
-                break;
-            case 0xD9:
-                C = set(C, 3);
-                break;
-            case 0xDA:
-                D = set(D, 3);
-                break;
-            case 0xDB:
-                E = set(E, 3);
-                break;
-            case 0xDC:
-                H = set(H, 3);
-                break;
-            case 0xDD:
-                L = set(L, 3);
-                break;
-            case 0xDE:
-                writeMemory(HL(), set(fetchMemory(HL()), 3));
-                break;
-            case 0xDF:
-                A = set(A, 3);
-                break;
-            case 0xE0:
-                B = set(B, 4);
-                break;
-            case 0xE1:
-                C = set(C, 4);
-                break;
-            case 0xE2:
-                D = set(D, 4);
-                break;
-            case 0xE3:
-                E = set(E, 4);
-                break;
-            case 0xE4:
-                H = set(H, 4);
-                break;
-            case 0xE5:
-                L = set(L, 4);
-                break;
-            case 0xE6:
-                writeMemory(HL(), set(fetchMemory(HL()), 4));
-                break;
-            case 0xE7:
-                A = set(A, 4);
-                break;
-            case 0xE8:
-                B = set(B, 5);
-                break;
-            case 0xE9:
-                C = set(C, 5);
-                break;
-            case 0xEA:
-                D = set(D, 5);
-                break;
-            case 0xEB:
-                E = set(E, 5);
-                break;
-            case 0xEC:
-                H = set(H, 5);
-                break;
-            case 0xED:
-                L = set(L, 5);
-                break;
-            case 0xEE:
-                writeMemory(HL(), set(fetchMemory(HL()), 5));
-                break;
-            case 0xEF:
-                A = set(A, 5);
-                break;
-            case 0xF0:
-                B = set(B, 6);
-                break;
-            case 0xF1:
-                C = set(C, 6);
-                break;
-            case 0xF2:
-                D = set(D, 6);
-                break;
-            case 0xF3:
-                E = set(E, 6);
-                break;
-            case 0xF4:
-                H = set(H, 6);
-                break;
-            case 0xF5:
-                L = set(L, 6);
-                break;
-            case 0xF6:
-                writeMemory(HL(), set(fetchMemory(HL()), 6));
-                break;
-            case 0xF7:
-                A = set(A, 6);
-                break;
-            case 0xF8:
-                B = set(B, 7);
-                break;
-            case 0xF9:
-                C = set(C, 7);
-                break;
-            case 0xFA:
-                D = set(D, 7);
-                break;
-            case 0xFB:
-                E = set(E, 7);
-                break;
-            case 0xFC:
-                H = set(H, 7);
-                break;
-            case 0xFD:
-                L = set(L, 7);
-                break;
-            case 0xFE:
-                writeMemory(HL(), set(fetchMemory(HL()), 7));
-                break;
-            case 0xFF:
-                A = set(A, 7);
-                break;
-            [[unlikely]] default:
-                throw std::runtime_error(std::format("Opcode not implemented {:02X}", IR));
-        };
+        if constexpr (y == 0)
+        {
+            writeOperand<r8Z>(rotate_left(op, true));
+        }
+        else if constexpr (y == 1)
+        {
+            writeOperand<r8Z>(rotate_right(op, true));
+        }
+        else if constexpr (y == 2)
+        {
+            writeOperand<r8Z>(rotate_left(op));
+        }
+        else if constexpr (y == 3)
+        {
+            writeOperand<r8Z>(rotate_right(op));
+        }
+        else if constexpr (y == 4)
+        {
+            writeOperand<r8Z>(shift_left(op));
+        }
+        else if constexpr (y == 5)
+        {
+            writeOperand<r8Z>(shift_right(op, true));
+        }
+        else if constexpr (y == 6)
+        {
+            writeOperand<r8Z>(swap(op));
+        }
+        else
+        {
+            writeOperand<r8Z>(shift_right(op));
+        }
+    }
+    else if constexpr (x == 1)
+    {
+        bit(readOperand<r8Z>(), y);
+    }
+    else if constexpr (x == 2)
+    {
+        writeOperand<r8Z>(res(readOperand<r8Z>(), y));
+    }
+    else
+    {
+        writeOperand<r8Z>(set(readOperand<r8Z>(), y));
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,597 @@
+#include "hardware/core/Recompiler.hxx"
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+
+#if defined(__x86_64__) && defined(__linux__)
+#define GBEMU_RECOMPILER_SUPPORTED
+#include <sys/mman.h>
+#endif
+
+/**
+ * @note The translated code follows the System V calling convention and only uses caller saved registers:
+ * - rdi points to the Context below;
+ * - rsi points to the table converting host flags into SM83 flags;
+ * - ecx counts down the instructions left to run;
+ * - al, ah, dl and dh are scratch registers.
+ */
+
+namespace
+{
+    struct Context
+    {
+        Recompiler::Registers registers;
+        uint32_t              remaining;
+        const uint8_t*        hostFlags;
+    };
+
+    constexpr uint8_t offsetOfA{offsetof(Context, registers) + offsetof(Recompiler::Registers, A)};
+    constexpr uint8_t offsetOfF{offsetof(Context, registers) + offsetof(Recompiler::Registers, F)};
+    constexpr uint8_t offsetOfSP{offsetof(Context, registers) + offsetof(Recompiler::Registers, SP)};
+    constexpr uint8_t offsetOfRemaining{offsetof(Context, remaining)};
+    constexpr uint8_t offsetOfHostFlags{offsetof(Context, hostFlags)};
+
+    /**
+     * @brief Offset of each 8-bit register, in the order they are encoded in opcodes. (HL) is not a register.
+     */
+    constexpr std::array<uint8_t, 8> registerOffsets{
+        offsetof(Context, registers) + offsetof(Recompiler::Registers, B),
+        offsetof(Context, registers) + offsetof(Recompiler::Registers, C),
+        offsetof(Context, registers) + offsetof(Recompiler::Registers, D),
+        offsetof(Context, registers) + offsetof(Recompiler::Registers, E),
+        offsetof(Context, registers) + offsetof(Recompiler::Registers, H),
+        offsetof(Context, registers) + offsetof(Recompiler::Registers, L),
+        0xFF,
+        offsetOfA,
+    };
+
+    constexpr uint8_t offsetOfH{registerOffsets[4]};
+    constexpr uint8_t offsetOfL{registerOffsets[5]};
+
+    /**
+     * @brief Converts the flags loaded in AH by LAHF (ZF, AF and CF) into the SM83 Zero, HalfCarry and Carry flags.
+     */
+    constexpr std::array<uint8_t, 0x100> hostFlags{[]
+                                                   {
+                                                       std::array<uint8_t, 0x100> table{};
+
+                                                       for (std::size_t ah{0}; ah < table.size(); ++ah)
+                                                       {
+                                                           table[ah] = static_cast<uint8_t>(
+                                                               ((ah & 0x40) != 0 ? 0x80 : 0) |
+                                                               ((ah & 0x10) != 0 ? 0x20 : 0) |
+                                                               ((ah & 0x01) != 0 ? 0x10 : 0));
+                                                       }
+
+                                                       return table;
+                                                   }()};
+
+    class Emitter
+    {
+      public:
+        explicit Emitter(uint8_t* code) : _code(code) {}
+
+        void emit(const std::initializer_list<uint8_t> bytes)
+        {
+            for (const auto byte : bytes)
+            {
+                _code[_size++] = byte;
+            }
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return _size;
+        }
+
+        /* mov al, [rdi + offset] */
+        void loadAL(const uint8_t offset)
+        {
+            emit({0x8A, 0x47, offset});
+        }
+
+        /* mov dl, [rdi + offset] */
+        void loadDL(const uint8_t offset)
+        {
+            emit({0x8A, 0x57, offset});
+        }
+
+        /* mov [rdi + offset], al */
+        void storeAL(const uint8_t offset)
+        {
+            emit({0x88, 0x47, offset});
+        }
+
+        /* bt dword [rdi + F], 4: load the SM83 Carry flag into CF. */
+        void loadCarry()
+        {
+            emit({0x0F, 0xBA, 0x67, offsetOfF, 0x04});
+        }
+
+        /**
+         * @brief Convert the host flags left by the last operation into SM83 flags, in dl.
+         * @param mask SM83 flags taken from the host flags.
+         * @param set SM83 flags always set.
+         */
+        void convertHostFlags(const uint8_t mask, const uint8_t set)
+        {
+            emit({0x9F});              // lahf
+            emit({0x0F, 0xB6, 0xD4});  // movzx edx, ah
+            emit({0x8A, 0x14, 0x16});  // mov dl, [rsi + rdx]
+            if (mask != 0xB0)
+            {
+                emit({0x80, 0xE2, mask});  // and dl, mask
+            }
+            if (set != 0)
+            {
+                emit({0x80, 0xCA, set});  // or dl, set
+            }
+        }
+
+        /**
+         * @brief Write the flags computed in dl to F, keeping the bits of F in keep.
+         */
+        void mergeFlags(const uint8_t keep)
+        {
+            loadAL(offsetOfF);
+            emit({0x24, keep});             // and al, keep
+            emit({0x08, 0xC2});             // or dl, al
+            emit({0x88, 0x57, offsetOfF});  // mov [rdi + F], dl
+        }
+
+        /**
+         * @brief Compute Zero from al and Carry from CF into dl, as set by the rotate and shift instructions.
+         */
+        void rotateFlags(const bool zero)
+        {
+            emit({0x0F, 0x92, 0xC2});  // setc dl
+            emit({0xC0, 0xE2, 0x04});  // shl dl, 4
+            if (zero)
+            {
+                emit({0x84, 0xC0});        // test al, al
+                emit({0x0F, 0x94, 0xC6});  // sete dh
+                emit({0xC0, 0xE6, 0x07});  // shl dh, 7
+                emit({0x08, 0xF2});        // or dl, dh
+            }
+        }
+
+        /**
+         * @brief Stop the run once the requested number of instructions has been executed.
+         */
+        void countInstruction()
+        {
+            emit({0xFF, 0xC9});                     // dec ecx
+            emit({0x75, 0x04});                     // jnz +4
+            emit({0x89, 0x4F, offsetOfRemaining});  // mov [rdi + remaining], ecx
+            emit({0xC3});                           // ret
+        }
+
+      private:
+        uint8_t*    _code;
+        std::size_t _size{};
+    };
+
+    /**
+     * @brief Emit one of the eight ALU operations between A and dl.
+     */
+    void emitAlu(Emitter& emitter, const uint8_t operation)
+    {
+        /* ADD, ADC, SUB, SBB, AND, XOR, OR and CMP al, dl. */
+        constexpr std::array<uint8_t, 8> hostOperations{0x00, 0x10, 0x28, 0x18, 0x20, 0x30, 0x08, 0x38};
+
+        emitter.loadAL(offsetOfA);
+        if (operation == 1 || operation == 3)
+        {
+            emitter.loadCarry();
+        }
+        emitter.emit({hostOperations[operation], 0xD0});
+        if (operation != 7)
+        {
+            emitter.storeAL(offsetOfA);
+        }
+
+        switch (operation)
+        {
+            case 4:
+                emitter.convertHostFlags(0x80, 0x20);
+                break;
+            case 5:
+            case 6:
+                emitter.convertHostFlags(0x80, 0x00);
+                break;
+            case 2:
+            case 3:
+            case 7:
+                emitter.convertHostFlags(0xB0, 0x40);
+                break;
+            default:
+                emitter.convertHostFlags(0xB0, 0x00);
+                break;
+        }
+        emitter.mergeFlags(0x0F);
+    }
+
+    void emitExtended(Emitter& emitter, const uint8_t opcode)
+    {
+        const uint8_t x{static_cast<uint8_t>(opcode >> 6)};
+        const uint8_t y{static_cast<uint8_t>((opcode >> 3) & 0x07)};
+        const auto    offset{registerOffsets[opcode & 0x07]};
+        const uint8_t mask{static_cast<uint8_t>(1 << y)};
+
+        if (x == 0)
+        {
+            /* RLC, RRC, RL, RR, SLA, SRA, SWAP and SRL, as ROL, ROR, RCL, RCR, SHL, SAR, ROL 4 and SHR. */
+            constexpr std::array<uint8_t, 8> hostOperations{0, 1, 2, 3, 4, 7, 0, 5};
+
+            emitter.loadAL(offset);
+            if (y == 2 || y == 3)
+            {
+                emitter.loadCarry();
+            }
+            if (y == 6)
+            {
+                emitter.emit({0xC0, 0xC0, 0x04});  // rol al, 4
+            }
+            else
+            {
+                emitter.emit({0xD0, static_cast<uint8_t>(0xC0 | hostOperations[y] << 3)});
+            }
+            emitter.storeAL(offset);
+
+            if (y == 6)
+            {
+                emitter.emit({0x84, 0xC0});  // test al, al
+                emitter.convertHostFlags(0x80, 0x00);
+            }
+            else
+            {
+                emitter.rotateFlags(true);
+            }
+            emitter.mergeFlags(0x0F);
+        }
+        else if (x == 1)
+        {
+            emitter.emit({0xF6, 0x47, offset, mask});  // test byte [rdi + offset], mask
+            emitter.emit({0x0F, 0x94, 0xC2});          // sete dl
+            emitter.emit({0xC0, 0xE2, 0x07});          // shl dl, 7
+            emitter.emit({0x80, 0xCA, 0x20});          // or dl, 0x20
+            emitter.mergeFlags(0x1F);
+        }
+        else if (x == 2)
+        {
+            emitter.emit({0x80, 0x67, offset, static_cast<uint8_t>(~mask)});  // and byte [rdi + offset], ~mask
+        }
+        else
+        {
+            emitter.emit({0x80, 0x4F, offset, mask});  // or byte [rdi + offset], mask
+        }
+    }
+
+    /**
+     * @brief Emit a 16-bit register pair update. The pairs are unions stored low byte first, like SP, but are updated a
+     * byte at a time through the offsets of their registers, with the carry going from the low to the high one.
+     */
+    void emitIncrementPair(Emitter& emitter, const uint8_t pair, const bool decrement)
+    {
+        if (pair == 3)
+        {
+            emitter.emit({0x66, 0xFF, static_cast<uint8_t>(decrement ? 0x4F : 0x47), offsetOfSP});  // inc/dec word
+            return;
+        }
+
+        const auto msb{registerOffsets[pair * 2]};
+        const auto lsb{registerOffsets[pair * 2 + 1]};
+
+        if (decrement)
+        {
+            emitter.emit({0x80, 0x6F, lsb, 0x01});  // sub byte [rdi + lsb], 1
+            emitter.emit({0x80, 0x5F, msb, 0x00});  // sbb byte [rdi + msb], 0
+        }
+        else
+        {
+            emitter.emit({0x80, 0x47, lsb, 0x01});  // add byte [rdi + lsb], 1
+            emitter.emit({0x80, 0x57, msb, 0x00});  // adc byte [rdi + msb], 0
+        }
+    }
+
+    void emitInstruction(Emitter& emitter, const SM83::BlockCache::Instruction& instruction)
+    {
+        const auto    opcode{instruction.bytes[0]};
+        const uint8_t x{static_cast<uint8_t>(opcode >> 6)};
+        const uint8_t y{static_cast<uint8_t>((opcode >> 3) & 0x07)};
+        const uint8_t z{static_cast<uint8_t>(opcode & 0x07)};
+        const uint8_t p{static_cast<uint8_t>(y >> 1)};
+        const bool    q{(y & 0x01) != 0};
+
+        if (opcode == 0xCB)
+        {
+            emitExtended(emitter, instruction.bytes[1]);
+        }
+        else if (x == 1)
+        {
+            if (y != z)
+            {
+                emitter.loadAL(registerOffsets[z]);
+                emitter.storeAL(registerOffsets[y]);
+            }
+        }
+        else if (x == 2)
+        {
+            emitter.loadDL(registerOffsets[z]);
+            emitAlu(emitter, y);
+        }
+        else if (x == 3)
+        {
+            if (z == 6)
+            {
+                emitter.emit({0xB2, instruction.bytes[1]});  // mov dl, n8
+                emitAlu(emitter, y);
+            }
+            else
+            {
+                /* LD SP, HL */
+                emitter.loadAL(offsetOfL);
+                emitter.storeAL(offsetOfSP);
+                emitter.loadAL(offsetOfH);
+                emitter.storeAL(offsetOfSP + 1);
+            }
+        }
+        else if (z == 1 && !q)
+        {
+            if (p == 3)
+            {
+                emitter.emit({0x66, 0xC7, 0x47, offsetOfSP, instruction.bytes[1], instruction.bytes[2]});
+            }
+            else
+            {
+                emitter.emit({0xC6, 0x47, registerOffsets[p * 2], instruction.bytes[2]});
+                emitter.emit({0xC6, 0x47, registerOffsets[p * 2 + 1], instruction.bytes[1]});
+            }
+        }
+        else if (z == 1)
+        {
+            /* ADD HL, rr: add the low bytes in ah and dh, then the high bytes in al and dl. */
+            const auto msb{p == 3 ? static_cast<uint8_t>(offsetOfSP + 1) : registerOffsets[p * 2]};
+            const auto lsb{p == 3 ? offsetOfSP : registerOffsets[p * 2 + 1]};
+
+            emitter.loadAL(offsetOfH);
+            emitter.emit({0x8A, 0x67, offsetOfL});  // mov ah, [rdi + L]
+            emitter.loadDL(msb);
+            emitter.emit({0x8A, 0x77, lsb});        // mov dh, [rdi + lsb]
+            emitter.emit({0x00, 0xF4});             // add ah, dh
+            emitter.emit({0x10, 0xD0});             // adc al, dl
+            emitter.storeAL(offsetOfH);
+            emitter.emit({0x88, 0x67, offsetOfL});  // mov [rdi + L], ah
+            emitter.convertHostFlags(0x30, 0x00);
+            emitter.mergeFlags(0x8F);
+        }
+        else if (z == 3)
+        {
+            emitIncrementPair(emitter, p, q);
+        }
+        else if (z == 4 || z == 5)
+        {
+            emitter.loadAL(registerOffsets[y]);
+            emitter.emit({0xFE, static_cast<uint8_t>(z == 4 ? 0xC0 : 0xC8)});  // inc/dec al
+            emitter.storeAL(registerOffsets[y]);
+            emitter.convertHostFlags(0xA0, z == 4 ? 0x00 : 0x40);
+            emitter.mergeFlags(0x1F);
+        }
+        else if (z == 6)
+        {
+            emitter.emit({0xC6, 0x47, registerOffsets[y], instruction.bytes[1]});  // mov byte [rdi + r], n8
+        }
+        else if (z == 7 && y < 4)
+        {
+            /* RLCA, RRCA, RLA and RRA, as ROL, ROR, RCL and RCR. */
+            emitter.loadAL(offsetOfA);
+            if (y >= 2)
+            {
+                emitter.loadCarry();
+            }
+            emitter.emit({0xD0, static_cast<uint8_t>(0xC0 | y << 3)});
+            emitter.storeAL(offsetOfA);
+            emitter.rotateFlags(false);
+            emitter.mergeFlags(0x0F);
+        }
+        else if (opcode == 0x2F)
+        {
+            emitter.emit({0xF6, 0x57, offsetOfA});        // not byte [rdi + A]
+            emitter.emit({0x80, 0x4F, offsetOfF, 0x60});  // or byte [rdi + F], 0x60
+        }
+        else if (opcode == 0x37)
+        {
+            emitter.emit({0x80, 0x67, offsetOfF, 0x8F});  // and byte [rdi + F], 0x8F
+            emitter.emit({0x80, 0x4F, offsetOfF, 0x10});  // or byte [rdi + F], 0x10
+        }
+        else if (opcode == 0x3F)
+        {
+            emitter.emit({0x80, 0x67, offsetOfF, 0x9F});  // and byte [rdi + F], 0x9F
+            emitter.emit({0x80, 0x77, offsetOfF, 0x10});  // xor byte [rdi + F], 0x10
+        }
+    }
+}  // namespace
+
+Recompiler::Recompiler()
+{
+#ifdef GBEMU_RECOMPILER_SUPPORTED
+    void* code{mmap(nullptr, CODE_BUFFER_SIZE, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+
+    if (code == MAP_FAILED)
+    {
+        throw std::runtime_error("Cannot allocate memory for the recompiler");
+    }
+
+    _code = static_cast<uint8_t*>(code);
+#endif
+}
+
+Recompiler::~Recompiler()
+{
+#ifdef GBEMU_RECOMPILER_SUPPORTED
+    munmap(_code, CODE_BUFFER_SIZE);
+#endif
+}
+
+bool Recompiler::isSupported() noexcept
+{
+#ifdef GBEMU_RECOMPILER_SUPPORTED
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Recompiler::isRecompilable(const SM83::BlockCache::Instruction& instruction) noexcept
+{
+    const auto    opcode{instruction.bytes[0]};
+    const uint8_t x{static_cast<uint8_t>(opcode >> 6)};
+    const uint8_t y{static_cast<uint8_t>((opcode >> 3) & 0x07)};
+    const uint8_t z{static_cast<uint8_t>(opcode & 0x07)};
+
+    switch (x)
+    {
+        case 0:
+            /* NOP, LD rr, n16, ADD HL, rr, INC rr, DEC rr, INC r, DEC r, LD r, n8 and the accumulator operations,
+             * except DAA. */
+            return opcode == 0x00 || z == 1 || z == 3 || ((z == 4 || z == 5 || z == 6) && y != 6) ||
+                   (z == 7 && y != 4);
+        case 1:
+            return y != 6 && z != 6;
+        case 2:
+            return z != 6;
+        default:
+            return z == 6 || opcode == 0xF9 || (opcode == 0xCB && (instruction.bytes[1] & 0x07) != 0x06);
+    }
+}
+
+const Recompiler::CompiledBlock* Recompiler::get(const SM83::BlockCache::Block& block, const uint16_t bank)
+{
+    if (!isSupported())
+    {
+        return nullptr;
+    }
+
+    const auto address{block.instructions.front().address};
+    const auto* compiled{_entries[address]};
+
+    if (compiled == nullptr || compiled->bank != bank) [[unlikely]]
+    {
+        const auto key{static_cast<uint32_t>(bank) << 16 | address};
+        auto       it{_blocks.find(key)};
+
+        if (it == _blocks.end())
+        {
+            it = _blocks.emplace(key, compile(block)).first;
+            it->second.bank = bank;
+            _pageKeys[address >> 8].push_back(key);
+        }
+
+        compiled = _entries[address] = &it->second;
+    }
+
+    return compiled->entry != nullptr ? compiled : nullptr;
+}
+
+void Recompiler::execute(const CompiledBlock& block, Registers& registers, const std::size_t count)
+{
+    Context context{registers, static_cast<uint32_t>(count), hostFlags.data()};
+
+    reinterpret_cast<void (*)(Context*)>(block.entry)(&context);
+
+    registers = context.registers;
+}
+
+void Recompiler::invalidate(const uint16_t address)
+{
+    constexpr auto MAX_BLOCK_SIZE{SM83::BlockCache::MAX_BLOCK_SIZE};
+
+    const std::size_t firstPage{address >= MAX_BLOCK_SIZE ? (address - MAX_BLOCK_SIZE + 1) >> 8 : 0};
+    const std::size_t lastPage{static_cast<std::size_t>(address >> 8)};
+
+    for (auto page{firstPage}; page <= lastPage; ++page)
+    {
+        std::erase_if(_pageKeys[page],
+                      [this, address](const uint32_t key)
+                      {
+                          const auto  it{_blocks.find(key)};
+                          const auto& block{it->second};
+
+                          if (address < block.address || address >= block.end)
+                          {
+                              return false;
+                          }
+
+                          if (_entries[block.address] == &block)
+                          {
+                              _entries[block.address] = nullptr;
+                          }
+
+                          _blocks.erase(it);
+                          return true;
+                      });
+    }
+}
+
+void Recompiler::flush()
+{
+    _blocks.clear();
+    for (auto& keys : _pageKeys)
+    {
+        keys.clear();
+    }
+    _entries.fill(nullptr);
+    _codeSize = 0;
+}
+
+Recompiler::CompiledBlock Recompiler::compile(const SM83::BlockCache::Block& block)
+{
+    CompiledBlock compiled{.address = block.instructions.front().address};
+
+    compiled.end = compiled.address;
+    if (!isRecompilable(block.instructions.front()))
+    {
+        return compiled;
+    }
+
+#ifdef GBEMU_RECOMPILER_SUPPORTED
+    if (_codeSize + MAX_BLOCK_CODE_SIZE > CODE_BUFFER_SIZE)
+    {
+        /* Out of room: start over, the hot blocks will be translated again. */
+        flush();
+    }
+
+    mprotect(_code, CODE_BUFFER_SIZE, PROT_READ | PROT_WRITE);
+
+    Emitter emitter{_code + _codeSize};
+
+    emitter.emit({0x8B, 0x4F, offsetOfRemaining});        // mov ecx, [rdi + remaining]
+    emitter.emit({0x48, 0x8B, 0x77, offsetOfHostFlags});  // mov rsi, [rdi + hostFlags]
+
+    for (const auto& instruction : block.instructions)
+    {
+        if (!isRecompilable(instruction))
+        {
+            break;
+        }
+
+        emitInstruction(emitter, instruction);
+        emitter.countInstruction();
+
+        compiled.end = instruction.address + instruction.length;
+        compiled.instructions.push_back({compiled.end, instruction.machineCycles});
+    }
+
+    emitter.emit({0x89, 0x4F, offsetOfRemaining});  // mov [rdi + remaining], ecx
+    emitter.emit({0xC3});                           // ret
+
+    mprotect(_code, CODE_BUFFER_SIZE, PROT_READ | PROT_EXEC);
+
+    compiled.entry = _code + _codeSize;
+    _codeSize += emitter.size();
+#endif
+
+    return compiled;
+}
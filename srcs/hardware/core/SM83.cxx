@@ -7,30 +7,37 @@
  */
 
 #include <Utils.hxx>
+#include <algorithm>
 #include <bitset>
 #include <cassert>
 #include <format>
 #include <iostream>
 #include <utility>
 
-SM83::SM83(EmulationState& emulationState, IAddressable& bus, ITicking& timer, ITicking& ppu)
-    : emulationState(emulationState), bus(bus), timer(timer), ppu(ppu)
+#include "hardware/core/Recompiler.hxx"
+
+SM83::SM83(EmulationState& emulationState, IAddressable& bus, Scheduler& scheduler)
+    : emulationState(emulationState), bus(bus), scheduler(scheduler)
 {
+    scheduler.setHandler(Scheduler::Event::OAM_DMA_START, *this);
+    scheduler.setHandler(Scheduler::Event::OAM_DMA_END, *this);
 }
 
+SM83::~SM83() = default;
+
 void SM83::write(const uint16_t address, const uint8_t value)
 {
     switch (address)
     {
         case MemoryMap::IE:
-            IE = value;
+            _registers.IE = value;
             break;
         case MemoryMap::IORegisters::IF:
-            IF = 0xE0 | value;
+            _registers.IF = 0xE0 | value;
             break;
         case MemoryMap::IORegisters::DMA:
             oamDmaSourceAddress = static_cast<uint16_t>(value << 8);
-            requestOamDma       = 3;
+            scheduler.schedule(Scheduler::Event::OAM_DMA_START, scheduler.getTimestamp() + 3);
             break;
         default:
             throw std::logic_error(std::format("Invalid SM83 Write"));
@@ -42,9 +49,9 @@ uint8_t SM83::read(const uint16_t address) const
     switch (address)
     {
         case MemoryMap::IE:
-            return IE;
+            return _registers.IE;
         case MemoryMap::IORegisters::IF:
-            return 0xE0 | IF;
+            return 0xE0 | _registers.IF;
         case MemoryMap::IORegisters::DMA:
             return static_cast<uint8_t>(oamDmaSourceAddress >> 8);
         default:
@@ -60,23 +67,181 @@ IAddressable::AddressableRange SM83::getAddressableRange() const noexcept
 
 void SM83::setPostBootRomRegisters()
 {
-    A  = 0x01;
-    C  = 0x13;
-    E  = 0xD8;
-    H  = 0x01;
-    L  = 0x4D;
-    PC = 0x100;
-    SP = 0xFFFE;
+    _registers.A  = 0x01;
+    _registers.C  = 0x13;
+    _registers.E  = 0xD8;
+    _registers.H  = 0x01;
+    _registers.L  = 0x4D;
+    _registers.PC = 0x100;
+    _registers.SP = 0xFFFE;
 }
 
 void SM83::tick(const size_t machineCycle)
 {
     _machineCyclesElapsed = 0;
+    _machineCycleBudget   = machineCycle;
 
     while (_machineCyclesElapsed < machineCycle)
     {
         runInstruction();
     }
+
+    _machineCycleBudget = std::numeric_limits<size_t>::max();
+}
+
+SM83::StopReason SM83::runUntil(const std::size_t machineCycles, const StopReason stopMask)
+{
+    /* Everything that is not requested is kept out of the loop below. Memory watchpoints are not: their pages are
+     * checked by the accesses themselves. */
+    const auto isBreaking{(stopMask & StopReason::BREAKPOINT) != StopReason::NONE && _breakpoints.any()};
+    const auto isWatchingExecution{(stopMask & StopReason::WATCHPOINT) != StopReason::NONE &&
+                                   std::ranges::any_of(_watchpoints, [](const auto& watchpoint) {
+                                       return (watchpoint.access & Access::EXECUTE) != Access::NONE;
+                                   })};
+
+    _stopMask             = stopMask;
+    _stopReason           = StopReason::NONE;
+    _isStepping           = isBreaking || isWatchingExecution;
+    _machineCyclesElapsed = 0;
+    _machineCycleBudget   = machineCycles;
+    _watchpointHit.reset();
+
+    while (_stopReason == StopReason::NONE)
+    {
+        _instructionAddress = _registers.PC;
+        runInstruction();
+
+        if (isWatchingExecution && (_watchedPages[_registers.PC >> 8] & Access::EXECUTE) != Access::NONE)
+        {
+            _instructionAddress = _registers.PC;
+
+            checkWatchpoints(_registers.PC, bus.peek(_registers.PC), Access::EXECUTE);
+        }
+
+        if (_stopReason != StopReason::NONE)
+        {
+            break;
+        }
+
+        if (isBreaking && _breakpoints.test(_registers.PC))
+        {
+            _stopReason = StopReason::BREAKPOINT;
+        }
+        else if (_machineCyclesElapsed >= machineCycles && _stopReason == StopReason::NONE)
+        {
+            _stopReason = StopReason::BUDGET;
+        }
+    }
+
+    const auto stopReason{_stopReason};
+
+    _stopMask           = StopReason::NONE;
+    _stopReason         = StopReason::NONE;
+    _machineCycleBudget = std::numeric_limits<size_t>::max();
+    _isStepping         = false;
+
+    return stopReason;
+}
+
+void SM83::requestStop(const StopReason reason) noexcept
+{
+    if (_stopReason == StopReason::NONE && (_stopMask & reason) != StopReason::NONE)
+    {
+        _stopReason = reason;
+    }
+}
+
+void SM83::addBreakpoint(const uint16_t address)
+{
+    _breakpoints.set(address);
+}
+
+void SM83::removeBreakpoint(const uint16_t address)
+{
+    _breakpoints.reset(address);
+}
+
+void SM83::addWatchpoint(const Watchpoint& watchpoint)
+{
+    if (watchpoint.range.first > watchpoint.range.second)
+    {
+        throw std::logic_error(std::format("Invalid watchpoint range {:#06x}-{:#06x}", watchpoint.range.first,
+                                           watchpoint.range.second));
+    }
+
+    _watchpoints.push_back(watchpoint);
+    updateWatchedPages();
+}
+
+void SM83::removeWatchpoint(const Watchpoint& watchpoint)
+{
+    std::erase_if(_watchpoints, [&](const auto& other) {
+        return other.range == watchpoint.range && other.access == watchpoint.access;
+    });
+    updateWatchedPages();
+}
+
+const std::optional<SM83::WatchpointHit>& SM83::getWatchpointHit() const noexcept
+{
+    return _watchpointHit;
+}
+
+void SM83::setTrace(BusTrace::RingBuffer* trace)
+{
+    _trace = trace;
+    updateWatchedPages();
+}
+
+void SM83::updateWatchedPages() noexcept
+{
+    _watchedPages.fill(_trace != nullptr ? Access::READ | Access::WRITE : Access::NONE);
+
+    for (const auto& [range, access] : _watchpoints)
+    {
+        for (std::size_t page{range.first / 0x100U}; page <= range.second / 0x100U; ++page)
+        {
+            _watchedPages[page] = _watchedPages[page] | access;
+        }
+    }
+}
+
+void SM83::onWatchedAccess(const uint16_t address, const uint8_t value, const Access access)
+{
+    if (_trace != nullptr)
+    {
+        _trace->push({scheduler.getTimestamp(), _instructionAddress, address, value,
+                      access == Access::WRITE ? BusTrace::Kind::WRITE : BusTrace::Kind::READ});
+    }
+
+    checkWatchpoints(address, value, access);
+}
+
+void SM83::checkWatchpoints(const uint16_t address, const uint8_t value, const Access access)
+{
+    if (_stopReason != StopReason::NONE || (_stopMask & StopReason::WATCHPOINT) == StopReason::NONE)
+    {
+        return;
+    }
+
+    for (const auto& watchpoint : _watchpoints)
+    {
+        if ((watchpoint.access & access) != Access::NONE && Utils::addressIn(address, watchpoint.range))
+        {
+            /* Writes are checked before they happen: the bus still holds the old value. */
+            const auto oldValue{access == Access::WRITE ? bus.peek(address) : value};
+
+            _watchpointHit = {_instructionAddress, address, oldValue, value, access, scheduler.getTimestamp()};
+            requestStop(StopReason::WATCHPOINT);
+            return;
+        }
+    }
+}
+
+void SM83::traceExecution()
+{
+    _instructionAddress = _registers.PC;
+    _trace->push({scheduler.getTimestamp(), _registers.PC, _registers.PC, bus.peek(_registers.PC),
+                  BusTrace::Kind::EXECUTE});
 }
 
 void SM83::runInstruction()
@@ -90,27 +255,60 @@ void SM83::runInstruction()
                 requestIme -= 1;
                 if (requestIme == 0)
                 {
-                    IME = true;
+                    _registers.IME = true;
                 }
             }
 
+            /* A translated block runs several instructions at once: breakpoints, watchpoints and traces need them one
+             * by one. */
+            if (_backend == Backend::RECOMPILER && !_isStepping && _trace == nullptr && runRecompiledInstructions())
+            {
+                break;
+            }
+
+            if (_trace != nullptr) [[unlikely]]
+            {
+                traceExecution();
+            }
+
             fetchInstruction();
             decodeExecuteInstruction();
+            _retiredInstructions += 1;
 
             break;
         }
         case State::STOPPED:
         case State::HALTED:
+            /* Only a scheduled event can request an interrupt: fast-forward to the cycle of the next one, or to the
+             * end of the run. */
+            if (const auto deadline{scheduler.getNextDeadline()}; deadline != Scheduler::NEVER)
+            {
+                const auto budget{_machineCycleBudget > _machineCyclesElapsed + 1
+                                      ? _machineCycleBudget - _machineCyclesElapsed - 1
+                                      : 0};
+                const auto idleMachineCycles{
+                    std::min<Scheduler::Timestamp>(deadline - scheduler.getTimestamp() - 1, budget)};
+
+                scheduler.skip(idleMachineCycles);
+                _machineCyclesElapsed += idleMachineCycles;
+            }
+
             onMachineCycle();
-            if ((IE & IF) != 0)
+            if ((_registers.IE & _registers.IF) != 0)
             {
                 state = State::NORMAL;
             }
             break;
         case State::HALTED_BUG:
+            if (_trace != nullptr) [[unlikely]]
+            {
+                traceExecution();
+            }
+
             fetchInstruction();
-            PC--;
+            _registers.PC--;
             decodeExecuteInstruction();
+            _retiredInstructions += 1;
             break;
     }
 
@@ -119,107 +317,267 @@ void SM83::runInstruction()
 
 void SM83::applyView(const View& view)
 {
-    A = view.registers.A;
-    F = view.registers.F;
-    B = view.registers.B;
-    C = view.registers.C;
-    D = view.registers.D;
-    E = view.registers.E;
-    H = view.registers.H;
-    L = view.registers.L;
+    _pendingFlags = {};
+    _registers    = view.registers;
+}
+
+SM83::View SM83::getView() const
+{
+    View view{_registers};
 
-    AF(view.registers.AF);
-    BC(view.registers.BC);
-    DE(view.registers.DE);
-    HL(view.registers.HL);
+    view.registers.F = flags();
 
-    SP = view.registers.SP;
-    PC = view.registers.PC;
+    return view;
+}
 
-    setFlag(Flags::Carry, view.flags.carry);
-    setFlag(Flags::Subtract, view.flags.subtract);
-    setFlag(Flags::HalfCarry, view.flags.halfCarry);
-    setFlag(Flags::Zero, view.flags.zero);
+void SM83::setBackend(const Backend backend)
+{
+    if (backend == Backend::RECOMPILER)
+    {
+        if (!Recompiler::isSupported())
+        {
+            throw std::runtime_error("The recompiler is not supported on this platform");
+        }
+        if (_recompiler == nullptr)
+        {
+            _recompiler = std::make_unique<Recompiler>();
+        }
+    }
 
-    IE  = view.interrupts.IE;
-    IF  = view.interrupts.IF;
-    IME = view.interrupts.IME;
+    _backend = backend;
 }
 
-SM83::View SM83::getView() const
+SM83::Backend SM83::getBackend() const noexcept
 {
-    View view{};
+    return _backend;
+}
 
-    view.registers.A = A;
-    view.registers.F = F;
-    view.registers.B = B;
-    view.registers.C = C;
-    view.registers.D = D;
-    view.registers.E = E;
-    view.registers.H = H;
-    view.registers.L = L;
+std::size_t SM83::getRetiredInstructions() const noexcept
+{
+    return _retiredInstructions;
+}
 
-    view.registers.AF = AF();
-    view.registers.BC = BC();
-    view.registers.DE = DE();
-    view.registers.HL = HL();
+void SM83::setIdleLoopSkipping(const bool enabled) noexcept
+{
+    _idleLoopSkipping = enabled;
+    _idleLoop.reset();
+}
 
-    view.registers.SP = SP;
-    view.registers.PC = PC;
+bool SM83::isIdleLoopSkipping() const noexcept
+{
+    return _idleLoopSkipping;
+}
 
-    view.flags.carry     = getFlag(Flags::Carry);
-    view.flags.subtract  = getFlag(Flags::Subtract);
-    view.flags.halfCarry = getFlag(Flags::HalfCarry);
-    view.flags.zero      = getFlag(Flags::Zero);
+std::size_t SM83::getSkippedMachineCycles() const noexcept
+{
+    return _skippedMachineCycles;
+}
+
+void SM83::skipIdleLoop(const uint16_t end)
+{
+    /* Traces need every instruction. */
+    if (_registers.PC >= end || end - _registers.PC > MAX_IDLE_LOOP_SIZE || requestIme != 0 || _trace != nullptr)
+    {
+        return;
+    }
 
-    view.interrupts.IE  = IE;
-    view.interrupts.IF  = IF;
-    view.interrupts.IME = IME;
+    const auto timestamp{scheduler.getTimestamp()};
+    const auto view{getView()};
 
-    return view;
+    /*
+     * In between events, no register but DIV and TIMA changes on its own. Therefore, an iteration which started from
+     * the same state, without writing to memory, reading DIV or TIMA, or seeing any event, is bound to be replayed
+     * identically until the next event.
+     */
+    if (!_idleLoop || _idleLoop->start != _registers.PC || _idleLoop->end != end ||
+        _idleLoop->sideEffects != _sideEffects || timestamp >= _idleLoop->nextDeadline || _idleLoop->view != view)
+    {
+        _idleLoop = IdleLoop{
+            _registers.PC, end, timestamp, scheduler.getNextDeadline(), _retiredInstructions, _sideEffects, view};
+        return;
+    }
+
+    /* Nothing can ever break the loop. */
+    if (_idleLoop->nextDeadline == Scheduler::NEVER)
+    {
+        return;
+    }
+
+    /* Whole iterations only, up to the next event or the end of the run, whichever comes first. */
+    const auto machineCycles{timestamp - _idleLoop->timestamp};
+    const auto budget{_machineCycleBudget > _machineCyclesElapsed ? _machineCycleBudget - _machineCyclesElapsed : 0};
+    const auto iterations{std::min<Scheduler::Timestamp>(_idleLoop->nextDeadline - 1 - timestamp, budget) /
+                          machineCycles};
+    const auto skippedMachineCycles{iterations * machineCycles};
+
+    scheduler.skip(skippedMachineCycles);
+    _machineCyclesElapsed += skippedMachineCycles;
+    _retiredInstructions += iterations * (_retiredInstructions - _idleLoop->retiredInstructions);
+    _skippedMachineCycles += skippedMachineCycles;
+
+    _idleLoop->timestamp           = scheduler.getTimestamp();
+    _idleLoop->retiredInstructions = _retiredInstructions;
 }
 
-void SM83::onMachineCycle()
+bool SM83::runRecompiledInstructions()
 {
-    _machineCyclesElapsed += 1;
+    /* A pending EI or OAM DMA has to be observed between instructions: leave them to the interpreter. */
+    if (requestIme != 0 || scheduler.isScheduled(Scheduler::Event::OAM_DMA_START) || emulationState.isInOamDma ||
+        !BlockCache::isCacheable(_registers.PC))
+    {
+        return false;
+    }
+
+    /* Within a block, only look for translated code when the next instruction can be translated. */
+    const auto isInBlock{_block != nullptr && _blockIndex < _block->instructions.size() &&
+                         _block->instructions[_blockIndex].address == _registers.PC};
 
-    if (requestOamDma > 0)
+    if (isInBlock && !Recompiler::isRecompilable(_block->instructions[_blockIndex]))
     {
-        requestOamDma -= 1;
-        if (requestOamDma == 0)
-        {
-            emulationState.isInOamDma  = true;
-            oamDmaElapsedMachineCycles = 0;
-        }
+        return false;
+    }
+
+    const auto  bank{getCodeBank()};
+    const auto* block{_blockCache.get(_registers.PC, bank, bus)};
+
+    if (block == nullptr)
+    {
+        return false;
     }
 
-    if (emulationState.isInOamDma)
+    /* Whatever happens, the interpreter carries on from this block. */
+    _block      = block;
+    _blockIndex = 0;
+
+    const auto* compiled{_recompiler->get(*block, bank)};
+
+    if (compiled == nullptr)
     {
-        oamDmaElapsedMachineCycles += 1;
-        if (oamDmaElapsedMachineCycles == 160)
+        return false;
+    }
+
+    /* Translated instructions do not touch the bus, so their machine cycles can elapse before they run. The run stops
+     * after the instruction at the end of which an interrupt is to be serviced, just like the interpreter. */
+    std::size_t count{0};
+
+    do
+    {
+        for (uint8_t cycle{0}; cycle < compiled->instructions[count].machineCycles; ++cycle)
         {
+            onMachineCycle();
+        }
+        count += 1;
+    } while (count < compiled->instructions.size() && !(_registers.IME && getInterruptRequest() != 0));
+
+    materializeFlags();
+
+    Recompiler::execute(*compiled, _registers, count);
+
+    /* IR holds the opcode of the last instruction run, the one following the prefix for extended instructions. */
+    const auto& last{block->instructions[count - 1]};
+
+    _registers.PC = compiled->instructions[count - 1].nextAddress;
+    _registers.IR = last.bytes[0] == 0xCB ? last.bytes[1] : last.bytes[0];
+
+    _blockIndex = count;
+    _retiredInstructions += count;
+
+    return true;
+}
+
+void SM83::onMachineCycle()
+{
+    _machineCyclesElapsed += 1;
+
+    scheduler.tick();
+}
+
+void SM83::onEvent(const Scheduler::Event event, const Scheduler::Timestamp timestamp)
+{
+    switch (event)
+    {
+        case Scheduler::Event::OAM_DMA_START:
+            /* The transfer lasts 160 machine cycles, counting this one. Restarting OAM DMA pushes the end of the
+             * transfer in progress back. */
+            emulationState.isInOamDma = true;
+            scheduler.schedule(Scheduler::Event::OAM_DMA_END, timestamp + 159);
+            break;
+        case Scheduler::Event::OAM_DMA_END:
             emulationState.isInOamDma = false;
 
             for (auto address{MemoryMap::OAM.first}; address <= MemoryMap::OAM.second; address += 1)
             {
                 bus.write(address, bus.read(oamDmaSourceAddress + (address - MemoryMap::OAM.first)));
             }
-        }
+            break;
+        default:
+            throw std::logic_error(std::format("Unexpected event {:d}", std::to_underlying(event)));
     }
-
-    timer.tick();
-    ppu.tick();
 }
 
 void SM83::fetchInstruction()
 {
-    IR = fetchMemory(PC++);
+    _cachedInstruction = lookupCachedInstruction();
+    _registers.IR      = fetchCode();
+}
+
+const SM83::BlockCache::Instruction* SM83::lookupCachedInstruction()
+{
+    if (_block != nullptr && _blockIndex < _block->instructions.size() &&
+        _block->instructions[_blockIndex].address == _registers.PC)
+    {
+        return &_block->instructions[_blockIndex++];
+    }
+
+    _block = nullptr;
+
+    /* The bus hides most of the memory during OAM DMA: do not decode blocks out of it. */
+    if (emulationState.isInOamDma || !BlockCache::isCacheable(_registers.PC))
+    {
+        return nullptr;
+    }
+
+    _block = _blockCache.get(_registers.PC, getCodeBank(), bus);
+    if (_block == nullptr)
+    {
+        return nullptr;
+    }
+
+    _blockIndex = 1;
+    return &_block->instructions.front();
+}
+
+uint16_t SM83::getCodeBank() const noexcept
+{
+    if (_registers.PC > MemoryMap::ROM.second)
+    {
+        return 0;
+    }
+
+    return _registers.PC >= 0x4000 ? emulationState.romBank : emulationState.lowRomBank;
 }
 
 uint8_t SM83::fetchMemory(const uint16_t address)
+{
+    const auto value{readMemory(address)};
+
+    if ((_watchedPages[address >> 8] & Access::READ) != Access::NONE) [[unlikely]]
+    {
+        onWatchedAccess(address, value, Access::READ);
+    }
+
+    return value;
+}
+
+uint8_t SM83::readMemory(const uint16_t address)
 {
     onMachineCycle();
 
+    if (address == MemoryMap::IORegisters::DIV || address == MemoryMap::IORegisters::TIMA)
+    {
+        _sideEffects += 1;
+    }
+
     /* Let the CPU read the DMA source address even if it is in OAM DMA. */
     if (emulationState.isInOamDma && address == MemoryMap::IORegisters::DMA)
     {
@@ -231,78 +589,107 @@ uint8_t SM83::fetchMemory(const uint16_t address)
 
 uint8_t SM83::fetchOperand()
 {
-    const auto byte{fetchMemory(PC++)};
-    return byte;
+    return fetchCode();
 }
 
-void SM83::writeMemory(const uint16_t address, const uint8_t value)
+uint8_t SM83::fetchCode()
 {
-    onMachineCycle();
+    const auto address{_registers.PC++};
 
-    if (emulationState.isInOamDma && address == MemoryMap::IORegisters::DMA)
+    if (_cachedInstruction == nullptr)
     {
-        /* Do we need to restart OAM DMA ? */
-        if (oamDmaElapsedMachineCycles != 0)
-        {
-            requestOamDma = 3;
-        }
+        return readMemory(address);
+    }
 
-        oamDmaSourceAddress = static_cast<uint16_t>(value << 8);
+    onMachineCycle();
+
+    /* The offset is taken from PC rather than counted, so that the HALT bug reads the right byte. */
+    if (const auto offset{static_cast<uint16_t>(address - _cachedInstruction->address)};
+        !emulationState.isInOamDma && offset < _cachedInstruction->length) [[likely]]
+    {
+        return _cachedInstruction->bytes[offset];
     }
 
-    return bus.write(address, value);
+    return bus.read(address);
 }
 
-uint16_t SM83::AF() const
+void SM83::writeMemory(const uint16_t address, const uint8_t value)
 {
-    return Utils::to_word(A, F);
-}
+    onMachineCycle();
 
-uint16_t SM83::BC() const
-{
-    return Utils::to_word(B, C);
-}
+    _sideEffects += 1;
 
-uint16_t SM83::DE() const
-{
-    return Utils::to_word(D, E);
-}
+    if ((_watchedPages[address >> 8] & Access::WRITE) != Access::NONE) [[unlikely]]
+    {
+        onWatchedAccess(address, value, Access::WRITE);
+    }
 
-uint16_t SM83::HL() const
-{
-    return Utils::to_word(H, L);
-}
+    if (address == MemoryMap::IORegisters::SC && (value & 0x80) != 0)
+    {
+        requestStop(StopReason::SERIAL);
+    }
 
-void SM83::AF(const uint16_t value)
-{
-    Utils::to_bytes(value, A, F);
-}
-void SM83::BC(const uint16_t value)
-{
-    Utils::to_bytes(value, B, C);
+    if (emulationState.isInOamDma && address == MemoryMap::IORegisters::DMA)
+    {
+        /* Restart OAM DMA. */
+        scheduler.schedule(Scheduler::Event::OAM_DMA_START, scheduler.getTimestamp() + 3);
+
+        oamDmaSourceAddress = static_cast<uint16_t>(value << 8);
+    }
+
+    /* Blocks are decoded out of work RAM, never out of its echo. */
+    const auto codeAddress{Utils::addressIn(address, MemoryMap::ECHO_RAM) ? static_cast<uint16_t>(address - 0x2000)
+                                                                          : address};
+
+    if (address == MemoryMap::IORegisters::BOOTM)
+    {
+        /* The boot ROM is unmapped: every block decoded out of it is now stale. */
+        _blockCache.flush();
+        if (_recompiler != nullptr)
+        {
+            _recompiler->flush();
+        }
+        _block             = nullptr;
+        _cachedInstruction = nullptr;
+    }
+    else if (Utils::addressIn(address, MemoryMap::ROM))
+    {
+        /* A write to the cartridge never changes the ROM, but may switch the bank the current block was decoded
+         * from. */
+        _block = nullptr;
+    }
+    else if (_blockCache.isCode(codeAddress))
+    {
+        _blockCache.invalidate(codeAddress);
+        if (_recompiler != nullptr)
+        {
+            _recompiler->invalidate(codeAddress);
+        }
+        _block             = nullptr;
+        _cachedInstruction = nullptr;
+    }
+
+    return bus.write(address, value);
 }
 
-void SM83::DE(const uint16_t value)
+uint16_t SM83::AF() const
 {
-    Utils::to_bytes(value, D, E);
+    return Utils::to_word(_registers.A, flags());
 }
 
-void SM83::HL(const uint16_t value)
+void SM83::AF(const uint16_t value)
 {
-    Utils::to_bytes(value, H, L);
+    _pendingFlags = {};
+    _registers.AF = value;
 }
 
 uint8_t SM83::add(const uint8_t lhs, const uint8_t rhs, const bool carry)
 {
     const auto add_carry{static_cast<uint8_t>(carry ? getFlag(Flags::Carry) : 0)};
-    const auto result{static_cast<uint16_t>(lhs + rhs + add_carry)};
 
-    setFlag(Flags::Zero, (result & 0xFF) == 0);
-    setFlag(Flags::Subtract, false);
-    setFlag(Flags::HalfCarry, (lhs & 0x0F) + (rhs & 0x0F) + add_carry > 0x0F);
-    setFlag(Flags::Carry, result > 0xFF);
+    setFlags(FlagOperation::ADD, lhs, rhs, add_carry);
 
-    return static_cast<uint8_t>(result & 0xFF);
+    return static_cast<uint8_t>(lhs + rhs + add_carry);
 }
 
 uint16_t SM83::add(const uint16_t lhs, const uint16_t rhs)
@@ -342,49 +729,42 @@ void SM83::daa()
 {
     uint8_t adj{};
 
-    if ((!getFlag(Flags::Subtract) && (A & 0x0F) > 0x09) || getFlag(Flags::HalfCarry))
+    if ((!getFlag(Flags::Subtract) && (_registers.A & 0x0F) > 0x09) || getFlag(Flags::HalfCarry))
     {
         adj |= 0x06;
     }
-    if ((!getFlag(Flags::Subtract) && A > 0x99) || getFlag(Flags::Carry))
+    if ((!getFlag(Flags::Subtract) && _registers.A > 0x99) || getFlag(Flags::Carry))
     {
         adj |= 0x60;
         setFlag(Flags::Carry, true);
     }
     if (!getFlag(Flags::Subtract))
     {
-        A += adj;
+        _registers.A += adj;
     }
     else
     {
-        A -= adj;
+        _registers.A -= adj;
     }
 
     setFlag(Flags::HalfCarry, false);
-    setFlag(Flags::Zero, A == 0);
+    setFlag(Flags::Zero, _registers.A == 0);
 }
 
 uint8_t SM83::sub(const uint8_t lhs, const uint8_t rhs, const bool borrow)
 {
     const auto sub_borrow{static_cast<uint8_t>(borrow ? getFlag(Flags::Carry) : 0)};
-    const auto result{static_cast<uint16_t>(lhs - rhs - sub_borrow)};
 
-    setFlag(Flags::Zero, (result & 0xFF) == 0);
-    setFlag(Flags::Subtract, true);
-    setFlag(Flags::HalfCarry, (lhs & 0x0F) < (rhs & 0x0F) + sub_borrow);
-    setFlag(Flags::Carry, lhs < rhs + sub_borrow);
+    setFlags(FlagOperation::SUB, lhs, rhs, sub_borrow);
 
-    return static_cast<uint8_t>(result & 0xFF);
+    return static_cast<uint8_t>(lhs - rhs - sub_borrow);
 }
 
 uint8_t SM83::bitwiseAnd(const uint8_t lhs, const uint8_t rhs)
 {
     const uint8_t result = lhs & rhs;
 
-    setFlag(Flags::Zero, result == 0);
-    setFlag(Flags::Subtract, false);
-    setFlag(Flags::HalfCarry, true);
-    setFlag(Flags::Carry, false);
+    setFlags(FlagOperation::RESULT, result, std::to_underlying(Flags::HalfCarry));
 
     return result;
 }
@@ -393,10 +773,7 @@ uint8_t SM83::bitwiseOr(const uint8_t lhs, const uint8_t rhs)
 {
     const uint8_t result = lhs | rhs;
 
-    setFlag(Flags::Zero, result == 0);
-    setFlag(Flags::Subtract, false);
-    setFlag(Flags::HalfCarry, false);
-    setFlag(Flags::Carry, false);
+    setFlags(FlagOperation::RESULT, result);
 
     return result;
 }
@@ -404,10 +781,7 @@ uint8_t SM83::bitwiseOr(const uint8_t lhs, const uint8_t rhs)
 uint8_t SM83::bitwise_xor(const uint8_t lhs, const uint8_t rhs)
 {
     const uint8_t result = lhs ^ rhs;
-    setFlag(Flags::Zero, result == 0);
-    setFlag(Flags::Subtract, false);
-    setFlag(Flags::HalfCarry, false);
-    setFlag(Flags::Carry, false);
+    setFlags(FlagOperation::RESULT, result);
     return result;
 }
 
@@ -421,10 +795,7 @@ uint8_t SM83::rotate_left(uint8_t op, const bool circular)
         op |= 0x01;
     }
 
-    setFlag(Flags::Zero, op == 0);
-    setFlag(Flags::Subtract, false);
-    setFlag(Flags::HalfCarry, false);
-    setFlag(Flags::Carry, new_carry);
+    setFlags(FlagOperation::RESULT, op, new_carry ? std::to_underlying(Flags::Carry) : 0);
 
     return op;
 }
@@ -439,10 +810,7 @@ uint8_t SM83::rotate_right(uint8_t op, const bool circular)
         op |= 0x80;
     }
 
-    setFlag(Flags::Zero, op == 0);
-    setFlag(Flags::Subtract, false);
-    setFlag(Flags::HalfCarry, false);
-    setFlag(Flags::Carry, new_carry);
+    setFlags(FlagOperation::RESULT, op, new_carry ? std::to_underlying(Flags::Carry) : 0);
 
     return op;
 }
@@ -454,10 +822,7 @@ uint8_t SM83::shift_right(uint8_t op, const bool arithmetic)
 
     op = op >> 1 | (sign && arithmetic ? 0x80 : 0);
 
-    setFlag(Flags::Zero, op == 0);
-    setFlag(Flags::Subtract, false);
-    setFlag(Flags::HalfCarry, false);
-    setFlag(Flags::Carry, new_carry);
+    setFlags(FlagOperation::RESULT, op, new_carry ? std::to_underlying(Flags::Carry) : 0);
 
     return op;
 }
@@ -468,10 +833,7 @@ uint8_t SM83::shift_left(uint8_t op)
 
     op <<= 1;
 
-    setFlag(Flags::Zero, op == 0);
-    setFlag(Flags::Subtract, false);
-    setFlag(Flags::HalfCarry, false);
-    setFlag(Flags::Carry, new_carry);
+    setFlags(FlagOperation::RESULT, op, new_carry ? std::to_underlying(Flags::Carry) : 0);
 
     return op;
 }
@@ -497,10 +859,7 @@ uint8_t SM83::swap(const uint8_t op)
 {
     const auto result{static_cast<uint8_t>((op & 0x0F) << 4 | (op & 0xF0) >> 4)};
 
-    setFlag(Flags::Zero, result == 0);
-    setFlag(Flags::Subtract, false);
-    setFlag(Flags::HalfCarry, false);
-    setFlag(Flags::Carry, false);
+    setFlags(FlagOperation::RESULT, result);
 
     return result;
 }
@@ -519,9 +878,7 @@ uint8_t SM83::inc(uint8_t value)
 {
     value += 1;
 
-    setFlag(Flags::Zero, value == 0);
-    setFlag(Flags::Subtract, false);
-    setFlag(Flags::HalfCarry, (value & 0x0F) == 0);
+    setFlags(FlagOperation::INC, value);
 
     return value;
 }
@@ -530,9 +887,7 @@ uint8_t SM83::dec(uint8_t value)
 {
     value -= 1;
 
-    setFlag(Flags::Zero, value == 0);
-    setFlag(Flags::Subtract, true);
-    setFlag(Flags::HalfCarry, (value & 0x0F) == 0x0F);
+    setFlags(FlagOperation::DEC, value);
 
     return value;
 }
@@ -540,18 +895,30 @@ uint8_t SM83::dec(uint8_t value)
 void SM83::jr()
 {
     const auto e8{static_cast<int8_t>(fetchOperand())};
+    const auto end{_registers.PC};
 
-    PC += e8;
+    _registers.PC += e8;
     onMachineCycle();
+
+    if (_idleLoopSkipping && e8 < 0)
+    {
+        skipIdleLoop(end);
+    }
 }
 
 void SM83::jp()
 {
     const auto lsb{fetchOperand()};
     const auto msb{fetchOperand()};
+    const auto end{_registers.PC};
 
-    PC = Utils::to_word(msb, lsb);
+    _registers.PC = Utils::to_word(msb, lsb);
     onMachineCycle();
+
+    if (_idleLoopSkipping)
+    {
+        skipIdleLoop(end);
+    }
 }
 
 void SM83::call()
@@ -559,8 +926,8 @@ void SM83::call()
     const auto lsb{fetchOperand()};
     const auto msb{fetchOperand()};
 
-    push(PC);
-    PC = Utils::to_word(msb, lsb);
+    push(_registers.PC);
+    _registers.PC = Utils::to_word(msb, lsb);
 }
 
 void SM83::call_cc(Conditionals conditional)
@@ -578,10 +945,10 @@ void SM83::call_cc(Conditionals conditional)
 
 void SM83::ret()
 {
-    const auto lsb{fetchMemory(SP++)};
-    const auto msb{fetchMemory(SP++)};
+    const auto lsb{fetchMemory(_registers.SP++)};
+    const auto msb{fetchMemory(_registers.SP++)};
 
-    PC = Utils::to_word(msb, lsb);
+    _registers.PC = Utils::to_word(msb, lsb);
     onMachineCycle();
 }
 
@@ -621,15 +988,15 @@ void SM83::jr_cc(const Conditionals conditional)
 
 void SM83::rst(const ResetVector rst_vector)
 {
-    push(PC);
-    PC = std::to_underlying(rst_vector);
+    push(_registers.PC);
+    _registers.PC = std::to_underlying(rst_vector);
 }
 
 void SM83::push(const uint8_t msb, const uint8_t lsb)
 {
     onMachineCycle();
-    writeMemory(--SP, msb);
-    writeMemory(--SP, lsb);
+    writeMemory(--_registers.SP, msb);
+    writeMemory(--_registers.SP, lsb);
 }
 
 void SM83::push(const uint16_t value)
@@ -642,26 +1009,85 @@ void SM83::push(const uint16_t value)
 
 void SM83::pop(uint8_t& msb, uint8_t& lsb)
 {
-    lsb = fetchMemory(SP++);
-    msb = fetchMemory(SP++);
+    lsb = fetchMemory(_registers.SP++);
+    msb = fetchMemory(_registers.SP++);
 }
 
 void SM83::pop(uint16_t& value)
 {
-    const auto lsb{fetchMemory(SP++)};
-    const auto msb{fetchMemory(SP++)};
+    const auto lsb{fetchMemory(_registers.SP++)};
+    const auto msb{fetchMemory(_registers.SP++)};
     value = Utils::to_word(msb, lsb);
 }
 
 void SM83::setFlag(const Flags flag, const bool value)
 {
     const auto bit{std::to_underlying(flag)};
-    F = (F & ~bit) | (value ? bit : 0);
+
+    materializeFlags();
+    _registers.F = (_registers.F & ~bit) | (value ? bit : 0);
 }
 
 bool SM83::getFlag(const Flags flag) const
 {
-    return (F & std::to_underlying(flag)) != 0;
+    return (flags() & std::to_underlying(flag)) != 0;
+}
+
+void SM83::setFlags(const FlagOperation operation, const uint8_t lhs, const uint8_t rhs, const uint8_t carry)
+{
+    /* INC and DEC keep the carry of the operation before them. */
+    if (operation == FlagOperation::INC || operation == FlagOperation::DEC)
+    {
+        materializeFlags();
+    }
+
+    _pendingFlags = {operation, lhs, rhs, carry};
+}
+
+uint8_t SM83::flags() const
+{
+    constexpr auto zero{std::to_underlying(Flags::Zero)};
+    constexpr auto subtract{std::to_underlying(Flags::Subtract)};
+    constexpr auto halfCarry{std::to_underlying(Flags::HalfCarry)};
+    constexpr auto carry{std::to_underlying(Flags::Carry)};
+
+    const auto& [operation, lhs, rhs, carryIn]{_pendingFlags};
+
+    switch (operation)
+    {
+        case FlagOperation::ADD:
+        {
+            const auto result{lhs + rhs + carryIn};
+
+            return static_cast<uint8_t>((_registers.F & 0x0F) | ((result & 0xFF) == 0 ? zero : 0) |
+                                        ((lhs & 0x0F) + (rhs & 0x0F) + carryIn > 0x0F ? halfCarry : 0) |
+                                        (result > 0xFF ? carry : 0));
+        }
+        case FlagOperation::SUB:
+            return static_cast<uint8_t>((_registers.F & 0x0F) | subtract |
+                                        (static_cast<uint8_t>(lhs - rhs - carryIn) == 0 ? zero : 0) |
+                                        ((lhs & 0x0F) < (rhs & 0x0F) + carryIn ? halfCarry : 0) |
+                                        (lhs < rhs + carryIn ? carry : 0));
+        case FlagOperation::INC:
+            return static_cast<uint8_t>((_registers.F & (carry | 0x0F)) | (lhs == 0 ? zero : 0) |
+                                        ((lhs & 0x0F) == 0 ? halfCarry : 0));
+        case FlagOperation::DEC:
+            return static_cast<uint8_t>((_registers.F & (carry | 0x0F)) | subtract | (lhs == 0 ? zero : 0) |
+                                        ((lhs & 0x0F) == 0x0F ? halfCarry : 0));
+        case FlagOperation::RESULT:
+            return static_cast<uint8_t>((_registers.F & 0x0F) | (lhs == 0 ? zero : 0) | rhs);
+        default:
+            return _registers.F;
+    }
+}
+
+void SM83::materializeFlags()
+{
+    if (_pendingFlags.operation != FlagOperation::NONE)
+    {
+        _registers.F            = flags();
+        _pendingFlags.operation = FlagOperation::NONE;
+    }
 }
 
 bool SM83::isConditionMet(const Conditionals conditional) const
@@ -683,12 +1109,12 @@ bool SM83::isConditionMet(const Conditionals conditional) const
 
 uint8_t SM83::getInterruptRequest() const
 {
-    return static_cast<uint8_t>(IE & IF & 0x1F);
+    return static_cast<uint8_t>(_registers.IE & _registers.IF & 0x1F);
 }
 
 void SM83::interrupts()
 {
-    if (!IME)
+    if (!_registers.IME)
     {
         return;
     }
@@ -701,15 +1127,15 @@ void SM83::interrupts()
         return;
     }
 
-    IME             = false;
+    _registers.IME  = false;
     interruptVector = 0x40 + bitZeroCount * 8;
-    IF &= ~(1 << bitZeroCount);
+    _registers.IF &= ~(1 << bitZeroCount);
 
     onMachineCycle();
     onMachineCycle();
-    writeMemory(--SP, Utils::wordMsb(PC));
-    writeMemory(--SP, Utils::wordLsb(PC));
+    writeMemory(--_registers.SP, Utils::wordMsb(_registers.PC));
+    writeMemory(--_registers.SP, Utils::wordLsb(_registers.PC));
     onMachineCycle();
 
-    PC = interruptVector;
+    _registers.PC = interruptVector;
 }
@@ -0,0 +1,117 @@
+#include "graphics/LineKernels.hxx"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "graphics/Tile.hxx"
+
+namespace
+{
+    using InstructionSet = Graphics::LineKernels::InstructionSet;
+
+    class LineKernelsTest : public testing::TestWithParam<InstructionSet>
+    {
+      protected:
+        void SetUp() override
+        {
+            if (!Graphics::LineKernels::isSupported(GetParam()))
+            {
+                GTEST_SKIP() << "Instruction set not supported";
+            }
+        }
+
+        [[nodiscard]] static const Graphics::LineKernels& getScalar()
+        {
+            return Graphics::LineKernels::get(InstructionSet::SCALAR);
+        }
+
+        [[nodiscard]] uint8_t random(const uint8_t mask = 0xFF)
+        {
+            return static_cast<uint8_t>(_distribution(_generator) & mask);
+        }
+
+      private:
+        std::mt19937                            _generator{0x6B656D75};
+        std::uniform_int_distribution<unsigned> _distribution{0x00, 0xFF};
+    };
+}  // namespace
+
+TEST_P(LineKernelsTest, DecodesTileRows)
+{
+    const auto& kernels{Graphics::LineKernels::get(GetParam())};
+
+    /* Every count up to a full line, so that the scalar tails are covered. */
+    for (std::size_t count{0}; count <= 21; ++count)
+    {
+        std::vector<uint8_t> bitplanes(2 * count);
+        std::vector<uint8_t> pixels(Graphics::TILE_SIZE * count);
+        std::vector<uint8_t> expected(Graphics::TILE_SIZE * count);
+
+        for (auto& bitplane : bitplanes)
+        {
+            bitplane = random();
+        }
+
+        kernels.decodeTileRows(bitplanes.data(), count, pixels.data());
+        getScalar().decodeTileRows(bitplanes.data(), count, expected.data());
+
+        ASSERT_EQ(pixels, expected) << count << " tiles";
+    }
+}
+
+TEST_P(LineKernelsTest, MixesLines)
+{
+    const auto& kernels{Graphics::LineKernels::get(GetParam())};
+
+    for (std::size_t iteration{0}; iteration < 64; ++iteration)
+    {
+        std::array<uint8_t, Graphics::LINE_WIDTH>         background{};
+        std::array<uint8_t, Graphics::LINE_WIDTH>         objects{};
+        std::array<Graphics::Pixel, Graphics::LINE_WIDTH> line{};
+        std::array<Graphics::Pixel, Graphics::LINE_WIDTH> expected{};
+        const Graphics::Palettes                          palettes{random(), random(), random()};
+
+        for (std::size_t x{0}; x < Graphics::LINE_WIDTH; ++x)
+        {
+            background[x] = random(0x03) | (random() < 0x80 ? Graphics::PixelType::Window << 2 : 0);
+            objects[x]    = random(0x1F);
+        }
+
+        kernels.mixLine(background.data(), objects.data(), palettes, line.data());
+        getScalar().mixLine(background.data(), objects.data(), palettes, expected.data());
+
+        ASSERT_EQ(line, expected);
+    }
+}
+
+TEST_P(LineKernelsTest, AppliesObjectPriority)
+{
+    using Graphics::ObjectPixel;
+
+    const auto&                                       kernels{Graphics::LineKernels::get(GetParam())};
+    std::array<uint8_t, Graphics::LINE_WIDTH>         background{};
+    std::array<uint8_t, Graphics::LINE_WIDTH>         objects{};
+    std::array<Graphics::Pixel, Graphics::LINE_WIDTH> line{};
+
+    background[1] = 0x01;
+    background[3] = 0x02;
+    objects[0]    = ObjectPixel::Present;
+    objects[1]    = ObjectPixel::Present | 0x03;
+    objects[2]    = ObjectPixel::Present | ObjectPixel::Priority | ObjectPixel::Palette;
+    objects[3]    = ObjectPixel::Present | ObjectPixel::Priority | 0x03;
+
+    /* Identity palettes for the background and OBP0, reversed for OBP1. */
+    kernels.mixLine(background.data(), objects.data(), {0xE4, 0xE4, 0x1B}, line.data());
+
+    constexpr uint8_t OBJECT{Graphics::PixelType::Object << 2};
+
+    EXPECT_EQ(line[0], 0x00);
+    EXPECT_EQ(line[1], OBJECT | 0x03);
+    /* A priority object is drawn over background color 0, even with its own color 0. */
+    EXPECT_EQ(line[2], OBJECT | 0x03);
+    EXPECT_EQ(line[3], 0x02);
+}
+
+INSTANTIATE_TEST_SUITE_P(LineKernels, LineKernelsTest,
+                         testing::Values(InstructionSet::SCALAR, InstructionSet::SSE2, InstructionSet::AVX2));
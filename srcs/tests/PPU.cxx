@@ -0,0 +1,273 @@
+#include "hardware/PPU.hxx"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <format>
+#include <random>
+#include <utility>
+
+#include "Common.hxx"
+#include "HeadlessRenderer.hxx"
+#include "graphics/Tile.hxx"
+#include "tests/DummyComponent.hxx"
+
+namespace
+{
+    constexpr Scheduler::Timestamp MACHINE_CYCLES_PER_FRAME{154 * 114};
+
+    struct Registers
+    {
+        uint8_t LCDC;
+        uint8_t SCY;
+        uint8_t SCX;
+        uint8_t WY;
+        uint8_t WX;
+        uint8_t BGP;
+        uint8_t OBP0;
+        uint8_t OBP1;
+    };
+
+    struct Scene
+    {
+        std::vector<uint8_t> videoRam;
+        std::vector<uint8_t> oam;
+        Registers            registers;
+    };
+
+    /**
+     * @brief A scene with random VRAM, OAM and registers. The objects are crowded on the top of the screen, so that
+     * some lines hit the limit of ten objects.
+     */
+    Scene createScene(std::mt19937& generator, const bool withObjects)
+    {
+        std::uniform_int_distribution<unsigned> distribution{0x00, 0xFF};
+
+        const auto byte{[&] { return static_cast<uint8_t>(distribution(generator)); }};
+
+        Scene scene{.videoRam = std::vector<uint8_t>(0x2000), .oam = std::vector<uint8_t>(0xA0), .registers = {}};
+        auto  lcdc{static_cast<uint8_t>(byte() | PPU::LCDControlFlags::LCDAndPPUEnable)};
+
+        if (withObjects)
+        {
+            lcdc |= PPU::LCDControlFlags::ObjEnable;
+        }
+        else
+        {
+            lcdc &= ~PPU::LCDControlFlags::ObjEnable;
+        }
+
+        scene.registers = {
+            .LCDC = lcdc,
+            .SCY  = byte(),
+            .SCX  = byte(),
+            .WY   = static_cast<uint8_t>(byte() % 160),
+            .WX   = static_cast<uint8_t>(byte() % 176),
+            .BGP  = byte(),
+            .OBP0 = byte(),
+            .OBP1 = byte(),
+        };
+
+        for (auto& value : scene.videoRam)
+        {
+            value = byte();
+        }
+        for (std::size_t entry{0}; entry < scene.oam.size(); entry += 4)
+        {
+            scene.oam[entry]     = static_cast<uint8_t>(byte() % 80);
+            scene.oam[entry + 1] = static_cast<uint8_t>(byte() % 176);
+            scene.oam[entry + 2] = byte();
+            scene.oam[entry + 3] = byte();
+        }
+
+        return scene;
+    }
+
+    /**
+     * @brief The scene as drawn one pixel at a time, straight from the tile maps and OAM.
+     */
+    Graphics::Framebuffer drawReference(const Scene& scene)
+    {
+        const auto& [videoRam, oam, registers]{scene};
+        Graphics::Framebuffer framebuffer{};
+        uint8_t               windowLine{0};
+
+        const auto getColor{[&](const uint16_t tileData, const uint8_t column, const uint8_t row)
+        {
+            const auto low{videoRam[tileData + 2 * row]};
+            const auto high{videoRam[tileData + 2 * row + 1]};
+            const auto bit{7 - column};
+
+            return static_cast<uint8_t>((high >> bit & 1) << 1 | (low >> bit & 1));
+        }};
+
+        const auto getTileMapColor{[&](const uint16_t tileMap, const uint8_t column, const uint8_t row)
+        {
+            const auto tileNumber{videoRam[tileMap + column / 8 + 32 * (row / 8)]};
+            const auto tileData{(registers.LCDC & PPU::LCDControlFlags::BGAndWindowTileDataArea) != 0
+                                    ? tileNumber * 16
+                                    : 0x1000 + static_cast<int8_t>(tileNumber) * 16};
+
+            return getColor(static_cast<uint16_t>(tileData), column % 8, row % 8);
+        }};
+
+        const auto objectHeight{(registers.LCDC & PPU::LCDControlFlags::ObjSize) != 0 ? 16 : 8};
+
+        for (uint8_t y{0}; y < 144; ++y)
+        {
+            bool                     isWindowDrawn{false};
+            std::vector<std::size_t> objects{};
+
+            /* The first ten objects in OAM on the line, the leftmost first. */
+            for (std::size_t entry{0}; entry < oam.size() && objects.size() < 10; entry += 4)
+            {
+                if (y + 16 >= oam[entry] && y + 16 < oam[entry] + objectHeight)
+                {
+                    objects.push_back(entry);
+                }
+            }
+            std::ranges::stable_sort(objects, {}, [&](const std::size_t entry) { return oam[entry + 1]; });
+
+            for (uint8_t x{0}; x < 160; ++x)
+            {
+                uint8_t color{0};
+                bool    isWindow{false};
+
+                if ((registers.LCDC & PPU::LCDControlFlags::BGWindowEnableOrPriority) != 0)
+                {
+                    isWindow = (registers.LCDC & PPU::LCDControlFlags::WindowEnable) != 0 && registers.WX != 0 &&
+                               registers.WY != 0 && y >= registers.WY && x + 7 >= registers.WX;
+
+                    if (isWindow)
+                    {
+                        const auto tileMap{static_cast<uint16_t>(
+                            (registers.LCDC & PPU::LCDControlFlags::WindowTileMapSelect) != 0 ? 0x1C00 : 0x1800)};
+
+                        color = getTileMapColor(tileMap, static_cast<uint8_t>(x + 7 - registers.WX), windowLine);
+                    }
+                    else
+                    {
+                        const auto tileMap{static_cast<uint16_t>(
+                            (registers.LCDC & PPU::LCDControlFlags::BGTileMapSelect) != 0 ? 0x1C00 : 0x1800)};
+
+                        color = getTileMapColor(tileMap, static_cast<uint8_t>(registers.SCX + x),
+                                                static_cast<uint8_t>(registers.SCY + y));
+                    }
+                }
+
+                isWindowDrawn = isWindowDrawn || isWindow;
+                framebuffer[y][x] =
+                    static_cast<uint8_t>(Graphics::getRealColorIndexFromPaletteRegister(color, registers.BGP) |
+                                         (isWindow ? Graphics::PixelType::Window << 2 : 0));
+
+                /* The first object covering the pixel is the one drawn, even where it is transparent. */
+                const auto object{std::ranges::find_if(objects, [&](const std::size_t entry)
+                                                       { return x + 8 >= oam[entry + 1] && x < oam[entry + 1]; })};
+
+                if ((registers.LCDC & PPU::LCDControlFlags::ObjEnable) == 0 || object == objects.end())
+                {
+                    continue;
+                }
+
+                const auto entry{*object};
+                const auto flags{oam[entry + 3]};
+                auto       row{y + 16 - oam[entry]};
+                auto       column{x + 8 - oam[entry + 1]};
+
+                row    = (flags & 0x40) != 0 ? objectHeight - 1 - row : row;
+                column = (flags & 0x20) != 0 ? 7 - column : column;
+
+                const auto tile{objectHeight == 16 ? oam[entry + 2] & 0xFE : oam[entry + 2]};
+                const auto objectColor{getColor(static_cast<uint16_t>(tile * 16 + 2 * (row / 8) * 8),
+                                                static_cast<uint8_t>(column), static_cast<uint8_t>(row % 8))};
+
+                if ((flags & 0x80) != 0 ? color == 0 : objectColor != 0)
+                {
+                    framebuffer[y][x] = static_cast<uint8_t>(
+                        Graphics::getRealColorIndexFromPaletteRegister(
+                            objectColor, (flags & 0x10) != 0 ? registers.OBP1 : registers.OBP0) |
+                        Graphics::PixelType::Object << 2);
+                }
+            }
+
+            windowLine += isWindowDrawn ? 1 : 0;
+        }
+
+        return framebuffer;
+    }
+
+    /**
+     * @brief Check that the PPU draws the scene as the reference does, with every supported instruction set.
+     */
+    void expectDrawnAsReference(const Scene& scene)
+    {
+        const auto& registers{scene.registers};
+        const auto  expected{drawReference(scene)};
+
+        for (const auto instructionSet : {Graphics::LineKernels::InstructionSet::SCALAR,
+                                          Graphics::LineKernels::InstructionSet::SSE2,
+                                          Graphics::LineKernels::InstructionSet::AVX2})
+        {
+            if (!Graphics::LineKernels::isSupported(instructionSet))
+            {
+                continue;
+            }
+
+            Scheduler                         scheduler{};
+            DummyComponent                    bus{};
+            HeadlessRenderer                  renderer{};
+            BasicPPU<PPU::Accuracy::SCANLINE> ppu{bus, renderer, scheduler};
+
+            ppu.setInstructionSet(instructionSet);
+
+            for (std::size_t address{0}; address < scene.videoRam.size(); ++address)
+            {
+                ppu.write(static_cast<uint16_t>(MemoryMap::VIDEO_RAM.first + address), scene.videoRam[address]);
+            }
+            for (std::size_t address{0}; address < scene.oam.size(); ++address)
+            {
+                ppu.write(static_cast<uint16_t>(MemoryMap::OAM.first + address), scene.oam[address]);
+            }
+
+            ppu.write(MemoryMap::IORegisters::SCY, registers.SCY);
+            ppu.write(MemoryMap::IORegisters::SCX, registers.SCX);
+            ppu.write(MemoryMap::IORegisters::WY, registers.WY);
+            ppu.write(MemoryMap::IORegisters::WX, registers.WX);
+            ppu.write(MemoryMap::IORegisters::BGP, registers.BGP);
+            ppu.write(MemoryMap::IORegisters::OBP0, registers.OBP0);
+            ppu.write(MemoryMap::IORegisters::OBP1, registers.OBP1);
+            ppu.write(MemoryMap::IORegisters::LCDC, registers.LCDC);
+
+            for (Scheduler::Timestamp machineCycle{0}; machineCycle < MACHINE_CYCLES_PER_FRAME; ++machineCycle)
+            {
+                scheduler.tick();
+            }
+
+            ASSERT_EQ(renderer.getFrameCount(), 1);
+            ASSERT_EQ(renderer.getFramebuffer(), expected)
+                << std::format("LCDC={:#04x} SCY={} SCX={} WY={} WX={} instruction set {}", registers.LCDC,
+                               registers.SCY, registers.SCX, registers.WY, registers.WX,
+                               std::to_underlying(instructionSet));
+        }
+    }
+}  // namespace
+
+TEST(PPU, DrawsBackgroundAndWindow)
+{
+    std::mt19937 generator{0x6B656D75};
+
+    for (std::size_t iteration{0}; iteration < 64; ++iteration)
+    {
+        ASSERT_NO_FATAL_FAILURE(expectDrawnAsReference(createScene(generator, false)));
+    }
+}
+
+TEST(PPU, DrawsObjects)
+{
+    std::mt19937 generator{0x6F626A73};
+
+    for (std::size_t iteration{0}; iteration < 64; ++iteration)
+    {
+        ASSERT_NO_FATAL_FAILURE(expectDrawnAsReference(createScene(generator, true)));
+    }
+}
@@ -0,0 +1,236 @@
+#include "hardware/RealTimeClock.hxx"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+#include "hardware/Cartridge.hxx"
+
+namespace
+{
+    using enum RealTimeClock::Register;
+
+    constexpr Scheduler::Timestamp CYCLES_PER_SECOND{0x100000};
+
+    void latch(RealTimeClock& clock)
+    {
+        clock.latch(0x00);
+        clock.latch(0x01);
+    }
+
+    /**
+     * @brief An MBC3+TIMER+RAM+BATTERY cartridge with 32 KiB of RAM by default, whose program is never run.
+     */
+    std::filesystem::path createRom(const std::filesystem::path& path, const uint8_t ramSize = 0x03)
+    {
+        std::vector<uint8_t> rom(0x8000, 0x00);
+        uint8_t              checksum{0};
+
+        rom[0x0147] = 0x10;
+        rom[0x0148] = 0x00;
+        rom[0x0149] = ramSize;
+        for (std::size_t address{0x0134}; address <= 0x014C; ++address)
+        {
+            checksum = static_cast<uint8_t>(checksum - rom[address] - 1);
+        }
+        rom[0x014D] = checksum;
+
+        std::ofstream output{path, std::ios::binary};
+
+        output.write(reinterpret_cast<const char*>(rom.data()), static_cast<std::streamsize>(rom.size()));
+        return path;
+    }
+}  // namespace
+
+TEST(RealTimeClock, FollowsEmulatedTime)
+{
+    Scheduler     scheduler{};
+    RealTimeClock clock{scheduler};
+
+    clock.reset();
+    scheduler.skip(CYCLES_PER_SECOND * (2 * 24 * 60 * 60 + 3 * 60 * 60 + 4 * 60 + 5) + CYCLES_PER_SECOND / 2);
+
+    EXPECT_EQ(clock.read(SECONDS), 0);
+    latch(clock);
+    EXPECT_EQ(clock.read(SECONDS), 5);
+    EXPECT_EQ(clock.read(MINUTES), 4);
+    EXPECT_EQ(clock.read(HOURS), 3);
+    EXPECT_EQ(clock.read(DAYS_LOW), 2);
+    EXPECT_EQ(clock.read(DAYS_HIGH), 0);
+
+    /* Latching takes a 0x00 write first. */
+    scheduler.skip(CYCLES_PER_SECOND);
+    clock.latch(0x01);
+    EXPECT_EQ(clock.read(SECONDS), 5);
+    latch(clock);
+    EXPECT_EQ(clock.read(SECONDS), 6);
+}
+
+TEST(RealTimeClock, HaltsAndResetsDivider)
+{
+    Scheduler     scheduler{};
+    RealTimeClock clock{scheduler};
+
+    clock.reset();
+    clock.write(DAYS_HIGH, 0x40);
+    clock.write(MINUTES, 59);
+    clock.write(SECONDS, 59);
+    scheduler.skip(CYCLES_PER_SECOND * 10);
+    latch(clock);
+    EXPECT_EQ(clock.read(SECONDS), 59);
+    EXPECT_EQ(clock.read(DAYS_HIGH), 0x40);
+
+    clock.write(DAYS_HIGH, 0x00);
+    scheduler.skip(CYCLES_PER_SECOND - 1);
+    latch(clock);
+    EXPECT_EQ(clock.read(SECONDS), 59);
+
+    scheduler.skip(1);
+    latch(clock);
+    EXPECT_EQ(clock.read(SECONDS), 0);
+    EXPECT_EQ(clock.read(MINUTES), 0);
+    EXPECT_EQ(clock.read(HOURS), 1);
+}
+
+TEST(RealTimeClock, SetsDayCarry)
+{
+    Scheduler     scheduler{};
+    RealTimeClock clock{scheduler};
+
+    clock.reset();
+    clock.write(DAYS_HIGH, 0x01);
+    clock.write(DAYS_LOW, 0xFF);
+    clock.write(HOURS, 23);
+    clock.write(MINUTES, 59);
+    clock.write(SECONDS, 59);
+    scheduler.skip(CYCLES_PER_SECOND);
+    latch(clock);
+
+    EXPECT_EQ(clock.read(DAYS_LOW), 0);
+    EXPECT_EQ(clock.read(DAYS_HIGH), 0x80);
+
+    /* The carry stays set until cleared by a write. */
+    scheduler.skip(CYCLES_PER_SECOND);
+    latch(clock);
+    EXPECT_EQ(clock.read(DAYS_HIGH), 0x80);
+    clock.write(DAYS_HIGH, 0x00);
+    latch(clock);
+    EXPECT_EQ(clock.read(DAYS_HIGH), 0x00);
+}
+
+TEST(RealTimeClock, RestoresSave)
+{
+    Scheduler                                     scheduler{};
+    RealTimeClock                                 clock{scheduler};
+    std::array<uint8_t, RealTimeClock::SAVE_SIZE> state{};
+
+    clock.reset();
+    clock.write(HOURS, 12);
+    latch(clock);
+    clock.write(MINUTES, 34);
+    clock.save(state);
+
+    RealTimeClock emulated{scheduler};
+
+    emulated.restore(state, RealTimeClock::Mode::EMULATED);
+    EXPECT_EQ(emulated.read(HOURS), 12);
+    EXPECT_EQ(emulated.read(MINUTES), 0);
+    latch(emulated);
+    EXPECT_EQ(emulated.read(MINUTES), 34);
+
+    /* Saved an hour ago. */
+    uint64_t savedAt{0};
+
+    for (std::size_t index{0}; index < 8; ++index)
+    {
+        savedAt |= static_cast<uint64_t>(state[40 + index]) << (index * 8);
+    }
+    savedAt -= 60 * 60;
+    for (std::size_t index{0}; index < 8; ++index)
+    {
+        state[40 + index] = static_cast<uint8_t>(savedAt >> (index * 8));
+    }
+
+    RealTimeClock realTime{scheduler};
+
+    realTime.restore(state, RealTimeClock::Mode::REAL_TIME);
+    latch(realTime);
+    EXPECT_EQ(realTime.read(HOURS), 13);
+    EXPECT_EQ(realTime.read(MINUTES), 34);
+
+    state.fill(0xFF);
+    realTime.restore(state, RealTimeClock::Mode::REAL_TIME);
+    latch(realTime);
+    EXPECT_EQ(realTime.read(HOURS), 0);
+}
+
+TEST(RealTimeClock, PersistsWithCartridge)
+{
+    const auto rom{createRom(std::filesystem::temp_directory_path() / "gbemu_rtc.gb")};
+    const auto save{std::filesystem::temp_directory_path() / "gbemu_rtc.sav"};
+
+    std::filesystem::remove(save);
+
+    {
+        EmulationState state{};
+        Scheduler      scheduler{};
+        Cartridge      cartridge{state, scheduler};
+
+        cartridge.load(rom);
+        ASSERT_TRUE(cartridge.hasRealTimeClock());
+        cartridge.attachSave(save, SaveFile::Mode::COPY, RealTimeClock::Mode::EMULATED);
+
+        cartridge.write(0x0000, 0x0A);
+        cartridge.write(0x4000, 0x08);
+        cartridge.write(0xA000, 30);
+        scheduler.skip(CYCLES_PER_SECOND * 2);
+        cartridge.write(0x6000, 0x00);
+        cartridge.write(0x6000, 0x01);
+        EXPECT_EQ(cartridge.read(0xA000), 32);
+
+        cartridge.write(0x4000, 0x00);
+        cartridge.write(0xA000, 0x12);
+    }
+
+    EXPECT_EQ(std::filesystem::file_size(save), 0x8000 + RealTimeClock::SAVE_SIZE);
+
+    EmulationState state{};
+    Scheduler      scheduler{};
+    Cartridge      cartridge{state, scheduler};
+
+    cartridge.load(rom);
+    cartridge.attachSave(save, SaveFile::Mode::COPY, RealTimeClock::Mode::EMULATED);
+    cartridge.write(0x0000, 0x0A);
+    EXPECT_EQ(cartridge.read(0xA000), 0x12);
+
+    cartridge.write(0x4000, 0x08);
+    cartridge.write(0x6000, 0x00);
+    cartridge.write(0x6000, 0x01);
+    EXPECT_EQ(cartridge.read(0xA000), 32);
+
+    std::filesystem::remove(rom);
+    std::filesystem::remove(save);
+}
+
+TEST(RealTimeClock, PersistsWithoutRam)
+{
+    const auto rom{createRom(std::filesystem::temp_directory_path() / "gbemu_rtc_no_ram.gb", 0x00)};
+    const auto save{std::filesystem::temp_directory_path() / "gbemu_rtc_no_ram.sav"};
+
+    std::filesystem::remove(save);
+
+    {
+        EmulationState state{};
+        Scheduler      scheduler{};
+        Cartridge      cartridge{state, scheduler};
+
+        cartridge.load(rom);
+        ASSERT_TRUE(cartridge.hasBattery());
+        cartridge.attachSave(save, SaveFile::Mode::COPY, RealTimeClock::Mode::EMULATED);
+    }
+
+    EXPECT_EQ(std::filesystem::file_size(save), RealTimeClock::SAVE_SIZE);
+
+    std::filesystem::remove(rom);
+    std::filesystem::remove(save);
+}
@@ -0,0 +1,46 @@
+#include "hardware/RomImage.hxx"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+
+#include "hardware/Cartridge.hxx"
+
+namespace
+{
+    const std::filesystem::path ROM{ROMS_PATH "/mooneye/emulator-only/mbc1/rom_1Mb.gb"};
+}
+
+TEST(RomImage, MatchesFile)
+{
+    const auto                 image{RomImage::open(ROM)};
+    std::ifstream              input{ROM, std::ios::binary};
+    const std::vector<uint8_t> file{std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{}};
+
+    ASSERT_EQ(image->getData().size(), file.size());
+    EXPECT_TRUE(std::ranges::equal(image->getData(), file));
+    EXPECT_EQ(image->getHeader().type, file[0x0147]);
+}
+
+TEST(RomImage, IsSharedByCartridges)
+{
+    EmulationState first{};
+    EmulationState second{};
+    Scheduler      scheduler{};
+    Cartridge      firstCartridge{first, scheduler};
+    Cartridge      secondCartridge{second, scheduler};
+
+    firstCartridge.load(ROM);
+    secondCartridge.load(ROM);
+
+    EXPECT_EQ(static_cast<std::span<const uint8_t>>(firstCartridge).data(),
+              static_cast<std::span<const uint8_t>>(secondCartridge).data());
+    EXPECT_EQ(RomImage::open(ROM)->getData().data(), static_cast<std::span<const uint8_t>>(firstCartridge).data());
+}
+
+TEST(RomImage, RejectsInvalidFiles)
+{
+    EXPECT_THROW(static_cast<void>(RomImage::open(ROMS_PATH "/test/invalid_size.gb")), std::runtime_error);
+    EXPECT_THROW(static_cast<void>(RomImage::open(ROMS_PATH "/test/missing.gb")), std::runtime_error);
+}
@@ -0,0 +1,180 @@
+#include "hardware/SaveFile.hxx"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+#include "hardware/Cartridge.hxx"
+
+namespace
+{
+    const std::filesystem::path ROM{ROMS_PATH "/mooneye/emulator-only/mbc1/ram_256kb.gb"};
+
+    class SaveFileTest : public testing::TestWithParam<SaveFile::Mode>
+    {
+      protected:
+        void SetUp() override
+        {
+            auto name{std::string{testing::UnitTest::GetInstance()->current_test_info()->name()}};
+
+            std::ranges::replace(name, '/', '_');
+            _path = std::filesystem::temp_directory_path() / std::format("gbemu_{}.sav", name);
+            std::filesystem::remove(_path);
+        }
+
+        void TearDown() override
+        {
+            std::filesystem::remove(_path);
+        }
+
+        [[nodiscard]] std::vector<uint8_t> readSave() const
+        {
+            std::ifstream input{_path, std::ios::binary};
+
+            return {std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{}};
+        }
+
+        std::filesystem::path _path{};
+    };
+}  // namespace
+
+TEST_P(SaveFileTest, CreatesBlankSave)
+{
+    {
+        SaveFile save{_path, 0x2000, GetParam()};
+
+        ASSERT_EQ(save.getRam().size(), 0x2000);
+        EXPECT_TRUE(std::ranges::all_of(save.getRam(), [](const auto byte) { return byte == 0xFF; }));
+    }
+
+    EXPECT_FALSE(std::filesystem::exists(std::filesystem::path{_path} += ".tmp"));
+}
+
+TEST_P(SaveFileTest, PersistsCommittedRam)
+{
+    {
+        SaveFile save{_path, 0x2000, GetParam()};
+
+        save.getRam()[0x0000] = 0x12;
+        save.getRam()[0x1FFF] = 0x34;
+        save.markDirty();
+        save.commit();
+
+        save.getRam()[0x1000] = 0x56;
+        save.markDirty();
+    }
+
+    const auto file{readSave()};
+
+    ASSERT_EQ(file.size(), 0x2000);
+    EXPECT_EQ(file[0x0000], 0x12);
+    EXPECT_EQ(file[0x1000], 0x56);
+    EXPECT_EQ(file[0x1FFF], 0x34);
+
+    SaveFile save{_path, 0x2000, GetParam()};
+
+    EXPECT_TRUE(std::ranges::equal(save.getRam(), file));
+}
+
+TEST_P(SaveFileTest, PadsShorterSaves)
+{
+    {
+        std::ofstream output{_path, std::ios::binary};
+
+        output.put(0x12);
+    }
+
+    {
+        SaveFile save{_path, 0x2000, GetParam()};
+
+        EXPECT_EQ(save.getRam()[0], 0x12);
+        EXPECT_TRUE(std::ranges::all_of(save.getRam().subspan(1), [](const auto byte) { return byte == 0xFF; }));
+    }
+}
+
+TEST_P(SaveFileTest, RetriesFailedWrites)
+{
+    if (GetParam() == SaveFile::Mode::MAPPED)
+    {
+        GTEST_SKIP() << "The kernel writes mapped saves back";
+    }
+
+    /* The temporary file the save is written to cannot be created while a directory is in the way. */
+    const auto temporaryPath{std::filesystem::path{_path} += ".tmp"};
+
+    std::filesystem::create_directory(temporaryPath);
+
+    {
+        SaveFile                   save{_path, 0x2000, GetParam()};
+        std::optional<std::string> error{};
+
+        save.getRam()[0x0000] = 0x12;
+        save.markDirty();
+        save.commit();
+
+        for (std::size_t attempt{0}; attempt < 1000 && !error; ++attempt)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            error = save.takeError();
+        }
+
+        ASSERT_TRUE(error.has_value());
+        EXPECT_FALSE(save.takeError().has_value());
+
+        /* Without any new change, the next commit writes what failed. */
+        std::filesystem::remove(temporaryPath);
+        save.commit();
+
+        for (std::size_t attempt{0}; attempt < 1000 && !std::filesystem::exists(_path); ++attempt)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+
+        ASSERT_TRUE(std::filesystem::exists(_path));
+    }
+
+    EXPECT_EQ(readSave()[0x0000], 0x12);
+    EXPECT_FALSE(std::filesystem::exists(temporaryPath));
+}
+
+TEST_P(SaveFileTest, PersistsCartridgeRam)
+{
+    {
+        EmulationState state{};
+        Scheduler      scheduler{};
+        Cartridge      cartridge{state, scheduler};
+
+        cartridge.load(ROM);
+        ASSERT_TRUE(cartridge.hasBattery());
+        cartridge.attachSave(_path, GetParam(), RealTimeClock::Mode::EMULATED);
+
+        EXPECT_EQ(cartridge.getWritablePage(MemoryMap::EXT_RAM.first), nullptr);
+
+        /* Enable the RAM, then select its second bank in mode 1. */
+        cartridge.write(0x0000, 0x0A);
+        cartridge.write(0x6000, 0x01);
+        cartridge.write(0x4000, 0x01);
+        cartridge.write(0xA000, 0x12);
+        cartridge.commitSave();
+    }
+
+    EmulationState state{};
+    Scheduler      scheduler{};
+    Cartridge      cartridge{state, scheduler};
+
+    cartridge.load(ROM);
+    cartridge.attachSave(_path, GetParam(), RealTimeClock::Mode::EMULATED);
+    cartridge.write(0x0000, 0x0A);
+    cartridge.write(0x6000, 0x01);
+
+    EXPECT_EQ(cartridge.read(0xA000), 0xFF);
+    cartridge.write(0x4000, 0x01);
+    EXPECT_EQ(cartridge.read(0xA000), 0x12);
+    EXPECT_EQ(readSave().size(), 0x8000);
+}
+
+INSTANTIATE_TEST_SUITE_P(SaveFile, SaveFileTest, testing::Values(SaveFile::Mode::COPY, SaveFile::Mode::MAPPED));
@@ -0,0 +1,62 @@
+#include "graphics/TileCache.hxx"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+namespace
+{
+    void expectDecoded(const Graphics::TileCache& cache, const std::vector<uint8_t>& tileData)
+    {
+        for (std::size_t tile{0}; tile < Graphics::TileCache::TILE_COUNT; ++tile)
+        {
+            for (std::size_t row{0}; row < Graphics::TILE_SIZE; ++row)
+            {
+                const auto address{Graphics::BYTES_PER_LINE * tile + 2 * row};
+                auto       expected{Graphics::decodeTileRow(tileData[address], tileData[address + 1])};
+
+                ASSERT_TRUE(std::ranges::equal(cache.getRow(tile, row), expected)) << tile << ", " << row;
+                std::ranges::reverse(expected);
+                ASSERT_TRUE(std::ranges::equal(cache.getRow(tile, row, true), expected)) << tile << ", " << row;
+            }
+        }
+    }
+}  // namespace
+
+TEST(TileCache, DecodesInvalidatedRows)
+{
+    std::mt19937                            generator{0x74696C65};
+    std::uniform_int_distribution<unsigned> distribution{0x00, 0xFF};
+    std::vector<uint8_t>                    tileData(Graphics::TileCache::TILE_DATA_SIZE);
+    Graphics::TileCache                     cache{};
+
+    const auto& kernels{Graphics::LineKernels::get(Graphics::LineKernels::getBestInstructionSet())};
+
+    for (auto& value : tileData)
+    {
+        value = static_cast<uint8_t>(distribution(generator));
+    }
+
+    cache.update(Graphics::TileCache::TileData{tileData}, kernels);
+    ASSERT_NO_FATAL_FAILURE(expectDecoded(cache, tileData));
+
+    /* The first row is left out, to check that rows not invalidated keep what they decoded to. */
+    const std::vector<uint8_t>              stale{tileData};
+    std::uniform_int_distribution<uint16_t> offsets{2, Graphics::TileCache::TILE_DATA_SIZE - 1};
+
+    for (std::size_t write{0}; write < 256; ++write)
+    {
+        const auto offset{offsets(generator)};
+
+        tileData[offset] = static_cast<uint8_t>(distribution(generator));
+        cache.invalidate(offset);
+    }
+
+    tileData[0] = static_cast<uint8_t>(~tileData[0]);
+    cache.update(Graphics::TileCache::TileData{tileData}, kernels);
+
+    EXPECT_TRUE(std::ranges::equal(cache.getRow(0, 0), Graphics::decodeTileRow(stale[0], stale[1])));
+    tileData[0] = stale[0];
+    ASSERT_NO_FATAL_FAILURE(expectDecoded(cache, tileData));
+}
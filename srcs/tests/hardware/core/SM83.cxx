@@ -21,7 +21,7 @@ namespace Test
     {
         for (const auto& byte : instruction)
         {
-            address_space->write(cpu->PC, byte);
+            address_space->write(cpu->_registers.PC, byte);
         }
 
         cpu->fetchInstruction();
@@ -0,0 +1,86 @@
+#include "tests/roms/AccuracyLockstep.hxx"
+
+#include <format>
+
+void AccuracyLockstep::TearDown()
+{
+    _reference.reset();
+    TestRom::TearDown();
+}
+
+void AccuracyLockstep::executeROM(const std::string& romName)
+{
+    for (const auto accuracy : {PPU::Accuracy::SCANLINE, PPU::Accuracy::FRAME})
+    {
+        SCOPED_TRACE(std::format("Accuracy {:d}", std::to_underlying(accuracy)));
+
+        _component = std::make_unique<Component>(accuracy);
+        _reference = std::make_unique<Component>();
+
+        loadROM(ROMS_PATH + std::string{"/mooneye/acceptance/"} + romName);
+
+        for (uint16_t address{MemoryMap::ROM.first}; address <= MemoryMap::ROM.second; ++address)
+        {
+            _reference->fakeRam.write(address, _component->fakeRam.read(address));
+        }
+
+        run();
+
+        if (HasFatalFailure())
+        {
+            return;
+        }
+    }
+}
+
+void AccuracyLockstep::run()
+{
+    for (const auto& component : {_component.get(), _reference.get()})
+    {
+        component->cpu.setPostBootRomRegisters();
+        component->bus.setPostBootRomRegisters();
+        component->ppu->setPostBootRomRegisters();
+    }
+
+    while (true)
+    {
+        for (const auto& component : {_component.get(), _reference.get()})
+        {
+            component->cpu.runInstruction();
+
+            /* There is no serial port: transfers complete at once. */
+            if (component->bus.read(0xFF02) == 0x81)
+            {
+                component->bus.write(0xFF02, 0x00);
+            }
+        }
+
+        ASSERT_EQ(_reference->cpu.getRetiredInstructions(), _component->cpu.getRetiredInstructions());
+        ASSERT_EQ(_reference->scheduler.getTimestamp(), _component->scheduler.getTimestamp());
+        ASSERT_TRUE(_component->cpu.getView() == _reference->cpu.getView())
+            << std::format("Diverged from the reference at PC {:#06x}", _reference->cpu.getView().registers.PC);
+
+        if (const auto result{getMooneyeResult(*_component)}; result != MooneyeResult::RUNNING)
+        {
+            ASSERT_TRUE(result == MooneyeResult::PASSED)
+                << std::format("{} at PC {:#06x}", result == MooneyeResult::FAILED ? "Failed" : "Timed out",
+                               _component->cpu.getView().registers.PC);
+            break;
+        }
+    }
+}
+
+TEST_F(AccuracyLockstep, HaltIme1Timing)
+{
+    ASSERT_NO_THROW(executeROM("halt_ime1_timing.gb"));
+}
+
+TEST_F(AccuracyLockstep, IntrTiming)
+{
+    ASSERT_NO_THROW(executeROM("intr_timing.gb"));
+}
+
+TEST_F(AccuracyLockstep, IfIeRegisters)
+{
+    ASSERT_NO_THROW(executeROM("if_ie_registers.gb"));
+}
@@ -0,0 +1,129 @@
+#include "tests/roms/IdleLoopLockstep.hxx"
+
+#include <format>
+
+void IdleLoopLockstep::SetUp()
+{
+    TestRom::SetUp();
+    _reference = std::make_unique<Component>();
+    _component->cpu.setIdleLoopSkipping(true);
+}
+
+void IdleLoopLockstep::TearDown()
+{
+    _reference.reset();
+    TestRom::TearDown();
+}
+
+void IdleLoopLockstep::executeROM(const std::string& romName)
+{
+    loadROM(ROMS_PATH + std::string{"/mooneye/acceptance/"} + romName);
+
+    for (uint16_t address{MemoryMap::ROM.first}; address <= MemoryMap::ROM.second; ++address)
+    {
+        _reference->fakeRam.write(address, _component->fakeRam.read(address));
+    }
+
+    run();
+}
+
+void IdleLoopLockstep::executeProgram(const std::span<const uint8_t> program)
+{
+    for (const auto& component : {_component.get(), _reference.get()})
+    {
+        for (uint16_t offset{0}; offset < program.size(); ++offset)
+        {
+            component->fakeRam.write(0x100 + offset, program[offset]);
+        }
+    }
+
+    run();
+}
+
+void IdleLoopLockstep::run()
+{
+    for (const auto& component : {_component.get(), _reference.get()})
+    {
+        component->cpu.setPostBootRomRegisters();
+        component->bus.setPostBootRomRegisters();
+        component->ppu->setPostBootRomRegisters();
+    }
+
+    while (true)
+    {
+        const auto pc{_component->cpu.getView().registers.PC};
+
+        _component->cpu.runInstruction();
+
+        /* Both CPUs are halted when no instruction retires: then, the reference catches up in time only. */
+        while (_reference->cpu.getRetiredInstructions() < _component->cpu.getRetiredInstructions() ||
+               (_reference->cpu.getRetiredInstructions() == _component->cpu.getRetiredInstructions() &&
+                _reference->scheduler.getTimestamp() < _component->scheduler.getTimestamp()))
+        {
+            _reference->cpu.runInstruction();
+        }
+
+        ASSERT_EQ(_reference->cpu.getRetiredInstructions(), _component->cpu.getRetiredInstructions());
+        ASSERT_EQ(_reference->scheduler.getTimestamp(), _component->scheduler.getTimestamp())
+            << std::format("Run from PC {:#06x} diverged in time", pc);
+        ASSERT_TRUE(_component->cpu.getView() == _reference->cpu.getView())
+            << std::format("Run from PC {:#06x} diverged from the reference at PC {:#06x}", pc,
+                           _reference->cpu.getView().registers.PC);
+
+        if (const auto result{getMooneyeResult(*_component)}; result != MooneyeResult::RUNNING)
+        {
+            ASSERT_TRUE(result == MooneyeResult::PASSED)
+                << std::format("{} at PC {:#06x}", result == MooneyeResult::FAILED ? "Failed" : "Timed out",
+                               _component->cpu.getView().registers.PC);
+            break;
+        }
+    }
+}
+
+TEST_F(IdleLoopLockstep, WaitForLY)
+{
+    constexpr std::array<uint8_t, 24> program{
+        0x3E, 0x91,              // LD A, 0x91
+        0xE0, 0x40,              // LDH (LCDC), A
+        0xF0, 0x44,              // LDH A, (LY)
+        0xFE, 0x90,              // CP 144
+        0x20, 0xFA,              // JR NZ, -6
+        0x06, 0x03, 0x0E, 0x05,  // LD B, 3 ; LD C, 5
+        0x16, 0x08, 0x1E, 0x0D,  // LD D, 8 ; LD E, 13
+        0x26, 0x15, 0x2E, 0x22,  // LD H, 21 ; LD L, 34
+        0x18, 0xFE,              // JR -2
+    };
+
+    ASSERT_NO_THROW(executeProgram(program));
+    EXPECT_GT(_component->cpu.getSkippedMachineCycles(), 0);
+}
+
+TEST_F(IdleLoopLockstep, WaitForInterruptFlag)
+{
+    constexpr std::array<uint8_t, 27> program{
+        0x3E, 0x05,              // LD A, 0x05
+        0xE0, 0x07,              // LDH (TAC), A
+        0xAF,                    // XOR A
+        0xE0, 0x0F,              // LDH (IF), A
+        0xF0, 0x0F,              // LDH A, (IF)
+        0xE6, 0x04,              // AND 0x04
+        0x28, 0xFA,              // JR Z, -6
+        0x06, 0x03, 0x0E, 0x05,  // LD B, 3 ; LD C, 5
+        0x16, 0x08, 0x1E, 0x0D,  // LD D, 8 ; LD E, 13
+        0x26, 0x15, 0x2E, 0x22,  // LD H, 21 ; LD L, 34
+        0x18, 0xFE,              // JR -2
+    };
+
+    ASSERT_NO_THROW(executeProgram(program));
+    EXPECT_GT(_component->cpu.getSkippedMachineCycles(), 0);
+}
+
+TEST_F(IdleLoopLockstep, TimerTim00)
+{
+    ASSERT_NO_THROW(executeROM("timer/tim00.gb"));
+}
+
+TEST_F(IdleLoopLockstep, HaltIme1Timing)
+{
+    ASSERT_NO_THROW(executeROM("halt_ime1_timing.gb"));
+}
@@ -0,0 +1,104 @@
+#include "tests/roms/MemorySnapshot.hxx"
+
+#include <format>
+
+#include "Utils.hxx"
+
+using enum AddressSpaceSnapshot::Mode;
+
+void MemorySnapshot::executeROM(const std::string& romName)
+{
+    AddressSpaceSnapshot snapshot{};
+
+    loadROM(ROMS_PATH + std::string{"/mooneye/acceptance/"} + romName);
+
+    _component->cpu.setPostBootRomRegisters();
+    _component->bus.setPostBootRomRegisters();
+    _component->ppu->setPostBootRomRegisters();
+
+    _component->bus.takeSnapshot(snapshot, FULL);
+
+    ASSERT_TRUE(snapshot.dirtyPages.all());
+
+    while (_component->bus.read(MemoryMap::IORegisters::SB) != 34)
+    {
+        ASSERT_EQ(_component->cpu.runUntil(10'000'000, SM83::StopReason::SERIAL), SM83::StopReason::SERIAL);
+        _component->bus.write(MemoryMap::IORegisters::SC, 0x00);
+    }
+
+    const auto openBusAccesses{_component->bus.getOpenBusAccesses()};
+
+    _component->bus.takeSnapshot(snapshot, INCREMENTAL);
+
+    ASSERT_EQ(_component->bus.getOpenBusAccesses(), openBusAccesses);
+
+    for (std::size_t address{0}; address <= 0xFFFF; ++address)
+    {
+        /* Snapshots do not synchronize the timer nor the PPU: their registers are as of their last synchronization. */
+        if (Utils::addressIn(static_cast<uint16_t>(address), MemoryMap::IO_REGISTERS))
+        {
+            continue;
+        }
+
+        ASSERT_EQ(snapshot.memory[address], _component->bus.read(address))
+            << std::format("Snapshot differs at {:#06x}", address);
+    }
+}
+
+void MemorySnapshot::executeProgram(const std::span<const uint8_t> program) const
+{
+    for (uint16_t offset{0}; offset < program.size(); ++offset)
+    {
+        _component->fakeRam.write(0x100 + offset, program[offset]);
+    }
+
+    _component->cpu.setPostBootRomRegisters();
+    _component->bus.setPostBootRomRegisters();
+    _component->ppu->setPostBootRomRegisters();
+}
+
+TEST_F(MemorySnapshot, IncrementalCopiesWrittenPages)
+{
+    constexpr std::array<uint8_t, 9> program{
+        0x3E, 0x42,        // LD A, 0x42
+        0xEA, 0x23, 0xC1,  // LD (0xC123), A
+        0xE0, 0x90,        // LDH (0x90), A
+        0x18, 0xFE,        // JR -2
+    };
+    AddressSpaceSnapshot snapshot{};
+
+    executeProgram(program);
+
+    _component->bus.takeSnapshot(snapshot, FULL);
+    ASSERT_EQ(_component->cpu.runUntil(20, SM83::StopReason::BREAKPOINT), SM83::StopReason::BUDGET);
+    _component->bus.takeSnapshot(snapshot, INCREMENTAL);
+
+    /* Echo RAM aliases the written work RAM page. */
+    EXPECT_TRUE(snapshot.dirtyPages.test(0xC1));
+    EXPECT_TRUE(snapshot.dirtyPages.test(0xE1));
+    EXPECT_TRUE(snapshot.dirtyPages.test(0xFF));
+    EXPECT_EQ(snapshot.memory[0xC123], 0x42);
+    EXPECT_EQ(snapshot.memory[0xE123], 0x42);
+    EXPECT_EQ(snapshot.memory[0xFF90], 0x42);
+
+    for (const std::size_t page : {0x00, 0x01, 0x7F, 0x80, 0xC0, 0xD0, 0xE0})
+    {
+        EXPECT_FALSE(snapshot.dirtyPages.test(page)) << std::format("Page {:#04x} is dirty", page);
+    }
+
+    _component->bus.takeSnapshot(snapshot, INCREMENTAL);
+
+    EXPECT_FALSE(snapshot.dirtyPages.test(0xC1));
+    EXPECT_FALSE(snapshot.dirtyPages.test(0xE1));
+    EXPECT_EQ(snapshot.memory[0xC123], 0x42);
+}
+
+TEST_F(MemorySnapshot, IfIeRegisters)
+{
+    ASSERT_NO_THROW(executeROM("if_ie_registers.gb"));
+}
+
+TEST_F(MemorySnapshot, TimerTim01)
+{
+    ASSERT_NO_THROW(executeROM("timer/tim01.gb"));
+}
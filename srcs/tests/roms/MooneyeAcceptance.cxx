@@ -12,7 +12,7 @@ void MooneyeAcceptance::executeROM(const std::string& romName)
 
     _component->cpu.setPostBootRomRegisters();
     _component->bus.setPostBootRomRegisters();
-    _component->ppu.setPostBootRomRegisters();
+    _component->ppu->setPostBootRomRegisters();
 
     while (true)
     {
@@ -24,13 +24,15 @@ void MooneyeAcceptance::executeROM(const std::string& romName)
             _component->bus.write(0xFF02, 0x00);
         }
 
-        if (_component->cpu.B == 3 && _component->cpu.C == 5 && _component->cpu.D == 8 && _component->cpu.E == 13 &&
-            _component->cpu.H == 21 && _component->cpu.L == 34)
+        const auto& registers{_component->cpu._registers};
+
+        if (registers.B == 3 && registers.C == 5 && registers.D == 8 && registers.E == 13 && registers.H == 21 &&
+            registers.L == 34)
         {
             break;
         }
-        if (_component->cpu.B == 0x42 && _component->cpu.C == 0x42 && _component->cpu.D == 0x42 &&
-            _component->cpu.E == 0x42 && _component->cpu.H == 0x42 && _component->cpu.L == 0x42)
+        if (registers.B == 0x42 && registers.C == 0x42 && registers.D == 0x42 && registers.E == 0x42 &&
+            registers.H == 0x42 && registers.L == 0x42)
         {
             throw std::runtime_error("Failed ! " + s);
         }
@@ -0,0 +1,107 @@
+#include "tests/roms/MooneyeMbc.hxx"
+
+#include <format>
+
+MooneyeMbc::DynamicComponent::DynamicComponent()
+    : _state(),
+      bus(_state),
+      cpu(_state, bus, scheduler),
+      cartridge(_state, scheduler),
+      echoRam(workRam),
+      timer(bus, scheduler),
+      ppu(PPU::create(PPU::Accuracy::CYCLE, bus, _renderer, scheduler))
+{
+    bus.attach(timer);
+    bus.attach(*ppu);
+    bus.attach(cpu);
+    bus.attach(echoRam);
+    bus.attach(workRam);
+    bus.attach(cartridge);
+    bus.attach(fakeRam);
+
+    cartridge.setRemapHandler([this](const MemoryMap::AddressRange range) { bus.remap(range); });
+}
+
+void MooneyeMbc::DynamicComponent::setPostBootRomRegisters()
+{
+    cpu.setPostBootRomRegisters();
+    bus.setPostBootRomRegisters();
+    ppu->setPostBootRomRegisters();
+}
+
+MooneyeMbc::StaticComponent::StaticComponent()
+    : _state(),
+      bus(_state, cartridge, ppu, timer, cpu, fakeRam, workRam, fakeRam),
+      cpu(_state, bus, scheduler),
+      cartridge(_state, scheduler),
+      timer(bus, scheduler),
+      ppu(bus, _renderer, scheduler)
+{
+}
+
+void MooneyeMbc::StaticComponent::setPostBootRomRegisters()
+{
+    cpu.setPostBootRomRegisters();
+    bus.setPostBootRomRegisters();
+    ppu.setPostBootRomRegisters();
+}
+
+template <typename Component>
+void MooneyeMbc::executeROM(Component& component, const std::string& romName)
+{
+    /* Far more than any of them needs: a failing controller may leave the ROM looping forever. */
+    constexpr std::size_t MAX_INSTRUCTIONS{20'000'000};
+
+    component.cartridge.load(ROMS_PATH + std::string{"/mooneye/emulator-only/"} + romName);
+    component.setPostBootRomRegisters();
+
+    while (component.cpu.getRetiredInstructions() < MAX_INSTRUCTIONS)
+    {
+        component.cpu.runInstruction();
+
+        const auto& registers{component.cpu.getView().registers};
+
+        if (registers.B == 3 && registers.C == 5 && registers.D == 8 && registers.E == 13 && registers.H == 21 &&
+            registers.L == 34)
+        {
+            return;
+        }
+        if (registers.B == 0x42 && registers.C == 0x42 && registers.D == 0x42 && registers.E == 0x42 &&
+            registers.H == 0x42 && registers.L == 0x42)
+        {
+            throw std::runtime_error(std::format("{} failed at PC {:#06x}", romName, registers.PC));
+        }
+    }
+
+    throw std::runtime_error(std::format("{} did not complete", romName));
+}
+
+TEST_P(MooneyeMbc, DynamicBus)
+{
+    const auto component{std::make_unique<DynamicComponent>()};
+
+    ASSERT_NO_THROW(executeROM(*component, GetParam()));
+}
+
+TEST_P(MooneyeMbc, StaticBus)
+{
+    const auto component{std::make_unique<StaticComponent>()};
+
+    ASSERT_NO_THROW(executeROM(*component, GetParam()));
+}
+
+INSTANTIATE_TEST_SUITE_P(Mbc1, MooneyeMbc,
+                         ::testing::Values("mbc1/bits_bank1.gb", "mbc1/bits_bank2.gb", "mbc1/bits_mode.gb",
+                                           "mbc1/bits_ramg.gb", "mbc1/multicart_rom_8Mb.gb", "mbc1/ram_64kb.gb",
+                                           "mbc1/ram_256kb.gb", "mbc1/rom_512kb.gb", "mbc1/rom_1Mb.gb",
+                                           "mbc1/rom_2Mb.gb", "mbc1/rom_4Mb.gb", "mbc1/rom_8Mb.gb",
+                                           "mbc1/rom_16Mb.gb"));
+
+INSTANTIATE_TEST_SUITE_P(Mbc2, MooneyeMbc,
+                         ::testing::Values("mbc2/bits_ramg.gb", "mbc2/bits_romb.gb", "mbc2/bits_unused.gb",
+                                           "mbc2/ram.gb", "mbc2/rom_512kb.gb", "mbc2/rom_1Mb.gb", "mbc2/rom_2Mb.gb"));
+
+/* The 32 Mbit and 64 Mbit ROMs are not part of the ROM set. */
+INSTANTIATE_TEST_SUITE_P(Mbc5, MooneyeMbc,
+                         ::testing::Values("mbc5/rom_512kb.gb", "mbc5/rom_1Mb.gb", "mbc5/rom_2Mb.gb", "mbc5/rom_4Mb.gb",
+                                           "mbc5/rom_8Mb.gb", "mbc5/rom_16Mb.gb"));
@@ -0,0 +1,130 @@
+#include "tests/roms/RecompilerLockstep.hxx"
+
+#include <format>
+
+#include "hardware/core/Recompiler.hxx"
+
+void RecompilerLockstep::SetUp()
+{
+    if (!Recompiler::isSupported())
+    {
+        GTEST_SKIP() << "The recompiler is not supported on this platform";
+    }
+
+    TestRom::SetUp();
+    _reference = std::make_unique<Component>();
+    _component->cpu.setBackend(SM83::Backend::RECOMPILER);
+}
+
+void RecompilerLockstep::TearDown()
+{
+    _reference.reset();
+    TestRom::TearDown();
+}
+
+void RecompilerLockstep::executeROM(const std::string& romName)
+{
+    std::string s{};
+
+    loadROM(ROMS_PATH + std::string{"/blargg/cpu_instrs/"} + romName);
+
+    for (uint16_t address{MemoryMap::ROM.first}; address <= MemoryMap::ROM.second; ++address)
+    {
+        _reference->fakeRam.write(address, _component->fakeRam.read(address));
+    }
+
+    for (const auto& component : {_component.get(), _reference.get()})
+    {
+        component->cpu.setPostBootRomRegisters();
+        component->bus.setPostBootRomRegisters();
+    }
+
+    while (true)
+    {
+        const auto pc{_component->cpu.getView().registers.PC};
+
+        _component->cpu.runInstruction();
+
+        /* Both CPUs are halted when no instruction retires. */
+        do
+        {
+            _reference->cpu.runInstruction();
+        } while (_reference->cpu.getRetiredInstructions() < _component->cpu.getRetiredInstructions());
+
+        ASSERT_EQ(_reference->cpu.getRetiredInstructions(), _component->cpu.getRetiredInstructions());
+        ASSERT_TRUE(_component->cpu.getView() == _reference->cpu.getView())
+            << std::format("Recompiled run from PC {:#06x} diverged from the interpreter at PC {:#06x}", pc,
+                           _reference->cpu.getView().registers.PC);
+
+        if (_component->bus.read(0xFF02) == 0x81)
+        {
+            s += static_cast<char>(_component->bus.read(0xFF01));
+            _component->bus.write(0xFF02, 0x00);
+            _reference->bus.write(0xFF02, 0x00);
+        }
+
+        if (s.ends_with("Passed"))
+        {
+            break;
+        }
+        if (s.ends_with("Failed"))
+        {
+            throw std::runtime_error(s);
+        }
+    }
+}
+
+TEST_F(RecompilerLockstep, Special01)
+{
+    ASSERT_NO_THROW(executeROM("01-special.gb"));
+}
+
+TEST_F(RecompilerLockstep, Interrupts02)
+{
+    ASSERT_NO_THROW(executeROM("02-interrupts.gb"));
+}
+
+TEST_F(RecompilerLockstep, OperationRegisterSP_RegisterHL_03)
+{
+    ASSERT_NO_THROW(executeROM("03-op sp,hl.gb"));
+}
+
+TEST_F(RecompilerLockstep, OperationRegisterImmediate04)
+{
+    ASSERT_NO_THROW(executeROM("04-op r,imm.gb"));
+}
+
+TEST_F(RecompilerLockstep, OperationRegister16_05)
+{
+    ASSERT_NO_THROW(executeROM("05-op rp.gb"));
+}
+
+TEST_F(RecompilerLockstep, LoadRegisterRegister06)
+{
+    ASSERT_NO_THROW(executeROM("06-ld r,r.gb"));
+}
+
+TEST_F(RecompilerLockstep, JumpCallReturnReset07)
+{
+    ASSERT_NO_THROW(executeROM("07-jr,jp,call,ret,rst.gb"));
+}
+
+TEST_F(RecompilerLockstep, Misc08)
+{
+    ASSERT_NO_THROW(executeROM("08-misc instrs.gb"));
+}
+
+TEST_F(RecompilerLockstep, OperationRegisterRegister09)
+{
+    ASSERT_NO_THROW(executeROM("09-op r,r.gb"));
+}
+
+TEST_F(RecompilerLockstep, BitOperations10)
+{
+    ASSERT_NO_THROW(executeROM("10-bit ops.gb"));
+}
+
+TEST_F(RecompilerLockstep, OperationRegisterA_MemHL_11)
+{
+    ASSERT_NO_THROW(executeROM("11-op a,(hl).gb"));
+}
@@ -0,0 +1,334 @@
+#include "tests/roms/RunUntil.hxx"
+
+#include <limits>
+
+#include "hardware/core/Recompiler.hxx"
+
+using enum SM83::StopReason;
+
+void RunUntil::executeROM(const std::string& romName)
+{
+    constexpr std::array<uint8_t, 6> fibonacci{3, 5, 8, 13, 21, 34};
+    std::vector<uint8_t>             bytes{};
+
+    loadROM(ROMS_PATH + std::string{"/mooneye/acceptance/"} + romName);
+
+    _component->cpu.setPostBootRomRegisters();
+    _component->bus.setPostBootRomRegisters();
+    _component->ppu->setPostBootRomRegisters();
+
+    while (bytes.size() < fibonacci.size())
+    {
+        /* About ten seconds of emulated time between two bytes is plenty. */
+        ASSERT_EQ(_component->cpu.runUntil(10'000'000, SERIAL), SERIAL);
+
+        bytes.push_back(_component->bus.read(MemoryMap::IORegisters::SB));
+        _component->bus.write(MemoryMap::IORegisters::SC, 0x00);
+    }
+
+    ASSERT_TRUE(std::ranges::equal(bytes, fibonacci));
+}
+
+void RunUntil::executeProgram(const std::span<const uint8_t> program) const
+{
+    for (uint16_t offset{0}; offset < program.size(); ++offset)
+    {
+        _component->fakeRam.write(0x100 + offset, program[offset]);
+    }
+
+    _component->cpu.setPostBootRomRegisters();
+    _component->bus.setPostBootRomRegisters();
+    _component->ppu->setPostBootRomRegisters();
+}
+
+TEST_F(RunUntil, Budget)
+{
+    constexpr std::array<uint8_t, 3> program{
+        0x04,        // INC B
+        0x18, 0xFD,  // JR -3
+    };
+
+    executeProgram(program);
+
+    const auto start{_component->scheduler.getTimestamp()};
+
+    ASSERT_EQ(_component->cpu.runUntil(100, BREAKPOINT | SERIAL | WATCHPOINT), BUDGET);
+
+    /* The budget is checked in between instructions: the last one may overshoot it. */
+    EXPECT_GE(_component->scheduler.getTimestamp() - start, 100);
+    EXPECT_LT(_component->scheduler.getTimestamp() - start, 103);
+}
+
+TEST_F(RunUntil, BudgetWithIdleLoopSkipping)
+{
+    /* The timer overflows long after the budget is spent. */
+    constexpr std::array<uint8_t, 6> program{
+        0x3E, 0x04,  // LD A, 0x04
+        0xE0, 0x07,  // LDH (TAC), A
+        0x18, 0xFE,  // JR -2
+    };
+
+    executeProgram(program);
+    _component->cpu.setIdleLoopSkipping(true);
+
+    const auto start{_component->scheduler.getTimestamp()};
+
+    ASSERT_EQ(_component->cpu.runUntil(100, BREAKPOINT | SERIAL | WATCHPOINT), BUDGET);
+
+    /* The loop is skipped a whole number of iterations at a time, up to the budget rather than to the next event. */
+    EXPECT_GT(_component->cpu.getSkippedMachineCycles(), 0);
+    EXPECT_GE(_component->scheduler.getTimestamp() - start, 100);
+    EXPECT_LT(_component->scheduler.getTimestamp() - start, 103);
+}
+
+TEST_F(RunUntil, BudgetWhileHalted)
+{
+    /* Nothing is enabled in IE: the CPU stays halted, and the timer overflows long after the budget is spent. */
+    constexpr std::array<uint8_t, 5> program{
+        0x3E, 0x04,  // LD A, 0x04
+        0xE0, 0x07,  // LDH (TAC), A
+        0x76,        // HALT
+    };
+
+    executeProgram(program);
+
+    const auto start{_component->scheduler.getTimestamp()};
+
+    ASSERT_EQ(_component->cpu.runUntil(100, BREAKPOINT | SERIAL | WATCHPOINT), BUDGET);
+
+    EXPECT_GE(_component->scheduler.getTimestamp() - start, 100);
+    EXPECT_LT(_component->scheduler.getTimestamp() - start, 103);
+}
+
+TEST_F(RunUntil, InvalidatesModifiedCode)
+{
+    constexpr std::array<uint8_t, 16> program{
+        0x01, 0x00, 0x00,  // LD BC, 0x0000
+        0xCD, 0xFE, 0xC0,  // CALL 0xC0FE
+        0x3E, 0x0C,        // LD A, 0x0C
+        0xEA, 0x00, 0xC1,  // LD (0xC100), A
+        0xCD, 0xFE, 0xC0,  // CALL 0xC0FE
+        0x18, 0xFE,        // JR -2
+    };
+    /* The patched byte is in the page after the one the block starts in. */
+    constexpr std::array<uint8_t, 4> routine{
+        0x04,  // INC B
+        0x04,  // INC B
+        0x04,  // INC B, then INC C
+        0xC9,  // RET
+    };
+
+    executeProgram(program);
+    for (uint16_t offset{0}; offset < routine.size(); ++offset)
+    {
+        _component->bus.write(0xC0FE + offset, routine[offset]);
+    }
+
+    /* The interpreter runs out of the block cache too: the recompiler adds its own blocks to invalidate. */
+    if (Recompiler::isSupported())
+    {
+        _component->cpu.setBackend(SM83::Backend::RECOMPILER);
+    }
+
+    ASSERT_EQ(_component->cpu.runUntil(256, BREAKPOINT), BUDGET);
+    EXPECT_EQ(_component->cpu.getView().registers.B, 0x05);
+    EXPECT_EQ(_component->cpu.getView().registers.C, 0x01);
+}
+
+TEST_F(RunUntil, Breakpoint)
+{
+    constexpr std::array<uint8_t, 8> program{
+        0x06, 0x01,  // LD B, 1
+        0x0E, 0x02,  // LD C, 2
+        0x16, 0x03,  // LD D, 3
+        0x18, 0xFE,  // JR -2
+    };
+
+    executeProgram(program);
+    _component->cpu.addBreakpoint(0x104);
+
+    ASSERT_EQ(_component->cpu.runUntil(std::numeric_limits<std::size_t>::max(), BREAKPOINT), BREAKPOINT);
+    EXPECT_EQ(_component->cpu.getView().registers.PC, 0x104);
+    EXPECT_EQ(_component->cpu.getView().registers.C, 0x02);
+    EXPECT_NE(_component->cpu.getView().registers.D, 0x03);
+
+    /* Resuming from a breakpoint executes the instruction under it. */
+    ASSERT_EQ(_component->cpu.runUntil(64, BREAKPOINT), BUDGET);
+    EXPECT_EQ(_component->cpu.getView().registers.PC, 0x106);
+    EXPECT_EQ(_component->cpu.getView().registers.D, 0x03);
+}
+
+TEST_F(RunUntil, BreakpointNotInMask)
+{
+    constexpr std::array<uint8_t, 6> program{
+        0x06, 0x01,  // LD B, 1
+        0x0E, 0x02,  // LD C, 2
+        0x18, 0xFE,  // JR -2
+    };
+
+    executeProgram(program);
+    _component->cpu.addBreakpoint(0x102);
+
+    ASSERT_EQ(_component->cpu.runUntil(64, SERIAL), BUDGET);
+    EXPECT_EQ(_component->cpu.getView().registers.C, 0x02);
+}
+
+TEST_F(RunUntil, BreakpointInRecompiledBlock)
+{
+    if (!Recompiler::isSupported())
+    {
+        GTEST_SKIP() << "No recompiler for this host";
+    }
+
+    constexpr std::array<uint8_t, 9> program{
+        0xAF,        // XOR A
+        0x47,        // LD B, A
+        0x4F,        // LD C, A
+        0x57,        // LD D, A
+        0x04,        // INC B
+        0x0C,        // INC C
+        0x14,        // INC D
+        0x18, 0xFB,  // JR -5
+    };
+
+    executeProgram(program);
+    _component->cpu.setBackend(SM83::Backend::RECOMPILER);
+
+    /* Let the loop be translated before breaking in the middle of it. */
+    ASSERT_EQ(_component->cpu.runUntil(4096, BREAKPOINT), BUDGET);
+
+    _component->cpu.addBreakpoint(0x106);
+
+    ASSERT_EQ(_component->cpu.runUntil(std::numeric_limits<std::size_t>::max(), BREAKPOINT), BREAKPOINT);
+
+    const auto& registers{_component->cpu.getView().registers};
+
+    EXPECT_EQ(registers.PC, 0x106);
+    EXPECT_EQ(registers.C, registers.B);
+    EXPECT_EQ(registers.D, static_cast<uint8_t>(registers.C - 1));
+}
+
+TEST_F(RunUntil, Serial)
+{
+    constexpr std::array<uint8_t, 10> program{
+        0x3E, 0x41,  // LD A, 'A'
+        0xE0, 0x01,  // LDH (SB), A
+        0x3E, 0x81,  // LD A, 0x81
+        0xE0, 0x02,  // LDH (SC), A
+        0x18, 0xFE,  // JR -2
+    };
+
+    executeProgram(program);
+
+    ASSERT_EQ(_component->cpu.runUntil(std::numeric_limits<std::size_t>::max(), SERIAL), SERIAL);
+    EXPECT_EQ(_component->cpu.getView().registers.PC, 0x108);
+    EXPECT_EQ(_component->bus.read(MemoryMap::IORegisters::SB), 'A');
+}
+
+TEST_F(RunUntil, Watchpoint)
+{
+    constexpr std::array<uint8_t, 8> program{
+        0x21, 0x00, 0xC0,  // LD HL, 0xC000
+        0x36, 0x42,        // LD (HL), 0x42
+        0x7E,              // LD A, (HL)
+        0x18, 0xFE,        // JR -2
+    };
+    constexpr SM83::Watchpoint watchpoint{{0xC000, 0xC000}, SM83::Access::READ | SM83::Access::WRITE};
+
+    executeProgram(program);
+    _component->cpu.addWatchpoint(watchpoint);
+
+    ASSERT_EQ(_component->cpu.runUntil(std::numeric_limits<std::size_t>::max(), WATCHPOINT), WATCHPOINT);
+    EXPECT_EQ(_component->cpu.getView().registers.PC, 0x105);
+
+    ASSERT_TRUE(_component->cpu.getWatchpointHit().has_value());
+    EXPECT_EQ(_component->cpu.getWatchpointHit()->pc, 0x103);
+    EXPECT_EQ(_component->cpu.getWatchpointHit()->address, 0xC000);
+    EXPECT_EQ(_component->cpu.getWatchpointHit()->oldValue, 0x00);
+    EXPECT_EQ(_component->cpu.getWatchpointHit()->newValue, 0x42);
+    EXPECT_EQ(_component->cpu.getWatchpointHit()->access, SM83::Access::WRITE);
+
+    ASSERT_EQ(_component->cpu.runUntil(std::numeric_limits<std::size_t>::max(), WATCHPOINT), WATCHPOINT);
+    EXPECT_EQ(_component->cpu.getView().registers.PC, 0x106);
+    EXPECT_EQ(_component->cpu.getView().registers.A, 0x42);
+
+    ASSERT_TRUE(_component->cpu.getWatchpointHit().has_value());
+    EXPECT_EQ(_component->cpu.getWatchpointHit()->pc, 0x105);
+    EXPECT_EQ(_component->cpu.getWatchpointHit()->access, SM83::Access::READ);
+    EXPECT_EQ(_component->cpu.getWatchpointHit()->timestamp, _component->scheduler.getTimestamp());
+
+    _component->cpu.removeWatchpoint(watchpoint);
+
+    ASSERT_EQ(_component->cpu.runUntil(64, WATCHPOINT), BUDGET);
+    EXPECT_FALSE(_component->cpu.getWatchpointHit().has_value());
+}
+
+TEST_F(RunUntil, WriteWatchpointOverRange)
+{
+    constexpr std::array<uint8_t, 12> program{
+        0x21, 0x10, 0xC1,  // LD HL, 0xC110
+        0x7E,              // LD A, (HL)
+        0x21, 0xFF, 0xC0,  // LD HL, 0xC0FF
+        0x7E,              // LD A, (HL)
+        0x36, 0x07,        // LD (HL), 0x07
+        0x18, 0xFE,        // JR -2
+    };
+
+    executeProgram(program);
+    _component->cpu.addWatchpoint({{0xC080, 0xC10F}, SM83::Access::WRITE});
+
+    ASSERT_EQ(_component->cpu.runUntil(std::numeric_limits<std::size_t>::max(), WATCHPOINT), WATCHPOINT);
+    EXPECT_EQ(_component->cpu.getView().registers.PC, 0x10A);
+
+    ASSERT_TRUE(_component->cpu.getWatchpointHit().has_value());
+    EXPECT_EQ(_component->cpu.getWatchpointHit()->pc, 0x108);
+    EXPECT_EQ(_component->cpu.getWatchpointHit()->address, 0xC0FF);
+    EXPECT_EQ(_component->cpu.getWatchpointHit()->newValue, 0x07);
+    EXPECT_EQ(_component->cpu.getWatchpointHit()->access, SM83::Access::WRITE);
+}
+
+TEST_F(RunUntil, ExecuteWatchpoint)
+{
+    constexpr std::array<uint8_t, 8> program{
+        0x06, 0x01,  // LD B, 1
+        0x0E, 0x02,  // LD C, 2
+        0x16, 0x03,  // LD D, 3
+        0x18, 0xFE,  // JR -2
+    };
+
+    executeProgram(program);
+    _component->cpu.addWatchpoint({{0x104, 0x105}, SM83::Access::EXECUTE});
+
+    ASSERT_EQ(_component->cpu.runUntil(std::numeric_limits<std::size_t>::max(), WATCHPOINT), WATCHPOINT);
+    EXPECT_EQ(_component->cpu.getView().registers.PC, 0x104);
+    EXPECT_NE(_component->cpu.getView().registers.D, 0x03);
+
+    ASSERT_TRUE(_component->cpu.getWatchpointHit().has_value());
+    EXPECT_EQ(_component->cpu.getWatchpointHit()->pc, 0x104);
+    EXPECT_EQ(_component->cpu.getWatchpointHit()->oldValue, 0x16);
+    EXPECT_EQ(_component->cpu.getWatchpointHit()->access, SM83::Access::EXECUTE);
+}
+
+TEST_F(RunUntil, RequestStopOutsideOfMask)
+{
+    constexpr std::array<uint8_t, 2> program{
+        0x18, 0xFE,  // JR -2
+    };
+
+    executeProgram(program);
+
+    /* Nothing is running: the request is dropped rather than stopping the next run. */
+    _component->cpu.requestStop(FRAME);
+
+    ASSERT_EQ(_component->cpu.runUntil(64, FRAME), BUDGET);
+}
+
+TEST_F(RunUntil, MooneyeEiTiming)
+{
+    ASSERT_NO_FATAL_FAILURE(executeROM("ei_timing.gb"));
+}
+
+TEST_F(RunUntil, MooneyeDivTiming)
+{
+    ASSERT_NO_FATAL_FAILURE(executeROM("div_timing.gb"));
+}
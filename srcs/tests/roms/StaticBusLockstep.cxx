@@ -0,0 +1,103 @@
+#include "tests/roms/StaticBusLockstep.hxx"
+
+#include <format>
+
+StaticBusLockstep::StaticComponent::StaticComponent()
+    : _state(),
+      bus(_state, fakeRam, ppu, timer, cpu, fakeRam, workRam, fakeRam),
+      cpu(_state, bus, scheduler),
+      timer(bus, scheduler),
+      ppu(bus, _renderer, scheduler)
+{
+}
+
+void StaticBusLockstep::SetUp()
+{
+    TestRom::SetUp();
+    _static = std::make_unique<StaticComponent>();
+}
+
+void StaticBusLockstep::TearDown()
+{
+    _static.reset();
+    TestRom::TearDown();
+}
+
+void StaticBusLockstep::executeROM(const std::string& romName)
+{
+    loadROM(ROMS_PATH + std::string{"/mooneye/acceptance/"} + romName);
+
+    for (uint16_t address{MemoryMap::ROM.first}; address <= MemoryMap::ROM.second; ++address)
+    {
+        _static->fakeRam.write(address, _component->fakeRam.read(address));
+    }
+
+    _component->cpu.setPostBootRomRegisters();
+    _component->bus.setPostBootRomRegisters();
+    _component->ppu->setPostBootRomRegisters();
+    _static->cpu.setPostBootRomRegisters();
+    _static->bus.setPostBootRomRegisters();
+    _static->ppu.setPostBootRomRegisters();
+
+    while (true)
+    {
+        for (IAddressable* const bus : std::initializer_list<IAddressable*>{&_component->bus, &_static->bus})
+        {
+            /* There is no serial port: transfers complete at once. */
+            if (bus->read(MemoryMap::IORegisters::SC) == 0x81)
+            {
+                bus->write(MemoryMap::IORegisters::SC, 0x00);
+            }
+        }
+
+        _component->cpu.runInstruction();
+        _static->cpu.runInstruction();
+
+        ASSERT_EQ(_component->cpu.getRetiredInstructions(), _static->cpu.getRetiredInstructions());
+        ASSERT_EQ(_component->scheduler.getTimestamp(), _static->scheduler.getTimestamp());
+        ASSERT_TRUE(_static->cpu.getView() == _component->cpu.getView())
+            << std::format("Diverged from the reference at PC {:#06x}", _component->cpu.getView().registers.PC);
+
+        if (const auto result{getMooneyeResult(*_component)}; result != MooneyeResult::RUNNING)
+        {
+            ASSERT_TRUE(result == MooneyeResult::PASSED)
+                << std::format("{} at PC {:#06x}", result == MooneyeResult::FAILED ? "Failed" : "Timed out",
+                               _component->cpu.getView().registers.PC);
+            break;
+        }
+    }
+
+    for (std::size_t address{0}; address <= 0xFFFF; ++address)
+    {
+        ASSERT_EQ(_component->bus.read(address), _static->bus.read(address))
+            << std::format("Memory differs at {:#06x}", address);
+    }
+
+    AddressSpaceSnapshot reference{};
+    AddressSpaceSnapshot snapshot{};
+
+    _component->bus.takeSnapshot(reference, AddressSpaceSnapshot::Mode::FULL);
+    _static->bus.takeSnapshot(snapshot, AddressSpaceSnapshot::Mode::FULL);
+
+    ASSERT_TRUE(snapshot.memory == reference.memory);
+}
+
+TEST_F(StaticBusLockstep, OamDmaBasic)
+{
+    ASSERT_NO_THROW(executeROM("oam_dma/basic.gb"));
+}
+
+TEST_F(StaticBusLockstep, OamDmaRegisterRead)
+{
+    ASSERT_NO_THROW(executeROM("oam_dma/reg_read.gb"));
+}
+
+TEST_F(StaticBusLockstep, IfIeRegisters)
+{
+    ASSERT_NO_THROW(executeROM("if_ie_registers.gb"));
+}
+
+TEST_F(StaticBusLockstep, TimerTim01)
+{
+    ASSERT_NO_THROW(executeROM("timer/tim01.gb"));
+}
@@ -2,11 +2,16 @@
 
 #include <fstream>
 
-TestRom::Component::Component()
-    : _state(), bus(_state), cpu(_state, bus, timer, ppu), echoRam(workRam), timer(bus), ppu(bus)
+TestRom::Component::Component(const PPU::Accuracy accuracy)
+    : _state(),
+      bus(_state),
+      cpu(_state, bus, scheduler),
+      echoRam(workRam),
+      timer(bus, scheduler),
+      ppu(PPU::create(accuracy, bus, _renderer, scheduler))
 {
     bus.attach(timer);
-    bus.attach(ppu);
+    bus.attach(*ppu);
     bus.attach(cpu);
     bus.attach(echoRam);
     bus.attach(workRam);
@@ -23,6 +28,24 @@ void TestRom::TearDown()
     _component.reset();
 }
 
+TestRom::MooneyeResult TestRom::getMooneyeResult(const Component& component)
+{
+    const auto& registers{component.cpu.getView().registers};
+
+    if (registers.B == 3 && registers.C == 5 && registers.D == 8 && registers.E == 13 && registers.H == 21 &&
+        registers.L == 34)
+    {
+        return MooneyeResult::PASSED;
+    }
+    if (registers.B == 0x42 && registers.C == 0x42 && registers.D == 0x42 && registers.E == 0x42 &&
+        registers.H == 0x42 && registers.L == 0x42)
+    {
+        return MooneyeResult::FAILED;
+    }
+
+    return component.scheduler.getTimestamp() < MAX_MACHINE_CYCLES ? MooneyeResult::RUNNING : MooneyeResult::TIMED_OUT;
+}
+
 void TestRom::loadROM(const std::string& romPath) const
 {
     std::ifstream               input{romPath, std::ios::binary};
@@ -0,0 +1,127 @@
+#include "tests/roms/Tracing.hxx"
+
+#include <filesystem>
+#include <sstream>
+
+void Tracing::executeROM(const std::string& romName)
+{
+    (void) romName;
+}
+
+void Tracing::executeProgram(const std::span<const uint8_t> program) const
+{
+    for (uint16_t offset{0}; offset < program.size(); ++offset)
+    {
+        _component->fakeRam.write(0x100 + offset, program[offset]);
+    }
+
+    _component->cpu.setPostBootRomRegisters();
+    _component->bus.setPostBootRomRegisters();
+    _component->ppu->setPostBootRomRegisters();
+}
+
+TEST_F(Tracing, RecordsExecutionsReadsAndWrites)
+{
+    constexpr std::array<uint8_t, 8> program{
+        0x3E, 0x42,        // LD A, 0x42
+        0xEA, 0x00, 0xC0,  // LD (0xC000), A
+        0xFA, 0x00, 0xC0,  // LD A, (0xC000)
+    };
+    BusTrace::RingBuffer             trace{16};
+    std::array<BusTrace::Record, 16> records{};
+
+    executeProgram(program);
+    _component->cpu.setTrace(&trace);
+
+    for (std::size_t instruction{0}; instruction < 3; ++instruction)
+    {
+        _component->cpu.runInstruction();
+    }
+
+    ASSERT_EQ(trace.pop(records), 5);
+
+    using enum BusTrace::Kind;
+
+    const std::array<std::tuple<uint16_t, uint16_t, uint8_t, BusTrace::Kind>, 5> expected{{
+        {0x0100, 0x0100, 0x3E, EXECUTE},
+        {0x0102, 0x0102, 0xEA, EXECUTE},
+        {0x0102, 0xC000, 0x42, WRITE},
+        {0x0105, 0x0105, 0xFA, EXECUTE},
+        {0x0105, 0xC000, 0x42, READ},
+    }};
+
+    for (std::size_t index{0}; index < expected.size(); ++index)
+    {
+        const auto& record{records[index]};
+
+        EXPECT_EQ(std::make_tuple(record.pc, record.address, record.value, record.kind), expected[index])
+            << "Record " << index;
+    }
+
+    /* Fetching the operand of LD A, 0x42 takes a machine cycle in between. */
+    EXPECT_LT(records[0].timestamp, records[1].timestamp);
+
+    _component->cpu.setTrace(nullptr);
+    _component->cpu.runInstruction();
+
+    EXPECT_EQ(trace.pop(records), 0);
+}
+
+TEST_F(Tracing, DropsRecordsWhenFull)
+{
+    BusTrace::RingBuffer            trace{2};
+    std::array<BusTrace::Record, 4> records{};
+
+    EXPECT_TRUE(trace.push({}));
+    EXPECT_TRUE(trace.push({}));
+    EXPECT_FALSE(trace.push({}));
+    EXPECT_EQ(trace.getDropped(), 1);
+    EXPECT_EQ(trace.pop(records), 2);
+    EXPECT_TRUE(trace.push({}));
+}
+
+TEST_F(Tracing, DecodesTraceFiles)
+{
+    const auto           path{std::filesystem::temp_directory_path() / "gbemu_tracing_test.trace"};
+    BusTrace::RingBuffer trace{4};
+
+    {
+        const BusTrace::Writer writer{trace, path.string()};
+
+        trace.push({1234, 0x0150, 0xFF44, 0x90, BusTrace::Kind::READ});
+        trace.push({1236, 0x0152, 0xC000, 0x01, BusTrace::Kind::WRITE});
+    }
+
+    std::ifstream     input{path, std::ios::binary};
+    std::stringstream output{};
+
+    BusTrace::decode(input, output);
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(output.str(), "        1234 0150 R FF44 90\n"
+                            "        1236 0152 W C000 01\n");
+
+    std::stringstream garbage{"not a trace"};
+
+    EXPECT_THROW(BusTrace::decode(garbage, output), std::runtime_error);
+}
+
+TEST_F(Tracing, ReportsWriteFailures)
+{
+    /* Opens fine, but every write fails as if the disk was full. */
+    const std::filesystem::path path{"/dev/full"};
+
+    if (!std::filesystem::exists(path))
+    {
+        GTEST_SKIP() << "No /dev/full on this host";
+    }
+
+    BusTrace::RingBuffer trace{4};
+    BusTrace::Writer     writer{trace, path.string()};
+
+    trace.push({1234, 0x0150, 0xFF44, 0x90, BusTrace::Kind::READ});
+    writer.stop();
+
+    EXPECT_TRUE(writer.hasFailed());
+    EXPECT_EQ(trace.getDropped(), 0);
+}
@@ -0,0 +1,58 @@
+//
+// Converts a bus trace, as recorded through SM83::setTrace(), to text: one access per line, made of the timestamp in
+// machine cycles, the address of the instruction, the kind of access (R, W or X), the address and the value.
+//
+// Usage: gbemu_trace <trace> [output]
+//
+
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "hardware/core/BusTrace.hxx"
+
+int main(const int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <trace> [output]" << '\n';
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        std::ifstream input{argv[1], std::ios::binary};
+        std::ofstream file{};
+
+        if (!input)
+        {
+            throw std::runtime_error(std::string{"Cannot open "} + argv[1]);
+        }
+        if (argc > 2)
+        {
+            file.open(argv[2]);
+            if (!file)
+            {
+                throw std::runtime_error(std::string{"Cannot open "} + argv[2]);
+            }
+        }
+
+        auto& output{argc > 2 ? static_cast<std::ostream&>(file) : std::cout};
+
+        BusTrace::decode(input, output);
+        if (!output.flush())
+        {
+            throw std::runtime_error("Cannot write the decoded trace");
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
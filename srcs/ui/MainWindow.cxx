@@ -171,6 +171,11 @@ void MainWindow::onEmulationFatalError(const QString& message)
     _updateEmulationStatus(Status::Stopped);
 }
 
+void MainWindow::onSaveError(const QString& message)
+{
+    statusBar()->showMessage(message);
+}
+
 void MainWindow::_updateDisplay(const Graphics::Framebuffer& framebuffer) const
 {
     QImage img{std::tuple_size_v<Graphics::Framebuffer::value_type>, std::tuple_size_v<Graphics::Framebuffer>,
@@ -226,6 +231,7 @@ void MainWindow::_startEmulation(const QString& romPath)
     connect(emulator, &Emulator::frameReady, this, &MainWindow::onFrameReady);
     connect(emulator, &Emulator::emulationFatalError, this, &MainWindow::onEmulationFatalError);
     connect(emulator, &Emulator::breakpointHit, this, &MainWindow::onBreakpointHit);
+    connect(emulator, &Emulator::saveError, this, &MainWindow::onSaveError);
 
     connect(this, &MainWindow::requestNextFrame, emulator, &Emulator::runFrame);
 